@@ -0,0 +1,34 @@
+// User-equilibrium assignment on grid cities: iterations and wall time to
+// reach relative gaps 1e-2 / 1e-3 / 1e-4, per-iteration cost, and scaling
+// from one thread to the whole ThreadPool.
+#include "../src/graph.h"
+#include "../src/traffic_assignment.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+int main(int argc, char** argv){
+    int zones = argc>1? std::atoi(argv[1]) : 150;
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("%-14s %7s %6s %8s %8s %8s %10s %10s %8s\n", "graph", "threads", "od", "it@1e-2", "it@1e-3", "it@1e-4", "ms_per_it", "total_ms", "gap");
+    for(int side: {50, 100}){
+        RoadList r = makeCity(side, 5); Graph g; buildGraph(g, r);
+        // Zones are random nodes; each sends trips to 12 others, more on bigger
+        // grids so every size is congested alike.
+        std::mt19937 rng(8); std::uniform_int_distribution<int> pick(0, r.n-1); std::uniform_real_distribution<double> trips(20, 120);
+        std::vector<NodeId> zone(zones); for(auto &z: zone) z = (NodeId)pick(rng);
+        std::vector<OdDemand> demand;
+        for(int i=0;i<zones;i++) for(int k=0;k<12;k++){ NodeId b = zone[(i*7+k*13+1)%zones]; if(b!=zone[i]) demand.push_back({zone[i], b, trips(rng)*side/50}); }
+        AssignmentOptions opt; opt.capacity = 1200; opt.targetGap = 1e-4; opt.maxIterations = 300;
+        std::string label = "city "+std::to_string(side)+"x"+std::to_string(side);
+        for(unsigned t: {1u, hw}){
+            TrafficAssignment ta(g, t);
+            double t0=nowUs(); AssignmentResult res = ta.solve(demand, opt); double ms=(nowUs()-t0)/1000;
+            auto reach=[&](double gap){ for(std::size_t i=0;i<res.gaps.size();i++) if(res.gaps[i]<=gap) return (int)i+1; return -1; };
+            std::printf("%-14s %7u %6zu %8d %8d %8d %10.2f %10.1f %8.1e\n", label.c_str(), t, demand.size(), reach(1e-2), reach(1e-3), reach(1e-4), ms/(res.iterations+1), ms, res.relativeGap);
+            if(t==hw) break;
+        }
+    }
+    return 0;
+}
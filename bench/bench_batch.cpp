@@ -0,0 +1,30 @@
+// Batch routing throughput against thread count: (src, dst) pairs and a
+// many-to-many matrix on a synthetic city, checked against a serial run.
+#include "../src/batch_router.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+int main(int argc, char** argv){
+    int queries = argc>1? std::atoi(argv[1]) : 2000;
+    Graph g; buildGraph(g, makeCity(300, 5));
+    std::mt19937 rng(21); std::uniform_int_distribution<int> pick(0, (int)g.nodeCount()-1);
+    std::vector<std::pair<NodeId,NodeId>> pairs(queries); for(auto &p: pairs) p={(NodeId)pick(rng),(NodeId)pick(rng)};
+    std::vector<NodeId> src(64), dst(64); for(auto &u: src) u=pick(rng); for(auto &u: dst) u=pick(rng);
+    std::vector<int> ref; for(auto &p: pairs) ref.push_back(dijkstraSearch(g, p.first, p.second, threadWorkspace()));
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("graph: city 300x300 (%zu nodes), %u hardware threads\n", g.nodeCount(), hw);
+    std::printf("%8s %14s %10s %14s %10s\n", "threads", "pairs_per_s", "speedup", "matrix_ms", "speedup");
+    double basePairs=0, baseMatrix=0;
+    for(unsigned t=1; t<=std::max(hw, 4u); t*=2){
+        BatchRouter br(g, t);
+        double t0=nowUs(); auto res=br.route(pairs, SearchMode::Dijkstra, false); double pairUs=nowUs()-t0;
+        for(std::size_t i=0;i<pairs.size();i++) if(res[i].distance!=ref[i]){ std::printf("MISMATCH\n"); return 1; }
+        t0=nowUs(); auto m=br.matrix(src, dst); double matUs=nowUs()-t0;
+        if(m.at(0,0)!=dijkstraSearch(g, src[0], dst[0], threadWorkspace())){ std::printf("MISMATCH\n"); return 1; }
+        if(t==1){ basePairs=pairUs; baseMatrix=matUs; }
+        std::printf("%8u %14.0f %9.2fx %14.2f %9.2fx\n", t, queries/(pairUs/1e6), basePairs/pairUs, matUs/1000, baseMatrix/matUs);
+    }
+    return 0;
+}
@@ -0,0 +1,32 @@
+// Contraction hierarchy: preprocessing time, shortcut count and query latency
+// against plain dijkstra() on synthetic cities.
+#include "../src/contraction_hierarchy.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char** argv){
+    int queries = argc>1? std::atoi(argv[1]) : 1000;
+    std::printf("%-18s %9s %10s %10s %12s %12s %12s\n", "graph", "nodes", "build_ms", "shortcuts", "ch_settled", "ch_us", "dijkstra_us");
+    // Random long shortcuts ("city") are far harder to contract than the
+    // geometric grid, so they stay smaller.
+    for(int side: {30, 60, 200}){
+        for(int kind=0; kind<(side<=60 ? 2 : 1); kind++){
+            Graph g; buildGraph(g, kind? makeCity(side, 4) : makeGeoGrid(side, 4));
+            ChBuildStats st; double t0=nowUs(); ContractionHierarchy ch = ContractionHierarchy::build(g, &st); double buildMs=(nowUs()-t0)/1000;
+            ChQuery q(ch); std::mt19937 rng(17); std::uniform_int_distribution<int> pick(0, (int)g.nodeCount()-1);
+            std::vector<std::pair<NodeId,NodeId>> pairs(queries); for(auto &p: pairs) p={(NodeId)pick(rng),(NodeId)pick(rng)};
+            long long check=0; double settled=0; t0=nowUs();
+            for(auto &p: pairs){ check+=q.route(p.first,p.second).distance; settled+=q.lastSettled(); }
+            double chUs=(nowUs()-t0)/queries;
+            int dq=std::min(queries, 200); t0=nowUs();
+            for(int i=0;i<dq;i++) check-=dijkstra(g,pairs[i].first,pairs[i].second).distance;
+            double djUs=(nowUs()-t0)/dq;
+            for(int i=dq;i<queries;i++) check-=dijkstraSearch(g,pairs[i].first,pairs[i].second,threadWorkspace());
+            std::string label=std::string(kind? "city ":"geo-grid ")+std::to_string(side)+"x"+std::to_string(side);
+            std::printf("%-18s %9zu %10.1f %10zu %12.1f %12.2f %12.2f\n", label.c_str(), g.nodeCount(), buildMs, st.shortcuts, settled/queries, chUs, djUs);
+            if(check!=0){ std::printf("MISMATCH\n"); return 1; }
+        }
+    }
+    return 0;
+}
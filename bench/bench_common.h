@@ -0,0 +1,107 @@
+#pragma once
+#include "../src/graph.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Shared helpers for the single-file benchmarks in bench/.
+
+struct RoadList { int n; std::vector<std::tuple<int,int,int>> e; std::vector<double> lat, lng; };
+
+// Grid-like city with a few random shortcuts; always connected.
+inline RoadList makeCity(int side, unsigned seed){
+    RoadList r; r.n=side*side; std::mt19937 rng(seed); std::uniform_int_distribution<int> w(1,15);
+    for(int y=0;y<side;y++) for(int x=0;x<side;x++){ int u=y*side+x;
+        if(x+1<side) r.e.emplace_back(u,u+1,w(rng)); if(y+1<side) r.e.emplace_back(u,u+side,w(rng)); }
+    std::uniform_int_distribution<int> any(0,r.n-1);
+    for(int i=0;i<r.n/4;i++){ int a=any(rng), b=any(rng); if(a!=b) r.e.emplace_back(a,b,w(rng)+10); }
+    return r;
+}
+
+// Grid with ~100 m blocks around Delhi; weights are travel minutes at a
+// random 10-30 min/km, so coordinates are meaningful for A*.
+inline RoadList makeGeoGrid(int side, unsigned seed){
+    RoadList r; r.n=side*side; std::mt19937 rng(seed); std::uniform_real_distribution<double> slow(1.0, 3.0);
+    for(int y=0;y<side;y++) for(int x=0;x<side;x++){ r.lat.push_back(28.50+y*0.0009); r.lng.push_back(77.10+x*0.001); }
+    auto road=[&](int a,int b){ double km=haversineKm(r.lat[a],r.lng[a],r.lat[b],r.lng[b]); r.e.emplace_back(a,b,std::max(1,(int)std::lround(km*10*slow(rng)))); };
+    for(int y=0;y<side;y++) for(int x=0;x<side;x++){ int u=y*side+x; if(x+1<side) road(u,u+1); if(y+1<side) road(u,u+side); }
+    return r;
+}
+
+// Nodes are named by their index so results can be compared across graphs.
+inline void buildGraph(Graph& g, const RoadList& r){
+    g.clear(); for(int i=0;i<r.n;i++) g.addNode(std::to_string(i));
+    for(auto &t: r.e) g.addEdge((NodeId)std::get<0>(t), (NodeId)std::get<1>(t), std::get<2>(t));
+    for(std::size_t i=0;i<r.lat.size();i++) g.setPlace((NodeId)i, "", r.lat[i], r.lng[i]);
+    g.freeze();
+}
+
+inline double nowUs(){ using namespace std::chrono; return duration<double,std::micro>(steady_clock::now().time_since_epoch()).count(); }
+
+// p in [0, 100], nearest rank; sorts v.
+inline double percentile(std::vector<double>& v, double p){
+    if(v.empty()) return 0; std::sort(v.begin(), v.end());
+    std::size_t i=(std::size_t)std::max(0.0, std::ceil(p/100*v.size())-1); return v[std::min(i, v.size()-1)];
+}
+
+// Peak resident set of this process so far, in KB (link psapi on Windows).
+inline long long peakRssKb(){
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS c; return GetProcessMemoryInfo(GetCurrentProcess(), &c, sizeof(c)) ? (long long)(c.PeakWorkingSetSize/1024) : 0;
+#else
+    struct rusage u; return getrusage(RUSAGE_SELF, &u)==0 ? (long long)u.ru_maxrss : 0;
+#endif
+}
+
+// Last-level cache misses of this thread, from Linux perf events. ok() is
+// false where the kernel, VM or platform does not expose the counter.
+class CacheMisses {
+public:
+    CacheMisses(){
+#if defined(__linux__)
+        perf_event_attr a{}; a.type=PERF_TYPE_HARDWARE; a.size=sizeof(a); a.config=PERF_COUNT_HW_CACHE_MISSES;
+        a.disabled=1; a.exclude_kernel=1; a.exclude_hv=1;
+        fd=(int)syscall(__NR_perf_event_open, &a, 0, -1, -1, 0);
+#endif
+    }
+    ~CacheMisses(){
+#if defined(__linux__)
+        if(fd>=0) close(fd);
+#endif
+    }
+    CacheMisses(const CacheMisses&) = delete;
+    CacheMisses& operator=(const CacheMisses&) = delete;
+    bool ok() const { return fd>=0; }
+    void start(){
+#if defined(__linux__)
+        if(fd>=0){ ioctl(fd, PERF_EVENT_IOC_RESET, 0); ioctl(fd, PERF_EVENT_IOC_ENABLE, 0); }
+#endif
+    }
+    long long stop(){
+        long long n=-1;
+#if defined(__linux__)
+        if(fd>=0){ ioctl(fd, PERF_EVENT_IOC_DISABLE, 0); if(read(fd, &n, sizeof(n))!=(ssize_t)sizeof(n)) n=-1; }
+#endif
+        return n;
+    }
+private:
+    int fd=-1;
+};
@@ -0,0 +1,40 @@
+// Whole-network congestion steps: the old per-edge loop (mt19937 plus
+// edgeWeight/setWeight per road, with and without its per-road text output)
+// vs CongestionKernel on a flat weight array, single-threaded, on a
+// ThreadPool, and as TrafficSimulator::applyAll including the Graph write.
+#include "../src/graph.h"
+#include "../src/congestion_kernel.h"
+#include "../src/traffic_simulator.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+int main(int argc, char** argv){
+    int steps = argc>1? std::atoi(argv[1]) : 20;
+    RoadList r = makeCity(700, 3); Graph g; buildGraph(g, r);
+    double roads = (double)g.edgeCount();
+    std::printf("%-26s %10s %16s %8s %14s\n", "variant", "roads", "roads_per_s", "speedup", "checksum");
+    // checksum: what each variant produced (weight sum, text size, roads changed), so none is optimised away.
+    auto report=[&](const char* name, double us, int reps, double baseline, long long check){ double rate=roads*reps/(us/1e6); std::printf("%-26s %10.0f %16.0f %8.1f %14lld\n", name, roads, rate, baseline>0 ? rate/baseline : 1.0, check); return rate; };
+    auto weightSum=[](const std::vector<int>& v){ long long s=0; for(int x: v) s+=x; return s; };
+
+    std::mt19937 gen(1); std::uniform_int_distribution<> dist(-3, 5);
+    double t0=nowUs();
+    for(int s=0;s<2;s++) for(EdgeId e=0;e<g.edgeCount();++e){ int w=g.edgeWeight(e); g.setWeight(e, std::max(1, w+dist(gen))); }
+    double us=nowUs()-t0; double legacy=report("per-edge loop", us, 2, 0, weightSum(g.edgeWeights()));
+    std::ostringstream sink; t0=nowUs();
+    for(EdgeId e=0;e<g.edgeCount();++e){ int w=g.edgeWeight(e), nw=std::max(1, w+dist(gen)); g.setWeight(e, nw); sink<<"  Edge "<<g.name(g.edgeSource(e))<<"-"<<g.name(g.edgeTarget(e))<<": "<<w<<" -> "<<nw<<" min\n"; }
+    us=nowUs()-t0; report("per-edge loop + output", us, 1, legacy, (long long)sink.str().size());
+
+    CongestionKernel k(7); std::vector<int> w=g.edgeWeights();
+    t0=nowUs(); for(int s=0;s<steps;s++) k.apply(w.data(), w.size(), s);
+    us=nowUs()-t0; report("kernel, 1 thread", us, steps, legacy, weightSum(w));
+    ThreadPool pool; t0=nowUs(); for(int s=0;s<steps;s++) k.apply(w, s, pool);
+    us=nowUs()-t0; std::string label="kernel, "+std::to_string(pool.size())+" threads";
+    report(label.c_str(), us, steps, legacy, weightSum(w));
+    TrafficSimulator sim(""); sim.seed(7); std::size_t changed=0;
+    t0=nowUs(); for(int s=0;s<steps/4+1;s++) changed+=sim.applyAll(g, -3, 5, false);
+    report("applyAll (with Graph)", nowUs()-t0, steps/4+1, legacy, (long long)changed);
+    return 0;
+}
@@ -0,0 +1,60 @@
+// Query-path cost of dijkstra(): the previous per-call allocation version
+// (fresh dist/parent vectors, std::priority_queue with stale entries,
+// std::function callback) against the workspace + indexed 4-ary heap version.
+// Reports microseconds and heap allocations per query.
+#include "../src/dijkstra.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <queue>
+
+static std::size_t g_allocs = 0;
+void* operator new(std::size_t n){ g_allocs++; if(void* p = std::malloc(n)) return p; throw std::bad_alloc(); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static PathResult allocatingDijkstra(const Graph& g, NodeId src, NodeId dst, std::function<void(NodeId,int)> onVisit=nullptr){
+    using P = std::pair<int,NodeId>; const int INF=std::numeric_limits<int>::max();
+    std::priority_queue<P, std::vector<P>, std::greater<P>> pq;
+    std::vector<int> dist(g.nodeCount(), INF); std::vector<NodeId> parent(g.nodeCount(), kInvalidNode);
+    dist[src]=0; pq.push(P(0,src));
+    while(!pq.empty()){
+        P top=pq.top(); pq.pop(); int d=top.first; NodeId u=top.second;
+        if(d!=dist[u]) continue; if(onVisit) onVisit(u,d); if(u==dst) break;
+        for(const auto &e: g.neighbors(u)) if(dist[e.v] > d+e.w){ dist[e.v]=d+e.w; parent[e.v]=u; pq.push(P(dist[e.v],e.v)); }
+    }
+    PathResult r; r.distance=dist[dst]; if(r.distance==INF) return r;
+    for(NodeId c=dst; c!=kInvalidNode; c=parent[c]) r.path.push_back(c);
+    std::reverse(r.path.begin(), r.path.end()); return r;
+}
+
+int main(int argc, char** argv){
+    int queries = argc>1? std::atoi(argv[1]) : 1000;
+    std::printf("%-12s %10s %14s %14s\n", "variant", "nodes", "query_us", "allocs/query");
+    for(int side: {30, 100, 300}){
+        Graph g; buildGraph(g, makeCity(side, 3));
+        std::mt19937 rng(11); std::uniform_int_distribution<int> pick(0, (int)g.nodeCount()-1);
+        std::vector<std::pair<NodeId,NodeId>> pairs(queries); for(auto &p: pairs) p={(NodeId)pick(rng),(NodeId)pick(rng)};
+        dijkstra(g, pairs[0].first, pairs[0].second); // size the thread workspace once
+
+        long long check=0; std::size_t a0=g_allocs; double t0=nowUs();
+        for(auto &p: pairs) check += allocatingDijkstra(g, p.first, p.second).distance;
+        double oldUs=(nowUs()-t0)/queries, oldAllocs=(double)(g_allocs-a0)/queries;
+
+        a0=g_allocs; t0=nowUs();
+        for(auto &p: pairs) check -= dijkstraSearch(g, p.first, p.second, threadWorkspace());
+        double newUs=(nowUs()-t0)/queries, newAllocs=(double)(g_allocs-a0)/queries;
+
+        a0=g_allocs; t0=nowUs();
+        for(auto &p: pairs) dijkstra(g, p.first, p.second);
+        double pathUs=(nowUs()-t0)/queries, pathAllocs=(double)(g_allocs-a0)/queries;
+
+        std::printf("%-12s %10zu %14.2f %14.2f\n", "allocating", g.nodeCount(), oldUs, oldAllocs);
+        std::printf("%-12s %10zu %14.2f %14.2f\n", "workspace", g.nodeCount(), newUs, newAllocs);
+        std::printf("%-12s %10zu %14.2f %14.2f\n", "ws+path", g.nodeCount(), pathUs, pathAllocs);
+        if(check!=0){ std::printf("MISMATCH\n"); return 1; }
+    }
+    return 0;
+}
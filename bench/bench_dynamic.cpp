@@ -0,0 +1,30 @@
+// Shortest-path tree repair after simulator-sized batches of weight changes,
+// against rebuilding the tree from scratch.
+#include "../src/dynamic_sssp.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char** argv){
+    int rounds = argc>1? std::atoi(argv[1]) : 200;
+    std::printf("%-18s %9s %7s %12s %12s %12s %12s\n", "graph", "nodes", "batch", "repair_nodes", "repair_us", "rebuild_us", "speedup");
+    for(int side: {100, 300, 1000}){
+        for(int batch: {4, 64}){
+            Graph g; buildGraph(g, makeCity(side, 3)); auto edges=g.edgesUniqueUndirected();
+            std::mt19937 rng(11); std::uniform_int_distribution<int> idx(0,(int)edges.size()-1), del(-3,6);
+            ShortestPathTree tree(g), ref(g); tree.build(0);
+            double repairUs=0, rebuildUs=0, touched=0; int r=std::max(5, rounds*100/side);
+            for(int i=0;i<r;i++){
+                std::vector<TrafficChange> changes;
+                for(int k=0;k<batch;k++){ auto e=edges[idx(rng)]; int d=del(rng); if(d==0) d=1; changes.push_back({std::get<0>(e), std::get<1>(e), d, 0}); }
+                g.applyUpdates(changes);
+                double t0=nowUs(); tree.repair(changes); repairUs+=nowUs()-t0; touched+=tree.lastTouched();
+                t0=nowUs(); ref.build(0); rebuildUs+=nowUs()-t0;
+                if(tree.distances()!=ref.distances()){ std::printf("MISMATCH\n"); return 1; }
+            }
+            std::string label="city "+std::to_string(side)+"x"+std::to_string(side);
+            std::printf("%-18s %9zu %7d %12.0f %12.2f %12.2f %11.1fx\n", label.c_str(), g.nodeCount(), batch, touched/r, repairUs/r, rebuildUs/r, rebuildUs/repairUs);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,46 @@
+// Web UI export cost after a simulator step: the previous ofstream-based
+// graph.json writer, the buffered JsonWriter version, and a 4-road delta.
+#include "../src/json_exporter.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+static void streamGraphJson(const Graph& g, const std::string& path){
+    std::ofstream out(path); if(!out.is_open()) return;
+    out << "{\n  \"nodes\": {\n"; bool first=true;
+    for(NodeId id=0; id<g.nodeCount(); ++id){
+        if(!first) out << ",\n";
+        double lat=g.hasCoords(id)? g.lat(id):0.0, lng=g.hasCoords(id)? g.lng(id):0.0;
+        out << "    \"" << g.name(id) << "\": {\"name\": \"" << g.label(id) << "\", \"coords\": [" << lat << ", " << lng << "]}"; first=false;
+    }
+    out << "\n  },\n  \"edges\": [\n"; first=true;
+    for(auto &e: g.edgesUniqueUndirected()){
+        if(!first) out << ",\n"; NodeId a,b; int w; std::tie(a,b,w)=e;
+        out << "    {\"from\": \"" << g.name(a) << "\", \"to\": \"" << g.name(b) << "\", \"weight\": " << w << "}"; first=false;
+    }
+    out << "\n  ]\n}\n";
+}
+
+static long fileBytes(const char* path){ std::ifstream in(path, std::ios::binary|std::ios::ate); return (long)in.tellg(); }
+
+int main(int argc, char** argv){
+    int reps = argc>1? std::atoi(argv[1]) : 5;
+    std::printf("%-18s %9s %14s %14s %14s %12s\n", "graph", "nodes", "ostream_ms", "writer_ms", "delta_us", "delta_bytes");
+    for(int side: {100, 300}){
+        Graph g; buildGraph(g, makeGeoGrid(side, 8)); auto edges=g.edgesUniqueUndirected();
+        double t0=nowUs(); for(int i=0;i<reps;i++) streamGraphJson(g, "bench_graph.json"); double oldMs=(nowUs()-t0)/1000/reps;
+        t0=nowUs(); for(int i=0;i<reps;i++) writeGraphJson(g, "bench_graph.json"); double newMs=(nowUs()-t0)/1000/reps;
+        std::mt19937 rng(2); std::uniform_int_distribution<int> idx(0,(int)edges.size()-1);
+        double deltaUs=0; int rounds=200;
+        for(int r=0;r<rounds;r++){
+            std::uint64_t base=g.weightVersion(); std::vector<TrafficChange> ch;
+            for(int k=0;k<4;k++){ auto e=edges[idx(rng)]; NodeId a=std::get<0>(e), b=std::get<1>(e); g.addWeightDelta(a,b,2); ch.push_back({a,b,2,g.getWeight(a,b)}); }
+            t0=nowUs(); writeGraphDeltaJson(g, ch, base, "bench_delta.json"); deltaUs+=nowUs()-t0;
+        }
+        std::string label="geo-grid "+std::to_string(side)+"x"+std::to_string(side);
+        std::printf("%-18s %9zu %14.2f %14.2f %14.1f %12ld\n", label.c_str(), g.nodeCount(), oldMs, newMs, deltaUs/rounds, fileBytes("bench_delta.json"));
+    }
+    std::remove("bench_graph.json"); std::remove("bench_delta.json");
+    return 0;
+}
@@ -0,0 +1,73 @@
+// CSR graph vs. the old char-keyed unordered_map adjacency.
+// Reports query latency (random point-to-point dijkstra) and heap bytes per
+// undirected edge. The legacy graph tops out at ~94 printable node names, so the
+// head-to-head runs on an 81-node map; the CSR graph is then scaled up alone.
+#include "../src/graph.h"
+#include "../src/dijkstra.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <queue>
+#include <set>
+
+static std::size_t g_allocated = 0;
+void* operator new(std::size_t n){ g_allocated += n; if(void* p = std::malloc(n)) return p; throw std::bad_alloc(); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// The pre-CSR graph and search, kept verbatim in spirit for comparison.
+struct LegacyEdge { char v; int w; };
+struct LegacyGraph {
+    std::unordered_map<char, std::vector<LegacyEdge>> adj;
+    void addEdge(char u, char v, int w){ adj[u].push_back({v,w}); adj[v].push_back({u,w}); }
+    std::vector<char> nodes() const { std::set<char> s; for(auto &kv: adj) s.insert(kv.first); return std::vector<char>(s.begin(), s.end()); }
+    const std::vector<LegacyEdge>& neighbors(char u) const { static const std::vector<LegacyEdge> empty; auto it=adj.find(u); return it==adj.end()? empty : it->second; }
+};
+static int legacyDijkstra(const LegacyGraph& g, char src, char dst){
+    using P = std::pair<int,char>;
+    std::priority_queue<P, std::vector<P>, std::greater<P>> pq;
+    std::unordered_map<char,int> dist; std::unordered_map<char,char> parent;
+    for(char u: g.nodes()) dist[u]=std::numeric_limits<int>::max();
+    dist[src]=0; pq.push(P(0,src));
+    while(!pq.empty()){
+        P top=pq.top(); pq.pop(); int d=top.first; char u=top.second;
+        if(d!=dist[u]) continue; if(u==dst) break;
+        for(const auto &e: g.neighbors(u)) if(dist[e.v] > d + e.w){ dist[e.v]=d+e.w; parent[e.v]=u; pq.push(P(dist[e.v],e.v)); }
+    }
+    return dist[dst];
+}
+
+int main(int argc, char** argv){
+    int queries = argc>1? std::atoi(argv[1]) : 2000;
+    std::printf("%-10s %10s %10s %14s %14s\n", "graph", "nodes", "edges", "query_us", "bytes/edge");
+
+    // Head-to-head on a 9x9 city (81 nodes fit in printable chars).
+    RoadList small = makeCity(9, 1);
+    std::size_t before = g_allocated; LegacyGraph lg;
+    for(auto &t: small.e) lg.addEdge((char)('!'+std::get<0>(t)), (char)('!'+std::get<1>(t)), std::get<2>(t));
+    double legacyBytes = (double)(g_allocated-before)/small.e.size();
+
+    Graph g; buildGraph(g, small); double csrBytes = (double)g.memoryBytes()/small.e.size();
+
+    std::mt19937 rng(7); std::uniform_int_distribution<int> pick(0, small.n-1);
+    std::vector<std::pair<int,int>> pairs(queries); for(auto &p: pairs) p={pick(rng),pick(rng)};
+    long long check=0; double t0=nowUs();
+    for(auto &p: pairs) check += legacyDijkstra(lg, (char)('!'+p.first), (char)('!'+p.second));
+    double legacyUs=(nowUs()-t0)/queries;
+    t0=nowUs(); for(auto &p: pairs) check -= dijkstra(g, (NodeId)p.first, (NodeId)p.second).distance;
+    double csrUs=(nowUs()-t0)/queries;
+    std::printf("%-10s %10d %10zu %14.2f %14.1f\n", "legacy", small.n, small.e.size(), legacyUs, legacyBytes);
+    std::printf("%-10s %10d %10zu %14.2f %14.1f\n", "csr", small.n, small.e.size(), csrUs, csrBytes);
+    if(check!=0){ std::printf("MISMATCH between legacy and CSR distances\n"); return 1; }
+
+    // CSR alone at metro scale.
+    for(int side: {100, 300, 1000}){
+        RoadList big = makeCity(side, 2); Graph G; buildGraph(G, big);
+        std::uniform_int_distribution<int> bp(0, big.n-1); int q = std::max(10, queries/(side/10));
+        t0=nowUs(); for(int i=0;i<q;i++) dijkstra(G, (NodeId)bp(rng), (NodeId)bp(rng));
+        std::printf("%-10s %10d %10zu %14.2f %14.1f\n", "csr", big.n, big.e.size(), (nowUs()-t0)/q, (double)G.memoryBytes()/big.e.size());
+    }
+    return 0;
+}
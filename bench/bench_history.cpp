@@ -0,0 +1,52 @@
+// Route history: text appendHistory/readHistory vs the binary store.
+// Reports append rate, bytes per trip, and the cost of "average A->B in a
+// window" and "top routes in a window" (text: read and scan every line;
+// binary: indexed lookups after one open).
+#include "../src/file_manager.h"
+#include "../src/route_history.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+
+int main(int argc, char** argv){
+    int trips = argc>1? std::atoi(argv[1]) : 1000000;
+    int textTrips = std::min(trips, 100000);   // one open/close per line; more takes minutes
+    std::mt19937 rng(3); std::uniform_int_distribution<int> node(0, 99), mins(3, 90);
+    std::vector<std::string> routes; for(int i=0;i<2000;i++){ int a=node(rng), b=node(rng); routes.push_back(std::to_string(a)+"->"+std::to_string(i%7)+"->"+std::to_string(b)); }
+    std::uniform_int_distribution<int> pick(0, (int)routes.size()-1);
+    std::remove("bench_hist.txt"); std::remove("bench_hist.bin"); std::remove("bench_hist.bin.routes");
+
+    double t0=nowUs(); for(int i=0;i<textTrips;i++) appendHistory("bench_hist.txt", routes[pick(rng)], mins(rng));
+    double textAppend=textTrips/((nowUs()-t0)/1e6);
+    std::int64_t start=1700000000, clock=start;
+    t0=nowUs();
+    { RouteHistoryWriter w("bench_hist.bin"); for(int i=0;i<trips;i++){ clock+=1+i%3; w.append(routes[pick(rng)], mins(rng), clock); } }
+    double binAppend=trips/((nowUs()-t0)/1e6);
+    std::FILE* f=std::fopen("bench_hist.txt","rb"); std::fseek(f,0,SEEK_END); double textBytes=(double)std::ftell(f)/textTrips; std::fclose(f);
+    f=std::fopen("bench_hist.bin","rb"); std::fseek(f,0,SEEK_END); double binBytes=(double)std::ftell(f)/trips; std::fclose(f);
+    std::printf("%-8s %10s %14s %12s\n", "store", "trips", "appends_per_s", "bytes_per_trip");
+    std::printf("%-8s %10d %14.0f %12.1f\n", "text", textTrips, textAppend, textBytes);
+    std::printf("%-8s %10d %14.0f %12.1f\n", "binary", trips, binAppend, binBytes);
+
+    // Text queries: load every line, then filter the route field.
+    std::string o, d; routeEnds(routes[0], o, d);
+    t0=nowUs();
+    auto lines=readHistory("bench_hist.txt"); long long textSum=0, n=0; std::map<std::string,int> count;
+    for(auto &l: lines){ std::size_t a=l.find(" | "), b=l.rfind(" | "); std::string r=l.substr(a+3, b-a-3), x, y; routeEnds(r, x, y); count[r]++; if(x==o && y==d){ textSum+=std::atoi(l.c_str()+b+3); n++; } }
+    double textQuery=nowUs()-t0;
+    t0=nowUs(); RouteHistory h; h.open("bench_hist.bin"); double openUs=nowUs()-t0;
+    int queries=1000; std::uniform_int_distribution<std::int64_t> when(start, clock); long long odSum=0, topSum=0;
+    t0=nowUs(); for(int q=0;q<queries;q++){ std::int64_t a=when(rng); routeEnds(routes[pick(rng)], o, d); odSum+=h.odStats(o, d, a, a+24*3600).minutes; }
+    double odUs=(nowUs()-t0)/queries;
+    t0=nowUs(); for(int q=0;q<queries/10;q++){ std::int64_t a=when(rng); topSum+=h.topRoutes(10, a, a+24*3600).size(); }
+    double topUs=(nowUs()-t0)/(queries/10);
+    // checksum: what each query returned (minutes summed, matches, routes listed)
+    std::printf("\n%-8s %-26s %12s %12s\n", "store", "query", "us", "checksum");
+    std::printf("%-8s %-26s %12.0f %12lld\n", "text", ("load+scan "+std::to_string(textTrips)+" lines").c_str(), textQuery, textSum+n+(long long)count.size());
+    std::printf("%-8s %-26s %12.0f %12zu\n", "binary", ("open+index "+std::to_string(trips)+" trips").c_str(), openUs, h.size());
+    std::printf("%-8s %-26s %12.1f %12lld\n", "binary", "od window, avg", odUs, odSum);
+    std::printf("%-8s %-26s %12.0f %12lld\n", "binary", "top-10 window, avg", topUs, topSum);
+    std::remove("bench_hist.txt"); std::remove("bench_hist.bin"); std::remove("bench_hist.bin.routes");
+    return 0;
+}
@@ -0,0 +1,58 @@
+// Local load generator for the routing service: keep-alive clients hammer
+// GET /route on a generated city while one client posts /traffic every 10 ms.
+// Reports requests/sec and latency percentiles per client count.
+#include "../src/graph.h"
+#include "../src/http_server.h"
+#include "../src/route_service.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+int main(int argc, char** argv){
+    int perClient = argc>1? std::atoi(argv[1]) : 400;
+    int side = argc>2? std::atoi(argv[2]) : 60;
+    RoadList r = makeCity(side, 14); Graph g; buildGraph(g, r);
+    unsigned workers = std::max(2u, std::thread::hardware_concurrency());
+    RouteService service(g, workers, "web", "");
+    HttpServer server([&service](const HttpRequest& req, HttpResponse& res, unsigned w){ service.handle(req, res, w); }, workers);
+    if(!server.listen(0)){ std::printf("listen failed\n"); return 1; }
+    std::thread loop([&]{ server.run(); });
+    std::printf("city %dx%d, %u workers, %d requests per client\n", side, side, workers, perClient);
+    std::printf("%8s %12s %10s %10s %10s %10s %10s\n", "clients", "req_per_s", "p50_us", "p90_us", "p99_us", "max_us", "updates");
+    for(int clients: {1, 4, 16}){
+        std::atomic<bool> stop(false); std::atomic<long long> updates(0), failed(0);
+        std::thread feed([&]{
+            net::SocketFd s = net::connectTo("127.0.0.1", server.port()); std::string pend, body; int st;
+            while(!stop.load()){
+                if(!net::sendAll(s, "POST /traffic?changes=16 HTTP/1.1\r\nContent-Length: 0\r\n\r\n") || !net::readResponse(s, pend, st, body)) break;
+                updates++; std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            net::closeSocket(s);
+        });
+        std::vector<std::vector<double>> lat(clients);
+        std::vector<std::thread> ts; double t0=nowUs();
+        for(int c=0;c<clients;c++) ts.emplace_back([&, c]{
+            net::SocketFd s = net::connectTo("127.0.0.1", server.port()); std::string pend, body; int st;
+            std::mt19937 rng(c); std::uniform_int_distribution<int> node(0, r.n-1);
+            for(int i=0;i<perClient;i++){
+                std::string req = "GET /route?from="+std::to_string(node(rng))+"&to="+std::to_string(node(rng))+" HTTP/1.1\r\nHost: bench\r\n\r\n";
+                double q0=nowUs();
+                if(!net::sendAll(s, req) || !net::readResponse(s, pend, st, body) || st!=200){ failed++; break; }
+                lat[c].push_back(nowUs()-q0);
+            }
+            net::closeSocket(s);
+        });
+        for(auto &t: ts) t.join();
+        double secs=(nowUs()-t0)/1e6; stop=true; feed.join();
+        std::vector<double> all; for(auto &v: lat) all.insert(all.end(), v.begin(), v.end());
+        if(all.empty()){ std::printf("no successful requests\n"); break; }
+        std::sort(all.begin(), all.end());
+        auto pct=[&](double p){ return all[std::min(all.size()-1, (std::size_t)(p*all.size()))]; };
+        std::printf("%8d %12.0f %10.0f %10.0f %10.0f %10.0f %10lld%s\n", clients, all.size()/secs, pct(0.5), pct(0.9), pct(0.99), all.back(), updates.load(), failed.load()? "  (failures)" : "");
+    }
+    server.stop(); loop.join();
+    return 0;
+}
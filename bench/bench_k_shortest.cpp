@@ -0,0 +1,32 @@
+// K shortest loopless paths vs one point-to-point Dijkstra on grid cities:
+// microseconds per query, nodes settled and spur searches that needed a search.
+#include "../src/graph.h"
+#include "../src/dijkstra.h"
+#include "../src/k_shortest.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char** argv){
+    int queries = argc>1? std::atoi(argv[1]) : 200;
+    std::printf("%-18s %4s %10s %8s %12s %10s %12s\n", "graph", "k", "us_per_q", "vs_dij", "settled_avg", "spur_avg", "checksum");
+    for(int side: {100, 300}){
+        RoadList r = makeCity(side, 12); Graph g; buildGraph(g, r);
+        std::mt19937 rng(10); std::uniform_int_distribution<int> pick(0, r.n-1);
+        std::vector<std::pair<NodeId,NodeId>> qs(queries); for(auto &q: qs) q={(NodeId)pick(rng),(NodeId)pick(rng)};
+        std::string label="city "+std::to_string(side)+"x"+std::to_string(side);
+        long long sink=0;   // summed distances: every result is used
+        double t0=nowUs(); for(auto &q: qs) sink+=dijkstra(g, q.first, q.second).distance;
+        double base=(nowUs()-t0)/queries;
+        std::printf("%-18s %4s %10.1f %8.2f %12s %10s %12lld\n", label.c_str(), "dij", base, 1.0, "-", "-", sink);
+        KShortestPaths ksp(g);
+        for(int k: {1, 3, 5}){
+            double settled=0, spurs=0; sink=0;
+            t0=nowUs();
+            for(auto &q: qs){ auto rs=ksp.route(q.first, q.second, k); for(auto &x: rs) sink+=x.distance; settled+=ksp.lastSettled(); spurs+=ksp.lastSpurSearches(); }
+            double us=(nowUs()-t0)/queries;
+            std::printf("%-18s %4d %10.1f %8.2f %12.0f %10.1f %12lld\n", label.c_str(), k, us, us/base, settled/queries, spurs/queries, sink);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+// Routing latency while traffic updates stream in: readers on LiveGraph pins
+// vs one Graph behind a mutex that the writer updates in place. Reports
+// query p50/p99 and how many update batches landed meanwhile.
+#include "../src/graph.h"
+#include "../src/dijkstra.h"
+#include "../src/live_graph.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+
+struct Run { double p50, p99; long long batches; };
+
+template<class Query, class Update>
+static Run measure(int readers, int queries, bool stream, Query query, Update update){
+    std::atomic<bool> stop(false); std::atomic<long long> batches(0);
+    // One batch per millisecond, roughly a busy city feed.
+    std::thread writer([&]{ while(stream && !stop.load()){ update(); batches++; std::this_thread::sleep_for(std::chrono::milliseconds(1)); } });
+    std::vector<std::vector<double>> lat(readers);
+    std::vector<std::thread> ts;
+    for(int r=0;r<readers;r++) ts.emplace_back([&, r]{ std::mt19937 rng(r); for(int q=0;q<queries;q++){ double t0=nowUs(); query(r, rng); lat[r].push_back(nowUs()-t0); } });
+    for(auto &t: ts) t.join();
+    stop=true; writer.join();
+    std::vector<double> all; for(auto &v: lat) all.insert(all.end(), v.begin(), v.end()); std::sort(all.begin(), all.end());
+    return {all[all.size()/2], all[all.size()*99/100], batches.load()};
+}
+
+int main(int argc, char** argv){
+    int queries = argc>1? std::atoi(argv[1]) : 300; const int readers=3, batch=64;
+    std::printf("%-16s %-14s %10s %10s %10s\n", "graph", "model", "p50_us", "p99_us", "batches");
+    for(int side: {100, 200}){
+        RoadList r = makeCity(side, 13); Graph g; buildGraph(g, r);
+        std::uniform_int_distribution<int> node(0, r.n-1);
+        std::mt19937 wrng(1); std::uniform_int_distribution<EdgeId> road(0, (EdgeId)g.edgeCount()-1); std::uniform_int_distribution<int> del(-3,6);
+        auto makeBatch=[&]{ std::vector<TrafficChange> c; for(int k=0;k<batch;k++) c.push_back({0,0,del(wrng),0,road(wrng)}); return c; };
+
+        Graph locked=g; std::mutex m;
+        auto lockedQuery=[&](int, std::mt19937& rng){ std::lock_guard<std::mutex> lk(m); dijkstra(locked, (NodeId)node(rng), (NodeId)node(rng)); };
+        auto lockedUpdate=[&]{ auto c=makeBatch(); std::lock_guard<std::mutex> lk(m); locked.applyUpdates(c); };
+
+        LiveGraph live(g); std::vector<std::unique_ptr<LiveGraph::Reader>> rd; for(int i=0;i<readers;i++) rd.emplace_back(new LiveGraph::Reader(live));
+        auto liveQuery=[&](int i, std::mt19937& rng){ LiveGraph::Pin p(*rd[i]); dijkstra(*p, (NodeId)node(rng), (NodeId)node(rng)); };
+        auto liveUpdate=[&]{ auto c=makeBatch(); live.publish(c); };
+
+        std::string label="city "+std::to_string(side)+"x"+std::to_string(side);
+        struct Row { const char* name; Run run; } rows[] = {
+            {"mutex idle",   measure(readers, queries, false, lockedQuery, lockedUpdate)},
+            {"mutex stream", measure(readers, queries, true,  lockedQuery, lockedUpdate)},
+            {"live idle",    measure(readers, queries, false, liveQuery, liveUpdate)},
+            {"live stream",  measure(readers, queries, true,  liveQuery, liveUpdate)},
+        };
+        for(auto &row: rows) std::printf("%-16s %-14s %10.0f %10.0f %10lld\n", label.c_str(), row.name, row.run.p50, row.run.p99, row.run.batches);
+        std::printf("%-16s %-14s %10zu\n", label.c_str(), "generations", live.generationCount());
+    }
+    return 0;
+}
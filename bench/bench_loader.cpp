@@ -0,0 +1,40 @@
+// Map load time: the previous getline + stringstream parser, the mapped text
+// parser, and the binary snapshot (with and without touching every arc).
+// Usage: bench_loader [side]  (writes bench_map.txt / bench_map.bin in cwd)
+#include "../src/graph.h"
+#include "../src/dijkstra.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+
+static bool streamLoad(Graph& g, const std::string& path){
+    std::ifstream in(path); if(!in.is_open()) return false; g.clear();
+    std::string line; while(std::getline(in,line)){
+        if(line.empty() || line[0]=='#') continue; std::stringstream ss(line);
+        std::string u,v; int w; if(ss>>u>>v>>w){ g.addEdge(u,v,w);} }
+    g.freeze(); return true;
+}
+
+static long long touchAll(const Graph& g){ long long s=0; for(NodeId u=0; u<g.nodeCount(); ++u) for(auto e: g.neighbors(u)) s+=e.w; return s; }
+
+int main(int argc, char** argv){
+    int side = argc>1? std::atoi(argv[1]) : 1000;
+    RoadList r = makeCity(side, 6);
+    { std::ofstream out("bench_map.txt"); out<<"# synthetic city "<<side<<"x"<<side<<"\n";
+      for(auto &t: r.e) out<<std::get<0>(t)<<' '<<std::get<1>(t)<<' '<<std::get<2>(t)<<'\n'; }
+    Graph ref; double t0=nowUs(); if(!streamLoad(ref, "bench_map.txt")){ std::printf("write failed\n"); return 1; }
+    double streamMs=(nowUs()-t0)/1000; long long sum=touchAll(ref);
+    Graph txt; t0=nowUs(); txt.loadFromFile("bench_map.txt"); double textMs=(nowUs()-t0)/1000;
+    txt.saveSnapshot("bench_map.bin");
+    Graph snap; t0=nowUs(); snap.loadFromFile("bench_map.bin"); double snapMs=(nowUs()-t0)/1000;
+    t0=nowUs(); long long snapSum=touchAll(snap); double touchMs=(nowUs()-t0)/1000;
+    if(touchAll(txt)!=sum || snapSum!=sum || dijkstra(snap,0,(NodeId)(snap.nodeCount()-1)).distance!=dijkstra(ref,0,(NodeId)(ref.nodeCount()-1)).distance){ std::printf("MISMATCH\n"); return 1; }
+    std::printf("city %dx%d: %zu nodes, %zu roads\n", side, side, ref.nodeCount(), ref.edgeCount());
+    std::printf("%-28s %10s\n", "loader", "ms");
+    std::printf("%-28s %10.1f\n", "text (getline+stringstream)", streamMs);
+    std::printf("%-28s %10.1f\n", "text (mapped parser)", textMs);
+    std::printf("%-28s %10.1f\n", "snapshot (map)", snapMs);
+    std::printf("%-28s %10.1f\n", "snapshot (map + scan arcs)", snapMs+touchMs);
+    std::remove("bench_map.txt"); std::remove("bench_map.bin");
+    return 0;
+}
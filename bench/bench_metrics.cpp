@@ -0,0 +1,35 @@
+// Instrumentation overhead: the same seeded query mix with metrics compiled
+// in and out. Build twice (the Makefile makes bench_metrics and
+// bench_metrics_off with -DTRAFFIC_METRICS=0) and compare the rates.
+// Usage: bench_metrics [queries]
+#include "../src/router.h"
+#include "../src/traffic_simulator.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char** argv){
+    int queries = argc>1? std::atoi(argv[1]) : 3000;
+    std::printf("metrics %s\n", kMetricsEnabled ? "on" : "off (TRAFFIC_METRICS=0)");
+    std::printf("%-16s %-14s %12s %12s\n", "graph", "search", "queries_per_s", "us_per_query");
+    for(int side: {30, 300}){
+        Graph g; buildGraph(g, makeGeoGrid(side, 3));
+        std::mt19937 rng(17); std::uniform_int_distribution<int> pick(0, (int)g.nodeCount()-1);
+        std::vector<std::pair<NodeId,NodeId>> pairs(queries); for(auto &p: pairs) p={(NodeId)pick(rng),(NodeId)pick(rng)};
+        int n = side>100 ? queries/20 : queries*10;
+        for(SearchMode mode: {SearchMode::Dijkstra, SearchMode::AStar}){
+            Router r(g); long long check=0; double best=1e300;
+            for(int rep=0; rep<3; rep++){   // best of three runs
+                double t0=nowUs(); for(int i=0;i<n;i++){ auto &p=pairs[i%queries]; check+=r.route(p.first, p.second, mode).distance; }
+                best=std::min(best, nowUs()-t0);
+            }
+            char name[32]; std::snprintf(name, sizeof(name), "grid %dx%d", side, side);
+            std::printf("%-16s %-14s %12.0f %12.2f\n", name, searchModeName(mode), n/(best/1e6), best/n);
+            if(check==0) std::printf("(no routes)\n");
+        }
+    }
+    Graph g; buildGraph(g, makeCity(300, 4)); TrafficSimulator sim(""); sim.seed(5);
+    double t0=nowUs(); int steps=200; for(int i=0;i<steps;i++) sim.apply(g, 16, -3, 6, false);
+    std::printf("%-16s %-14s %12.0f %12.2f\n", "city 300x300", "simulate(16)", steps/((nowUs()-t0)/1e6), (nowUs()-t0)/steps);
+    return 0;
+}
@@ -0,0 +1,54 @@
+// Node ordering: one generated city renumbered by every NodeOrdering, then
+// the same queries (matched by junction name) on each. Reports the reorder
+// cost, mean ID distance along a road, the 64-cell partition's cut, query
+// time and last-level cache misses per query (where perf events are
+// available), and batch routing with and without cell grouping.
+// Usage: bench_node_order [grid|geometric|scalefree] [nodes] [queries]
+#include "../src/node_order.h"
+#include "../src/router.h"
+#include "../src/batch_router.h"
+#include "../src/city_generator.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+int main(int argc, char** argv){
+    CitySpec spec; spec.kind=CityKind::Geometric; spec.nodes=300000; int queries=100;
+    if(argc>1 && !parseCityKind(argv[1], spec.kind)){ std::printf("unknown kind %s\n", argv[1]); return 1; }
+    if(argc>2) spec.nodes=(std::size_t)std::atof(argv[2]);
+    if(argc>3) queries=std::max(1, std::atoi(argv[3]));
+    Graph base; buildCity(base, spec);
+    std::mt19937 rng(21); std::vector<std::pair<std::string,std::string>> named(queries);
+    for(auto &q: named) q={base.name(rng()%base.nodeCount()), base.name(rng()%base.nodeCount())};
+    CacheMisses misses;
+    std::printf("%s city, %zu junctions, %zu roads, %d queries%s\n", cityKindName(spec.kind), base.nodeCount(), base.edgeCount(), queries,
+                misses.ok() ? "" : " (no perf counters here: misses shown as -)");
+    std::printf("%-10s %10s %10s %8s %12s %12s %12s %12s %12s\n", "order", "reorder_ms", "road_span", "cut_%", "dijkstra_us", "misses/q", "astar_us", "batch_ms", "grouped_ms");
+
+    long long ref=-1;
+    for(NodeOrdering how: {NodeOrdering::Input, NodeOrdering::Bfs, NodeOrdering::Hilbert, NodeOrdering::Bisection}){
+        Graph g=base; double t0=nowUs(); Partition cells=reorderNodes(g, how, 64); double reorderMs=(nowUs()-t0)/1000;
+        double span=0; for(EdgeId e=0;e<g.edgeCount();e++) span+=std::abs((double)g.edgeSource(e)-(double)g.edgeTarget(e));
+        std::vector<std::pair<NodeId,NodeId>> pairs; for(auto &q: named) pairs.push_back({g.id(q.first), g.id(q.second)});
+
+        Router r(g); double us[2]; long long miss=0, check=0;
+        for(SearchMode mode: {SearchMode::Dijkstra, SearchMode::AStar}){
+            r.route(pairs[0].first, pairs[0].second, mode);   // warm the workspace
+            if(mode==SearchMode::Dijkstra) misses.start();
+            double q0=nowUs(); for(auto &p: pairs) check+=r.route(p.first, p.second, mode).distance; us[mode==SearchMode::AStar]=(nowUs()-q0)/queries;
+            if(mode==SearchMode::Dijkstra) miss=misses.stop();
+        }
+        if(ref<0) ref=check; else if(check!=ref){ std::printf("MISMATCH %s\n", nodeOrderingName(how)); return 1; }
+
+        BatchRouter br(g); double batch[2];
+        for(int grouped=0; grouped<2; grouped++){
+            br.usePartition(grouped ? &cells : nullptr);
+            double q0=nowUs(); br.route(pairs, SearchMode::AStar, false); batch[grouped]=(nowUs()-q0)/1000;
+        }
+        char missCol[32]; if(miss>=0) std::snprintf(missCol, sizeof(missCol), "%.0f", (double)miss/queries); else std::snprintf(missCol, sizeof(missCol), "-");
+        std::printf("%-10s %10.1f %10.1f %8.2f %12.1f %12s %12.1f %12.1f %12.1f\n", nodeOrderingName(how), reorderMs, span/g.edgeCount(),
+                    100.0*cells.cutRoads()/g.edgeCount(), us[0], missCol, us[1], batch[0], batch[1]);
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+// Route cache: a repeated origin-destination mix (a few hundred popular
+// pairs, picked with a skew) routed with and without the cache while traffic
+// steps change a few roads between rounds. Reports the hit rate, how many
+// cached routes each step carries over versus drops, and the speedup.
+// Usage: bench_route_cache [side] [changes_per_step]
+#include "../src/router.h"
+#include "../src/route_cache.h"
+#include "../src/traffic_simulator.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+int main(int argc, char** argv){
+    int side = argc>1 ? std::atoi(argv[1]) : 100, changes = argc>2 ? std::atoi(argv[2]) : 8;
+    const int popular = 400, rounds = 30, perRound = 2000;
+    Graph g; buildGraph(g, makeGeoGrid(side, 3));
+    std::mt19937 rng(5); std::uniform_int_distribution<int> pick(0, (int)g.nodeCount()-1);
+    std::vector<std::pair<NodeId,NodeId>> pairs(popular); for(auto &p: pairs) p={(NodeId)pick(rng),(NodeId)pick(rng)};
+    std::vector<int> mix(perRound);   // pair i with weight ~ 1/(i+1)
+    { std::vector<double> w(popular); for(int i=0;i<popular;i++) w[i]=1.0/(i+1);
+      std::discrete_distribution<int> zipf(w.begin(), w.end()); for(auto &m: mix) m=zipf(rng); }
+
+    std::printf("grid %dx%d, %d popular pairs, %d queries x %d rounds, %d roads changed per step\n", side, side, popular, perRound, rounds, changes);
+    std::printf("%-10s %12s %12s %10s %10s %10s\n", "run", "ms", "queries_per_s", "hit_rate", "carried", "dropped");
+    double plain=0;
+    for(bool cached: {false, true}){
+        Graph work=g; Router r(work); RouteCache cache(work); TrafficSimulator sim(""); sim.seed(11);
+        long long check=0; double total=0;
+        for(int round=0; round<rounds; round++){
+            double t0=nowUs();
+            for(int m: mix){
+                const auto &p=pairs[m]; PathResult res;
+                if(!cached) res=r.route(p.first, p.second, SearchMode::AStar);
+                else if(!cache.lookup(p.first, p.second, work.weightVersion(), res)){ res=r.route(p.first, p.second, SearchMode::AStar); cache.insert(p.first, p.second, work.weightVersion(), res); }
+                check+=res.distance;
+            }
+            std::uint64_t base=work.weightVersion(); auto step=sim.apply(work, changes, -3, 4, false);
+            if(cached) cache.invalidate(work, step, base);
+            total+=nowUs()-t0;
+        }
+        RouteCache::Stats s=cache.stats();
+        std::printf("%-10s %12.1f %12.0f %10.3f %10llu %10llu  (check %lld)\n", cached ? "cached" : "router", total/1000, rounds*perRound/(total/1e6),
+                    s.hitRate(), (unsigned long long)s.carried, (unsigned long long)s.dropped, check);
+        if(!cached) plain=total; else std::printf("speedup %.1fx\n", plain/total);
+    }
+    return 0;
+}
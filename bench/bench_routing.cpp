@@ -0,0 +1,39 @@
+// Settled nodes and latency per search mode (Dijkstra, bidirectional, A*) on
+// the bundled maps and on synthetic geo grids. Run from the repo root so the
+// data/ paths resolve.
+#include "../src/router.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+
+static int runModes(const char* label, const Graph& g, int queries){
+    Router r(g); std::mt19937 rng(42); std::uniform_int_distribution<int> pick(0, (int)g.nodeCount()-1);
+    std::vector<std::pair<NodeId,NodeId>> pairs(queries); for(auto &p: pairs) p={(NodeId)pick(rng),(NodeId)pick(rng)};
+    std::vector<int> ref;
+    for(SearchMode m: {SearchMode::Dijkstra, SearchMode::Bidirectional, SearchMode::AStar}){
+        double settled=0, t0=nowUs(); std::size_t i=0;
+        for(auto &p: pairs){
+            int d=r.route(p.first, p.second, m).distance; settled+=r.lastSettled();
+            if(m==SearchMode::Dijkstra) ref.push_back(d);
+            else if(ref[i]!=d){ std::printf("MISMATCH %s\n", searchModeName(m)); return 1; }
+            i++;
+        }
+        std::printf("%-22s %9zu %-14s %12.1f %12.2f\n", label, g.nodeCount(), searchModeName(m), settled/queries, (nowUs()-t0)/queries);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv){
+    int queries = argc>1? std::atoi(argv[1]) : 1000;
+    std::printf("%-22s %9s %-14s %12s %12s\n", "graph", "nodes", "mode", "settled", "query_us");
+    for(const char* path: {"data/city_map.txt", "data/city_map_large.txt"}){
+        Graph g; if(!g.loadFromFile(path)){ std::printf("skip %s (not found)\n", path); continue; }
+        g.loadPlaces("data/places.txt");
+        if(runModes(path, g, queries)) return 1;
+    }
+    for(int side: {100, 300, 1000}){
+        Graph g; buildGraph(g, makeGeoGrid(side, 9)); std::string label="geo-grid "+std::to_string(side)+"x"+std::to_string(side);
+        if(runModes(label.c_str(), g, std::max(20, queries*10/side))) return 1;
+    }
+    return 0;
+}
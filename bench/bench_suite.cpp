@@ -0,0 +1,132 @@
+// Benchmark suite: one generated city through every hot path (generate, text
+// load, snapshot save/load, point queries per search mode, batch routing,
+// weight updates, JSON export), reporting per-phase latency percentiles,
+// throughput and peak RSS, and writing the same numbers as JSON for scripts
+// that compare runs. Everything is seeded, so reruns measure the same work.
+// Usage: bench_suite [--kind grid|geometric|scalefree] [--nodes N] [--seed S]
+//                    [--queries Q] [--threads T] [--json out.json] [--keep]
+// (writes bench_suite_map.txt / .bin / _places.txt / _graph.json in cwd;
+// --keep doesn't delete them afterwards)
+#include "../src/city_generator.h"
+#include "../src/router.h"
+#include "../src/batch_router.h"
+#include "../src/traffic_simulator.h"
+#include "../src/json_exporter.h"
+#include "../src/json_writer.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+struct Phase { std::string name; long long ops = 0; double ms = 0; std::vector<double> us; long long rssKb = 0; std::string note; };
+
+static std::vector<Phase> phases;
+
+// A phase of `ops` operations; `us` (optional) holds one latency per operation.
+static Phase& record(const std::string& name, long long ops, double ms, std::vector<double> us = {}, const std::string& note = ""){
+    Phase p; p.name=name; p.ops=ops; p.ms=ms; p.us=std::move(us); p.rssKb=peakRssKb(); p.note=note;
+    phases.push_back(std::move(p)); Phase& r=phases.back();
+    std::vector<double> lat=r.us;
+    std::printf("%-20s %10lld %11.1f %13.0f", r.name.c_str(), r.ops, r.ms, r.ms>0 ? r.ops/(r.ms/1000) : 0.0);
+    if(lat.empty()) std::printf(" %9s %9s %9s %9s", "-", "-", "-", "-");
+    else std::printf(" %9.1f %9.1f %9.1f %9.1f", percentile(lat,50), percentile(lat,90), percentile(lat,99), percentile(lat,100));
+    std::printf(" %11.1f  %s\n", r.rssKb/1024.0, r.note.c_str());
+    return r;
+}
+
+static bool writeJson(const std::string& path, const CitySpec& spec, const Graph& g, unsigned threads){
+    JsonWriter out(path); if(!out.ok()) return false;
+    out.raw("{\"graph\":{\"kind\":").str(cityKindName(spec.kind)).raw(",\"nodes\":").integer((long long)g.nodeCount())
+       .raw(",\"roads\":").integer((long long)g.edgeCount()).raw(",\"seed\":").integer((long long)spec.seed)
+       .raw("},\"threads\":").integer(threads).raw(",\"phases\":[");
+    for(std::size_t i=0;i<phases.size();i++){
+        Phase& p=phases[i]; if(i) out.raw(',');
+        out.raw("{\"phase\":").str(p.name).raw(",\"ops\":").integer(p.ops).raw(",\"ms\":").number(p.ms, 3)
+           .raw(",\"ops_per_s\":").number(p.ms>0 ? p.ops/(p.ms/1000) : 0.0, 1);
+        if(!p.us.empty()){
+            out.raw(",\"p50_us\":").number(percentile(p.us,50), 2).raw(",\"p90_us\":").number(percentile(p.us,90), 2)
+               .raw(",\"p99_us\":").number(percentile(p.us,99), 2).raw(",\"max_us\":").number(percentile(p.us,100), 2);
+        }
+        out.raw(",\"peak_rss_kb\":").integer(p.rssKb);
+        if(!p.note.empty()) out.raw(",\"note\":").str(p.note);
+        out.raw('}');
+    }
+    out.raw("]}\n");
+    return out.commit();
+}
+
+static long long fileBytes(const std::string& path){ std::ifstream in(path, std::ios::binary|std::ios::ate); return in ? (long long)in.tellg() : 0; }
+
+int main(int argc, char** argv){
+    CitySpec spec; spec.nodes=100000; int queries=1000; unsigned threads=std::max(1u, std::thread::hardware_concurrency());
+    std::string json="bench_suite.json"; bool keep=false;
+    for(int i=1;i<argc;i++){
+        std::string a=argv[i]; const char* v = i+1<argc ? argv[i+1] : "";
+        if(a=="--kind"){ if(!parseCityKind(v, spec.kind)){ std::printf("unknown kind %s\n", v); return 1; } i++; }
+        else if(a=="--nodes"){ spec.nodes=(std::size_t)std::atof(v); i++; }   // atof: 1e6 works
+        else if(a=="--seed"){ spec.seed=std::strtoull(v, nullptr, 10); i++; }
+        else if(a=="--queries"){ queries=std::max(1, std::atoi(v)); i++; }
+        else if(a=="--threads"){ threads=std::max(1, std::atoi(v)); i++; }
+        else if(a=="--json"){ json=v; i++; }
+        else if(a=="--keep") keep=true;
+        else { std::printf("unknown option %s\n", a.c_str()); return 1; }
+    }
+    const std::string map="bench_suite_map.txt", places="bench_suite_places.txt", snap="bench_suite_map.bin", graphOut="bench_suite_graph.json";
+    std::printf("%s city, %zu junctions, seed %llu, %d queries, %u threads\n", cityKindName(spec.kind), spec.nodes, (unsigned long long)spec.seed, queries, threads);
+    std::printf("%-20s %10s %11s %13s %9s %9s %9s %9s %11s\n", "phase", "ops", "ms", "ops_per_s", "p50_us", "p90_us", "p99_us", "max_us", "peak_rss_mb");
+
+    double t0=nowUs();
+    if(!writeCityMap(spec, map, places)){ std::printf("cannot write %s\n", map.c_str()); return 1; }
+    record("generate", 1, (nowUs()-t0)/1000, {}, std::to_string(fileBytes(map)>>20)+" MB map");
+
+    Graph g; t0=nowUs();
+    if(!g.loadFromFile(map) || !g.loadPlaces(places)){ std::printf("cannot load %s\n", map.c_str()); return 1; }
+    record("load_text", 1, (nowUs()-t0)/1000, {}, std::to_string(g.edgeCount())+" roads");
+    t0=nowUs(); if(!g.saveSnapshot(snap)){ std::printf("cannot write %s\n", snap.c_str()); return 1; }
+    record("snapshot_save", 1, (nowUs()-t0)/1000, {}, std::to_string(fileBytes(snap)>>20)+" MB");
+    Graph s; t0=nowUs(); if(!s.loadFromFile(snap)){ std::printf("cannot load %s\n", snap.c_str()); return 1; }
+    record("snapshot_load", 1, (nowUs()-t0)/1000);
+
+    // mt19937's raw output is fixed by the standard, so the pairs are too.
+    std::mt19937 rng((unsigned)spec.seed); auto pick=[&]{ return (NodeId)(rng() % g.nodeCount()); };
+    std::vector<std::pair<NodeId,NodeId>> pairs(queries); for(auto &p: pairs) p={pick(), pick()};
+    std::vector<int> ref(queries);
+    for(SearchMode mode: {SearchMode::Dijkstra, SearchMode::Bidirectional, SearchMode::AStar}){
+        Router r(g); std::vector<double> us; us.reserve(queries); r.route(pairs[0].first, pairs[0].second, mode);
+        double total=0;
+        for(int i=0;i<queries;i++){
+            double q0=nowUs(); PathResult res=r.route(pairs[i].first, pairs[i].second, mode); double dt=nowUs()-q0; us.push_back(dt); total+=dt;
+            if(mode==SearchMode::Dijkstra) ref[i]=res.distance;
+            else if(res.distance!=ref[i]){ std::printf("MISMATCH %s query %d\n", searchModeName(mode), i); return 1; }
+        }
+        record(std::string("query_")+searchModeName(mode), queries, total/1000, std::move(us));
+    }
+
+    { BatchRouter br(g, threads); std::vector<double> us; const std::size_t chunk=64; double total=0;
+      for(std::size_t b=0;b<pairs.size();b+=chunk){
+          std::vector<std::pair<NodeId,NodeId>> part(pairs.begin()+b, pairs.begin()+std::min(pairs.size(), b+chunk));
+          double q0=nowUs(); auto res=br.route(part, SearchMode::Dijkstra, false); double dt=nowUs()-q0; us.push_back(dt); total+=dt;
+          for(std::size_t i=0;i<res.size();i++) if(res[i].distance!=ref[b+i]){ std::printf("MISMATCH batch\n"); return 1; }
+      }
+      record("batch_dijkstra", queries, total/1000, std::move(us), "latency per 64-pair batch"); }
+
+    { std::vector<double> us; const int batches=2000, batch=16; double total=0; std::vector<TrafficChange> changes(batch);
+      for(int b=0;b<batches;b++){
+          for(auto &c: changes){ c=TrafficChange{0, 0, (int)(rng()%9)-3, 0, (EdgeId)(rng()%g.edgeCount())}; }
+          double q0=nowUs(); g.applyUpdates(changes); double dt=nowUs()-q0; us.push_back(dt); total+=dt;
+      }
+      record("update_roads", (long long)batches*batch, total/1000, std::move(us), "latency per 16-road batch"); }
+    { TrafficSimulator sim("bench_suite_traffic.txt"); sim.seed(spec.seed); std::vector<double> us; const int steps=20; double total=0;
+      for(int i=0;i<steps;i++){ double q0=nowUs(); sim.applyAll(g, -3, 5, false); double dt=nowUs()-q0; us.push_back(dt); total+=dt; }
+      record("update_network", steps, total/1000, std::move(us), "whole-network steps"); }
+
+    t0=nowUs(); if(!writeGraphJson(g, graphOut)){ std::printf("cannot write %s\n", graphOut.c_str()); return 1; }
+    record("export_graph_json", 1, (nowUs()-t0)/1000, {}, std::to_string(fileBytes(graphOut)>>20)+" MB");
+
+    if(!writeJson(json, spec, g, threads)){ std::printf("cannot write %s\n", json.c_str()); return 1; }
+    std::printf("results: %s\n", json.c_str());
+    if(!keep) for(auto &f: {map, places, snap, graphOut}) std::remove(f.c_str());
+    return 0;
+}
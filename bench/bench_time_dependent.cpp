@@ -0,0 +1,32 @@
+// Time-dependent Dijkstra vs static Dijkstra on grid cities where every road
+// carries a daily profile: queries per second and profile memory.
+#include "../src/graph.h"
+#include "../src/dijkstra.h"
+#include "../src/time_dependent.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char** argv){
+    int queries = argc>1? std::atoi(argv[1]) : 200;
+    std::printf("%-18s %9s %12s %14s %14s %12s %12s\n", "graph", "roads", "profile_kb", "static_q_per_s", "td_q_per_s", "static_sum", "td_sum");
+    for(int side: {100, 300}){
+        RoadList r = makeCity(side, 12); Graph g; buildGraph(g, r); g.freeze();
+        std::mt19937 rng(10); std::uniform_int_distribution<int> pick(0, r.n-1), day(0, kMinutesPerDay-1), rush(100, 250);
+        TravelTimeProfiles prof(g.edgeCount()); int h[TravelTimeProfiles::kSlots];
+        for(EdgeId e=0;e<g.edgeCount();e++){
+            int w=g.edgeWeight(e), peak=rush(rng);
+            for(int i=0;i<TravelTimeProfiles::kSlots;i++) h[i] = (i>=7&&i<=9)||(i>=17&&i<=19) ? w*peak/100 : w;
+            prof.setProfile(e, h);
+        }
+        std::vector<std::pair<NodeId,NodeId>> qs(queries); for(auto &q: qs) q={(NodeId)pick(rng),(NodeId)pick(rng)};
+        long long staticSum=0, tdSum=0;   // summed trip minutes: every result is used
+        double t0=nowUs(); for(auto &q: qs) staticSum+=dijkstra(g, q.first, q.second).distance;
+        double st=queries/((nowUs()-t0)/1e6);
+        t0=nowUs(); for(auto &q: qs) tdSum+=timeDependentDijkstra(g, prof, q.first, q.second, day(rng)).distance;
+        double td=queries/((nowUs()-t0)/1e6);
+        std::string label="city "+std::to_string(side)+"x"+std::to_string(side);
+        std::printf("%-18s %9zu %12zu %14.0f %14.0f %12lld %12lld\n", label.c_str(), g.edgeCount(), prof.profiledCount()*TravelTimeProfiles::kSlots*2/1024, st, td, staticSum, tdSum);
+    }
+    return 0;
+}
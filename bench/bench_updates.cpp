@@ -0,0 +1,44 @@
+// Weight updates per second on a city with high-degree junctions: the old
+// simulator flow (edgesUniqueUndirected() per step + u-v scans), u-v updates,
+// and EdgeId batches through Graph::applyUpdates.
+#include "../src/graph.h"
+#include "../src/traffic_simulator.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char** argv){
+    int steps = argc>1? std::atoi(argv[1]) : 200;
+    std::printf("%-22s %9s %9s %16s %16s %16s\n", "graph", "roads", "hub_deg", "old_flow_per_s", "pair_per_s", "edgeid_per_s");
+    for(int side: {100, 300}){
+        // Every 50th node is a junction wired to 200 random others.
+        RoadList r = makeCity(side, 12); std::mt19937 rng(4); std::uniform_int_distribution<int> any(0, r.n-1);
+        for(int hub=0; hub<r.n; hub+=50) for(int k=0;k<200;k++) r.e.emplace_back(hub, any(rng), 5);
+        Graph g; buildGraph(g, r); std::size_t hubDeg=g.degree(0);
+        const int batch=4; long long updates=(long long)steps*batch;
+        std::uniform_int_distribution<EdgeId> pick(0, (EdgeId)g.edgeCount()-1);
+        std::vector<EdgeId> roads(updates); for(auto &e: roads) e=pick(rng);
+
+        double t0=nowUs();
+        for(int s=0;s<steps;s++){
+            auto edges=g.edgesUniqueUndirected();   // what apply() used to rebuild every call
+            for(int k=0;k<batch;k++){ auto &t=edges[roads[s*batch+k] % edges.size()]; g.addWeightDelta(std::get<0>(t), std::get<1>(t), 1); }
+        }
+        double oldRate=updates/((nowUs()-t0)/1e6);
+
+        t0=nowUs(); long long reps=std::max<long long>(updates, 200000);
+        for(long long i=0;i<reps;i++){ EdgeId e=roads[i%updates]; g.addWeightDelta(g.edgeSource(e), g.edgeTarget(e), 1); }
+        double pairRate=reps/((nowUs()-t0)/1e6);
+
+        std::vector<TrafficChange> changes; changes.reserve(1024);
+        t0=nowUs(); long long done=0;
+        while(done<reps*10){
+            changes.clear(); for(int k=0;k<1024;k++,done++){ EdgeId e=roads[done%updates]; changes.push_back({0,0,(done&1)? 1:-1,0,e}); }
+            g.applyUpdates(changes);
+        }
+        double idRate=done/((nowUs()-t0)/1e6);
+        std::string label="city+hubs "+std::to_string(side)+"x"+std::to_string(side);
+        std::printf("%-22s %9zu %9zu %16.0f %16.0f %16.0f\n", label.c_str(), g.edgeCount(), hubDeg, oldRate, pairRate, idRate);
+    }
+    return 0;
+}
@@ -0,0 +1,2 @@
+#include "batch_router.h"
+// Header-only; this TU keeps the one-file-per-module build layout.
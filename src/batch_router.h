@@ -0,0 +1,106 @@
+#pragma once
+#include "graph.h"
+#include "dijkstra.h"
+#include "router.h"
+#include "search_workspace.h"
+#include "thread_pool.h"
+#include "node_order.h"
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+// Batch routing ~110 LOC
+// - route(pairs): independent (src, dst) queries spread over a ThreadPool,
+//   one Router (and so one set of workspaces) per worker
+// - matrix(sources, targets): one one-to-many Dijkstra per source that stops
+//   once every target is settled; rows are sources
+// - With a Partition (node_order.h) route() runs pairs grouped by the cells
+//   of their ends, so a worker's consecutive searches stay in one region of
+//   a locality-ordered graph
+// - The Graph is frozen up front and only read by the workers; do not change
+//   weights while a batch is running
+
+struct DistanceMatrix {
+    std::size_t rows = 0, cols = 0;
+    std::vector<int> d;       // row-major, SearchWorkspace::INF if unreachable
+    int at(std::size_t i, std::size_t j) const { return d[i*cols+j]; }
+};
+
+class BatchRouter {
+public:
+    // threads == 0: one per hardware thread.
+    explicit BatchRouter(const Graph& g, unsigned threads = 0): graph(g), pool(threads) {
+        routers.reserve(pool.size());
+        for(unsigned w=0; w<pool.size(); ++w) routers.emplace_back(g);
+    }
+
+    unsigned threads() const { return pool.size(); }
+
+    // Group route() pairs by the cells of p (which must outlive the router);
+    // results stay in input order. nullptr turns grouping off.
+    void usePartition(const Partition* p){ partition = p; }
+
+    // One result per pair, in input order. Paths are skipped unless withPaths.
+    std::vector<PathResult> route(const std::vector<std::pair<NodeId,NodeId>>& pairs,
+                                  SearchMode mode = SearchMode::Dijkstra, bool withPaths = true){
+        graph.freeze();
+        std::vector<PathResult> out(pairs.size());
+        std::vector<std::uint32_t> order = byCell(pairs);
+        pool.parallelFor(pairs.size(), 16, [&](std::size_t j, unsigned w){
+            std::size_t i = order.empty() ? j : order[j];
+            out[i] = routers[w].route(pairs[i].first, pairs[i].second, mode);
+            if(!withPaths) std::vector<NodeId>().swap(out[i].path);
+        });
+        return out;
+    }
+
+    // |sources| x |targets| shortest distances.
+    DistanceMatrix matrix(const std::vector<NodeId>& sources, const std::vector<NodeId>& targets){
+        graph.freeze();
+        DistanceMatrix m; m.rows = sources.size(); m.cols = targets.size();
+        m.d.assign(m.rows*m.cols, SearchWorkspace::INF);
+        // Targets are shared read-only; each search counts down distinct ones.
+        std::vector<char> isTarget(graph.nodeCount(), 0); int distinct = 0;
+        for(NodeId t: targets) if(graph.hasNode(t) && !isTarget[t]){ isTarget[t] = 1; distinct++; }
+        pool.parallelFor(sources.size(), 1, [&](std::size_t i, unsigned){
+            SearchWorkspace& ws = threadWorkspace();
+            oneToMany(sources[i], isTarget, distinct, ws);
+            int* row = m.d.data() + i*m.cols;
+            for(std::size_t j=0; j<targets.size(); ++j) if(graph.hasNode(targets[j])) row[j] = ws.distance(targets[j]);
+        });
+        return m;
+    }
+
+private:
+    const Graph& graph;
+    ThreadPool pool;
+    std::vector<Router> routers;
+    const Partition* partition = nullptr;
+
+    // Pair indices sorted by (source cell, target cell); empty without a
+    // partition for this graph.
+    std::vector<std::uint32_t> byCell(const std::vector<std::pair<NodeId,NodeId>>& pairs) const {
+        std::vector<std::uint32_t> order;
+        if(!partition || partition->nodeCount()!=graph.nodeCount() || partition->cells()<2) return order;
+        auto cell = [&](NodeId u){ return graph.hasNode(u) ? (std::uint64_t)partition->cellOf(u) : 0xFFFFFFFFull; };
+        std::vector<std::uint64_t> key(pairs.size()); order.resize(pairs.size());
+        for(std::uint32_t i=0; i<pairs.size(); ++i){ key[i] = cell(pairs[i].first) << 32 | cell(pairs[i].second); order[i] = i; }
+        std::stable_sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b){ return key[a]<key[b]; });
+        return order;
+    }
+
+    void oneToMany(NodeId src, const std::vector<char>& isTarget, int remaining, SearchWorkspace& ws) const {
+        ws.reset(graph.nodeCount());
+        if(!graph.hasNode(src) || remaining==0) return;
+        ws.label(src, 0, kInvalidNode); ws.heap.push(src, 0);
+        while(!ws.heap.empty()){
+            auto top = ws.heap.pop();
+            NodeId u = top.node; int d = top.key;
+            if(isTarget[u] && --remaining==0) return;
+            for(const auto &e: graph.neighbors(u)){
+                int nd = d + e.w;
+                if(nd < ws.distance(e.v)){ ws.label(e.v, nd, u); ws.heap.pushOrDecrease(e.v, nd); }
+            }
+        }
+    }
+};
@@ -0,0 +1,2 @@
+#include "city_generator.h"
+// Header-only; this TU keeps the one-file-per-module build layout.
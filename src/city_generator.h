@@ -0,0 +1,200 @@
+#pragma once
+#include "graph.h"
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+
+// Synthetic city generator ~190 LOC
+// - Seeded road networks from 10^3 to 10^7 junctions in three shapes: a
+//   street grid, a random geometric city (junctions scattered over a square,
+//   each joined to its nearest neighbours) and a scale-free one
+//   (preferential attachment, so a few hubs carry most roads)
+// - Roads stream out through a callback in a fixed order, so a 10^7-junction
+//   map is written without ever building the Graph
+// - Randomness is splitmix64 with its own range mapping and coordinates are a
+//   hash of (seed, junction): a (kind, nodes, seed) triple gives the same map
+//   on every compiler and standard library
+// - Every city is connected. Junction i is named "i" and placed around Delhi
+//   about 100 m from its neighbours; road minutes are length times a random
+//   10-30 min/km (2-6 km/h), so coordinates stay meaningful for A*
+
+enum class CityKind { Grid, Geometric, ScaleFree };
+
+inline const char* cityKindName(CityKind k){
+    return k==CityKind::Grid ? "grid" : k==CityKind::Geometric ? "geometric" : "scalefree";
+}
+inline bool parseCityKind(const std::string& s, CityKind& out){
+    if(s=="grid") out = CityKind::Grid;
+    else if(s=="geometric" || s=="geo") out = CityKind::Geometric;
+    else if(s=="scalefree" || s=="sf") out = CityKind::ScaleFree;
+    else return false;
+    return true;
+}
+
+struct CitySpec { CityKind kind = CityKind::Grid; std::size_t nodes = 1000; std::uint64_t seed = 1; };
+
+class CityGenerator {
+public:
+    enum : unsigned { kNearest = 3, kAttach = 2 };   // geometric: neighbours per junction; scale-free: roads per new junction
+
+    explicit CityGenerator(const CitySpec& s): spec(s) {
+        spec.nodes = std::max<std::size_t>(spec.nodes, kAttach+1);
+        side = (std::uint32_t)std::ceil(std::sqrt((double)spec.nodes));
+    }
+
+    std::size_t nodeCount() const { return spec.nodes; }
+
+    // Position of junction u: grid junctions sit on the grid, the others at
+    // a hashed point of the side x side square (100 m cells).
+    void coords(NodeId u, double& lat, double& lng) const {
+        double x, y; position(u, x, y);
+        lat = 28.50 + y*0.0009; lng = 77.10 + x*0.001;
+    }
+
+    // Calls road(u, v, minutes) once per road; returns the road count.
+    template<class F> std::size_t roads(F&& road) const {
+        switch(spec.kind){
+            case CityKind::Grid: return grid(road);
+            case CityKind::Geometric: return geometric(road);
+            default: return scaleFree(road);
+        }
+    }
+
+private:
+    // splitmix64 (Steele, Lea, Flood): tiny, fast and the same everywhere.
+    struct Rng {
+        std::uint64_t s;
+        std::uint64_t next(){ return mix(s += 0x9e3779b97f4a7c15ull); }
+        std::uint32_t below(std::uint32_t n){ return (std::uint32_t)(((next() >> 32) * n) >> 32); }
+    };
+    static std::uint64_t mix(std::uint64_t z){
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull; z = (z ^ (z >> 27)) * 0x94d049bb133111ebull; return z ^ (z >> 31);
+    }
+    static double unit(std::uint64_t h){ return (double)(h >> 11) * (1.0/9007199254740992.0); }
+
+    CitySpec spec; std::uint32_t side;
+
+    void position(NodeId u, double& x, double& y) const {
+        if(spec.kind==CityKind::Grid){ x = u % side; y = u / side; return; }
+        std::uint64_t h = mix(spec.seed ^ mix(0x636974790000ull + u));
+        x = unit(h) * side; y = unit(mix(h)) * side;
+    }
+    // Length times 10-30 min/km, the factor drawn from the road's ends, so
+    // either direction or emission order gives the same minutes.
+    int minutes(NodeId u, NodeId v) const {
+        if(u>v) std::swap(u, v);
+        double x1, y1, x2, y2; position(u, x1, y1); position(v, x2, y2);
+        double km = 0.1*std::sqrt((x1-x2)*(x1-x2) + (y1-y2)*(y1-y2));
+        double slow = 1.0 + 2.0*unit(mix(spec.seed + mix(((std::uint64_t)u << 32) | v)));
+        return std::max(1, (int)std::lround(km*10*slow));
+    }
+
+    template<class F> std::size_t grid(F& road) const {
+        std::size_t n = spec.nodes, count = 0;
+        for(std::size_t u=0; u<n; ++u){
+            if((u+1) % side && u+1<n){ road((NodeId)u, (NodeId)(u+1), minutes((NodeId)u, (NodeId)(u+1))); count++; }
+            if(u+side<n){ road((NodeId)u, (NodeId)(u+side), minutes((NodeId)u, (NodeId)(u+side))); count++; }
+        }
+        return count;
+    }
+
+    // Junctions bucketed into 1x1 cells (one expected per cell); each links
+    // to its kNearest nearest within the surrounding 5x5 cells. Components left
+    // over are joined along the cell order, which keeps the bridges short.
+    template<class F> std::size_t geometric(F& road) const {
+        std::size_t n = spec.nodes, cells = (std::size_t)side*side, count = 0;
+        std::vector<std::uint32_t> start(cells+1, 0), order(n);
+        auto cellOf = [&](NodeId u){ double x, y; position(u, x, y); return std::min<std::size_t>((std::size_t)y, side-1)*side + std::min<std::size_t>((std::size_t)x, side-1); };
+        for(NodeId u=0; u<n; ++u) start[cellOf(u)+1]++;
+        for(std::size_t c=0; c<cells; ++c) start[c+1] += start[c];
+        { std::vector<std::uint32_t> fill(start.begin(), start.end()-1); for(NodeId u=0; u<n; ++u) order[fill[cellOf(u)]++] = u; }
+
+        auto closer = [](double d, NodeId v, double bd, NodeId bv){ return d<bd || (d==bd && v<bv); };
+        auto nearest = [&](NodeId u, NodeId* out){
+            double x, y; position(u, x, y); double best[kNearest]; unsigned k = 0;
+            long cx = (long)std::min<double>(x, side-1), cy = (long)std::min<double>(y, side-1);
+            for(long yy=std::max(0L, cy-2); yy<=std::min<long>(side-1, cy+2); ++yy)
+                for(long xx=std::max(0L, cx-2); xx<=std::min<long>(side-1, cx+2); ++xx){
+                    std::size_t c = (std::size_t)yy*side + xx;
+                    for(std::uint32_t i=start[c]; i<start[c+1]; ++i){
+                        NodeId v = order[i]; if(v==u) continue;
+                        double vx, vy; position(v, vx, vy); double d = (vx-x)*(vx-x) + (vy-y)*(vy-y);
+                        if(k==kNearest && !closer(d, v, best[k-1], out[k-1])) continue;
+                        unsigned j = k<kNearest ? k++ : kNearest-1;   // sorted insert into the top kNearest
+                        while(j>0 && closer(d, v, best[j-1], out[j-1])){ best[j] = best[j-1]; out[j] = out[j-1]; --j; }
+                        best[j] = d; out[j] = v;
+                    }
+                }
+            return k;
+        };
+        std::vector<std::uint32_t> root(n); for(NodeId u=0; u<n; ++u) root[u] = u;
+        auto find = [&](NodeId u){ while(root[u]!=u){ root[u] = root[root[u]]; u = root[u]; } return u; };
+        NodeId mine[kNearest], theirs[kNearest];
+        for(NodeId u=0; u<n; ++u){
+            unsigned k = nearest(u, mine);
+            for(unsigned i=0; i<k; ++i){
+                NodeId v = mine[i];
+                if(v<u){   // emitted from v's side already if u is one of v's nearest
+                    unsigned kv = nearest(v, theirs);
+                    if(std::find(theirs, theirs+kv, u)!=theirs+kv) continue;
+                }
+                road(u, v, minutes(u, v)); count++; root[find(u)] = find(v);
+            }
+        }
+        for(std::size_t i=1; i<n; ++i){
+            NodeId a = order[i-1], b = order[i];
+            if(find(a)!=find(b)){ road(a, b, minutes(a, b)); count++; root[find(a)] = find(b); }
+        }
+        return count;
+    }
+
+    // Barabasi-Albert: a kAttach+1 clique, then every junction links to
+    // kAttach distinct earlier ones picked in proportion to their degree.
+    template<class F> std::size_t scaleFree(F& road) const {
+        std::size_t n = spec.nodes, count = 0;
+        std::vector<NodeId> ends; ends.reserve(2*kAttach*n);   // each road's ends once: a uniform pick is degree-biased
+        Rng rng{spec.seed};
+        auto link = [&](NodeId u, NodeId v){ road(u, v, minutes(u, v)); ends.push_back(u); ends.push_back(v); count++; };
+        for(NodeId u=0; u<=kAttach; ++u) for(NodeId v=0; v<u; ++v) link(u, v);
+        NodeId picked[kAttach];
+        for(NodeId u=kAttach+1; u<n; ++u){
+            std::size_t before = ends.size();
+            for(unsigned k=0; k<kAttach; ++k){
+                NodeId v;
+                do v = ends[rng.below((std::uint32_t)before)]; while(std::find(picked, picked+k, v)!=picked+k);
+                picked[k] = v;
+            }
+            for(unsigned k=0; k<kAttach; ++k) link(u, picked[k]);
+        }
+        return count;
+    }
+};
+
+// "U V MINUTES" map text for Graph::loadFromFile and, if placesPath is set,
+// "U LAT LNG" lines for Graph::loadPlaces.
+inline bool writeCityMap(const CitySpec& spec, const std::string& mapPath, const std::string& placesPath = ""){
+    CityGenerator gen(spec);
+    std::FILE* f = std::fopen(mapPath.c_str(), "wb"); if(!f) return false;
+    std::fprintf(f, "# synthetic %s city: %zu junctions, seed %llu\n", cityKindName(spec.kind), gen.nodeCount(), (unsigned long long)spec.seed);
+    gen.roads([&](NodeId u, NodeId v, int w){ std::fprintf(f, "%u %u %d\n", u, v, w); });
+    bool good = std::fclose(f)==0;
+    if(good && !placesPath.empty()){
+        f = std::fopen(placesPath.c_str(), "wb"); if(!f) return false;
+        std::fprintf(f, "# Node places: ID LAT LNG\n");
+        for(NodeId u=0; u<gen.nodeCount(); ++u){ double la, lo; gen.coords(u, la, lo); std::fprintf(f, "%u %.6f %.6f\n", u, la, lo); }
+        good = std::fclose(f)==0;
+    }
+    return good;
+}
+
+// The same city straight into g, with coordinates.
+inline void buildCity(Graph& g, const CitySpec& spec){
+    CityGenerator gen(spec); g.clear();
+    for(std::size_t i=0; i<gen.nodeCount(); ++i) g.addNode(std::to_string(i));
+    gen.roads([&](NodeId u, NodeId v, int w){ g.addEdge(u, v, w); });
+    for(NodeId u=0; u<gen.nodeCount(); ++u){ double la, lo; gen.coords(u, la, lo); g.setPlace(u, "", la, lo); }
+    g.freeze();
+}
@@ -0,0 +1,2 @@
+#include "congestion_kernel.h"
+// Header-only; this TU keeps the one-file-per-module build layout.
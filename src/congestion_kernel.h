@@ -0,0 +1,69 @@
+#pragma once
+#include "thread_pool.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+// Bulk congestion kernel ~80 LOC
+// - One whole-network step over a flat int-per-road array (Graph::edgeWeights,
+//   Graph::setEdgeWeights): every road moves by a delta in [minDelta, maxDelta]
+//   and is clamped with max(1, w + d)
+// - Deltas are a counter-based hash of (seed, step, road), with no generator
+//   state, so a step gives the same weights however it is chunked or
+//   threaded, and any single delta can be recomputed on its own
+// - The loop is branch-free 32-bit integer work in fixed-size blocks, which
+//   the compiler turns into SIMD at the build's -O2
+
+class CongestionKernel {
+public:
+    enum : std::size_t { kBlock = 16, kChunk = 1 << 16 };   // SIMD block; roads per parallel task
+
+    // The delta range is clamped to 65536 values.
+    explicit CongestionKernel(std::uint64_t seed, int minDelta = -3, int maxDelta = 5): seed(seed) {
+        if(maxDelta<minDelta) std::swap(minDelta, maxDelta);
+        lo = minDelta; span = (std::uint32_t)std::min<long long>((long long)maxDelta - minDelta + 1, 65536);
+    }
+
+    int minDelta() const { return lo; }
+    int maxDelta() const { return lo + (int)span - 1; }
+
+    // The delta road `road` gets in step `step`.
+    int delta(std::uint64_t step, std::size_t road) const { return deltaFor(key(step), (std::uint32_t)road, lo, span); }
+
+    // w[i] = max(1, w[i] + delta(step, first + i)) for i in [0, n).
+    void apply(int* w, std::size_t n, std::uint64_t step, std::size_t first = 0) const {
+        // Locals, not members: w could alias *this, which would cost -O2 the vector loop.
+        const std::uint32_t k = key(step), sp = span; const int base = lo;
+        std::uint32_t road = (std::uint32_t)first; std::size_t i = 0;
+        for(; i+kBlock<=n; i+=kBlock, road+=kBlock){
+            int* b = w + i;
+            for(std::uint32_t j=0; j<kBlock; ++j){ int v = b[j] + deltaFor(k, road+j, base, sp); b[j] = v<1 ? 1 : v; }
+        }
+        for(; i<n; ++i, ++road){ int v = w[i] + deltaFor(k, road, base, sp); w[i] = v<1 ? 1 : v; }
+    }
+
+    // The whole array, kChunk roads per task; identical to apply(w.data(), w.size(), step).
+    void apply(std::vector<int>& w, std::uint64_t step, ThreadPool& pool) const {
+        std::size_t chunks = (w.size() + kChunk - 1) / kChunk;
+        pool.parallelFor(chunks, 1, [&](std::size_t c, unsigned){
+            std::size_t b = c*kChunk; apply(w.data()+b, std::min<std::size_t>(kChunk, w.size()-b), step, b);
+        });
+    }
+
+private:
+    std::uint64_t seed; int lo; std::uint32_t span;
+
+    // lowbias32 (Wellons): a cheap, well-mixed 32-bit permutation.
+    static std::uint32_t mix(std::uint32_t x){
+        x ^= x >> 16; x *= 0x7feb352du; x ^= x >> 15; x *= 0x846ca68bu; x ^= x >> 16; return x;
+    }
+    std::uint32_t key(std::uint64_t step) const {
+        return mix((std::uint32_t)seed ^ mix((std::uint32_t)(seed >> 32) ^ mix((std::uint32_t)step ^ mix((std::uint32_t)(step >> 32)))));
+    }
+    // Top 16 hash bits scaled onto [lo, lo + span); 32-bit math only.
+    static int deltaFor(std::uint32_t k, std::uint32_t road, int lo, std::uint32_t span){
+        std::uint32_t h = mix(road * 0x9e3779b9u ^ k);
+        return lo + (int)(((h >> 16) * span) >> 16);
+    }
+};
@@ -0,0 +1,2 @@
+#include "contraction_hierarchy.h"
+// Header-only; this TU keeps the one-file-per-module build layout.
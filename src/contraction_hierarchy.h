@@ -0,0 +1,266 @@
+#pragma once
+#include "graph.h"
+#include "dijkstra.h"
+#include "search_workspace.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <algorithm>
+
+// Contraction hierarchies ~290 LOC
+// - Offline: contract nodes in edge-difference order, adding shortcuts only
+//   where a bounded witness search finds no equally short detour
+// - Save/load the hierarchy as a small binary file next to the map
+// - ChQuery: bidirectional upward search + shortcut unpacking; distances and
+//   paths are exact (same as dijkstra()) for the weights it was built from
+// Weight updates on the Graph are not reflected: rebuild after simulation.
+// Node IDs are the graph's: after Graph::renumber matches() fails; rebuild.
+
+struct ChArc { NodeId to; int w; NodeId mid; };   // mid == kInvalidNode: original road
+
+struct ChBuildStats { std::size_t shortcuts = 0; std::size_t upArcs = 0; };
+
+class ContractionHierarchy {
+public:
+    std::size_t nodeCount() const { return rank.size(); }
+    std::size_t arcCount() const { return arcs.size(); }
+    std::uint32_t rankOf(NodeId u) const { return rank[u]; }
+
+    // Arcs from u to higher-ranked nodes.
+    const ChArc* upBegin(NodeId u) const { return arcs.data()+offset[u]; }
+    const ChArc* upEnd(NodeId u) const { return arcs.data()+offset[u+1]; }
+
+    // True if this hierarchy was built from a graph with g's roads under g's
+    // node IDs (a renumbered or rebuilt graph fails). O(arcs).
+    bool matches(const Graph& g) const { return nodeCount()==g.nodeCount() && srcArcs==g.arcCount() && shape==fingerprint(g); }
+
+    static ContractionHierarchy build(const Graph& g, ChBuildStats* stats=nullptr){
+        Builder b(g); ContractionHierarchy ch = b.run(); ch.shape = fingerprint(g);
+        if(stats){ stats->shortcuts=b.shortcuts; stats->upArcs=ch.arcs.size(); }
+        return ch;
+    }
+
+    // Binary layout: magic, version, nodes, arcs, source arcs, source
+    // fingerprint (2 words), rank[], offset[], arcs[]
+    bool save(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary); if(!out.is_open()) return false;
+        std::uint32_t hdr[7] = { kMagic, kVersion, (std::uint32_t)rank.size(), (std::uint32_t)arcs.size(), (std::uint32_t)srcArcs,
+                                 (std::uint32_t)shape, (std::uint32_t)(shape >> 32) };
+        out.write((const char*)hdr, sizeof(hdr));
+        out.write((const char*)rank.data(), rank.size()*sizeof(std::uint32_t));
+        out.write((const char*)offset.data(), offset.size()*sizeof(std::uint32_t));
+        out.write((const char*)arcs.data(), arcs.size()*sizeof(ChArc));
+        return (bool)out;
+    }
+
+    // Checks the counts against the file size and the arrays against each
+    // other (offsets, arc ends, ranks going up, shortcut middles below both
+    // ends) so ChQuery never reads out of bounds. On failure *this is left as
+    // it was.
+    bool load(const std::string& path){
+        std::ifstream in(path, std::ios::binary); if(!in.is_open()) return false;
+        std::uint32_t hdr[7]; if(!in.read((char*)hdr, sizeof(hdr)) || hdr[0]!=kMagic || hdr[1]!=kVersion) return false;
+        in.seekg(0, std::ios::end); std::uint64_t fileSize = (std::uint64_t)(std::streamoff)in.tellg(); in.seekg(sizeof(hdr));
+        std::uint64_t n = hdr[2], m = hdr[3];
+        if(n==0xFFFFFFFFu || fileSize != sizeof(hdr) + 4*n + 4*(n+1) + m*sizeof(ChArc)) return false;
+        ContractionHierarchy ch; ch.srcArcs = hdr[4]; ch.shape = hdr[5] | (std::uint64_t)hdr[6] << 32;
+        ch.rank.resize(n); ch.offset.resize(n+1); ch.arcs.resize(m);
+        in.read((char*)ch.rank.data(), ch.rank.size()*sizeof(std::uint32_t));
+        in.read((char*)ch.offset.data(), ch.offset.size()*sizeof(std::uint32_t));
+        in.read((char*)ch.arcs.data(), ch.arcs.size()*sizeof(ChArc));
+        if(!in || !ch.valid()) return false;
+        swap(ch); return true;
+    }
+
+    void swap(ContractionHierarchy& o){ rank.swap(o.rank); offset.swap(o.offset); arcs.swap(o.arcs); std::swap(srcArcs, o.srcArcs); std::swap(shape, o.shape); }
+
+private:
+    enum : std::uint32_t { kMagic = 0x48434353u /* "SCCH" */, kVersion = 2 };
+
+    std::vector<std::uint32_t> rank, offset;
+    std::vector<ChArc> arcs;
+    std::size_t srcArcs = 0;
+    std::uint64_t shape = 0;   // fingerprint() of the source graph
+
+    bool valid() const {
+        std::size_t n = rank.size();
+        if(offset.size()!=n+1 || offset[0]!=0 || offset[n]!=arcs.size()) return false;
+        for(NodeId u=0; u<n; ++u) if(offset[u]>offset[u+1]) return false;
+        for(NodeId u=0; u<n; ++u){
+            if(rank[u]>=n) return false;
+            for(const ChArc* a = upBegin(u); a != upEnd(u); ++a){
+                if(a->to>=n || rank[a->to]<=rank[u]) return false;
+                if(a->mid!=kInvalidNode && (a->mid>=n || rank[a->mid]>=rank[u])) return false;
+            }
+        }
+        return true;
+    }
+
+    // FNV-1a over the node count and every node's arc heads in CSR order:
+    // changes with renumbering or any new road, not with weights.
+    static std::uint64_t fingerprint(const Graph& g){
+        std::uint64_t h = 1469598103934665603ull;
+        auto mix = [&h](std::uint64_t x){ h ^= x; h *= 1099511628211ull; };
+        mix(g.nodeCount());
+        for(NodeId u=0; u<g.nodeCount(); ++u){ mix(g.degree(u)); for(auto e: g.neighbors(u)) mix(e.v); }
+        return h;
+    }
+
+    class Builder {
+    public:
+        std::size_t shortcuts = 0;
+
+        explicit Builder(const Graph& g): n(g.nodeCount()), srcArcs(g.arcCount()), adj(n), deleted(n,0), mark(n,0) {
+            for(NodeId u=0; u<n; ++u) for(const auto &e: g.neighbors(u)) relaxArc(u, e.v, e.w, kInvalidNode);
+        }
+
+        ContractionHierarchy run(){
+            ContractionHierarchy ch; ch.srcArcs = srcArcs; ch.rank.assign(n, 0);
+            std::vector<std::vector<ChArc>> up(n);
+            IndexedDaryHeap order; order.reserveNodes(n);
+            for(NodeId v=0; v<n; ++v) order.push(v, priority(v));
+            std::uint32_t next = 0;
+            while(!order.empty()){
+                NodeId v = order.pop().node;
+                // Lazy update: priorities drift as neighbours get contracted, so
+                // re-check on pop instead of re-scoring every neighbour (far
+                // cheaper once the remaining core gets dense).
+                int p = priority(v);
+                if(!order.empty() && p > order.top().key){ order.push(v, p); continue; }
+                contract(v, true);
+                for(auto &a: adj[v]){ up[v].push_back(a); deleted[a.to]++; }
+                ch.rank[v] = next++;
+                for(auto &a: up[v]) dropArc(a.to, v);
+                std::vector<ChArc>().swap(adj[v]);
+            }
+            ch.offset.assign(n+1, 0);
+            for(NodeId u=0; u<n; ++u) ch.offset[u+1] = ch.offset[u] + (std::uint32_t)up[u].size();
+            ch.arcs.reserve(ch.offset[n]);
+            for(NodeId u=0; u<n; ++u) ch.arcs.insert(ch.arcs.end(), up[u].begin(), up[u].end());
+            return ch;
+        }
+
+    private:
+        std::size_t n, srcArcs;
+        std::vector<std::vector<ChArc>> adj;     // uncontracted neighbours only, min weight
+        std::vector<int> deleted;                // contracted neighbours per node
+        std::vector<std::uint32_t> mark; std::uint32_t markGen = 0;
+        std::vector<ChArc> nb;
+        SearchWorkspace ws;
+
+        // Insert or shorten u->v (and keep adj free of parallel arcs).
+        void relaxArc(NodeId u, NodeId v, int w, NodeId mid){
+            if(u==v) return;
+            for(auto &a: adj[u]) if(a.to==v){ if(w<a.w){ a.w=w; a.mid=mid; } return; }
+            adj[u].push_back({v,w,mid});
+        }
+
+        void dropArc(NodeId u, NodeId v){
+            auto &l = adj[u];
+            for(std::size_t i=0; i<l.size(); ++i) if(l[i].to==v){ l[i]=l.back(); l.pop_back(); return; }
+        }
+
+        // Shortest u->* distances avoiding `skip`, bounded by maxDist/settle
+        // limit; stops early once `targets` nodes marked with `mark` are settled.
+        void witnessSearch(NodeId u, NodeId skip, int maxDist, int settleLimit, int targets){
+            ws.reset(n); ws.label(u, 0, kInvalidNode); ws.heap.push(u, 0);
+            int settledCount = 0;
+            while(!ws.heap.empty() && targets>0){
+                auto top = ws.heap.pop();
+                if(top.key > maxDist || ++settledCount > settleLimit) break;
+                if(mark[top.node]==markGen) targets--;
+                for(auto &a: adj[top.node]){
+                    if(a.to==skip) continue;
+                    int nd = top.key + a.w;
+                    if(nd < ws.distance(a.to)){ ws.label(a.to, nd, top.node); ws.heap.pushOrDecrease(a.to, nd); }
+                }
+            }
+        }
+
+        // Shortcuts needed to remove v; adds them when apply is set.
+        int contract(NodeId v, bool apply){
+            nb.assign(adj[v].begin(), adj[v].end());
+            std::sort(nb.begin(), nb.end(), [](const ChArc& a, const ChArc& b){ return a.w<b.w; });
+            int added = 0;
+            for(std::size_t i=0; i+1<nb.size(); ++i){
+                // Pairs (i, j>i): search from nb[i] towards the remaining neighbours.
+                markGen++; for(std::size_t j=i+1; j<nb.size(); ++j) mark[nb[j].to]=markGen;
+                witnessSearch(nb[i].to, v, nb[i].w + nb.back().w, apply ? 200 : 10, (int)(nb.size()-i-1));
+                for(std::size_t j=i+1; j<nb.size(); ++j){
+                    int via = nb[i].w + nb[j].w;
+                    if(ws.distance(nb[j].to) <= via) continue;
+                    added++;
+                    if(apply){ relaxArc(nb[i].to, nb[j].to, via, v); relaxArc(nb[j].to, nb[i].to, via, v); shortcuts++; }
+                }
+            }
+            return added;
+        }
+
+        int priority(NodeId v){
+            return contract(v, false) - (int)adj[v].size() + deleted[v];
+        }
+    };
+};
+
+// Query engine over a shared, read-only hierarchy. One per thread.
+class ChQuery {
+public:
+    explicit ChQuery(const ContractionHierarchy& h): ch(h) {}
+
+    PathResult route(NodeId src, NodeId dst){
+        settled = 0; PathResult res;
+        if(src>=ch.nodeCount() || dst>=ch.nodeCount()) return res;
+        fwd.reset(ch.nodeCount()); bwd.reset(ch.nodeCount());
+        fwd.label(src, 0, kInvalidNode); fwd.heap.push(src, 0);
+        bwd.label(dst, 0, kInvalidNode); bwd.heap.push(dst, 0);
+        long long best = SearchWorkspace::INF; NodeId meet = kInvalidNode;
+        while(true){
+            bool fOpen = !fwd.heap.empty() && fwd.heap.top().key < best;
+            bool bOpen = !bwd.heap.empty() && bwd.heap.top().key < best;
+            if(!fOpen && !bOpen) break;
+            bool forward = fOpen && (!bOpen || fwd.heap.top().key <= bwd.heap.top().key);
+            SearchWorkspace &self = forward ? fwd : bwd, &other = forward ? bwd : fwd;
+            auto top = self.heap.pop(); settled++;
+            NodeId u = top.node; int d = top.key;
+            if(other.reached(u) && (long long)d + other.dist[u] < best){ best = (long long)d + other.dist[u]; meet = u; }
+            for(const ChArc* a = ch.upBegin(u); a != ch.upEnd(u); ++a){
+                int nd = d + a->w;
+                if(nd < self.distance(a->to)){ self.label(a->to, nd, u); self.heap.pushOrDecrease(a->to, nd); }
+            }
+        }
+        if(meet==kInvalidNode) return res;
+        res.distance = (int)best;
+        std::vector<NodeId> up, down; fwd.extractPath(src, meet, up); bwd.extractPath(dst, meet, down);
+        for(std::size_t i = down.size(); i-- > 1; ) up.push_back(down[i-1]);
+        res.path.push_back(src);
+        for(std::size_t i=0; i+1<up.size(); ++i) unpack(up[i], up[i+1], res.path);
+        return res;
+    }
+
+    std::size_t lastSettled() const { return settled; }
+
+private:
+    const ContractionHierarchy& ch;
+    SearchWorkspace fwd, bwd;
+    std::size_t settled = 0;
+    std::vector<std::pair<NodeId,NodeId>> stack;
+
+    // The arc between two adjacent hierarchy nodes lives with the lower rank.
+    const ChArc* findArc(NodeId a, NodeId b) const {
+        NodeId lo = ch.rankOf(a) < ch.rankOf(b) ? a : b, hi = lo==a ? b : a;
+        for(const ChArc* p = ch.upBegin(lo); p != ch.upEnd(lo); ++p) if(p->to==hi) return p;
+        return nullptr;
+    }
+
+    // Appends the original roads of a->b (excluding a) to out.
+    void unpack(NodeId a, NodeId b, std::vector<NodeId>& out){
+        stack.clear(); stack.push_back({a,b});
+        while(!stack.empty()){
+            auto seg = stack.back(); stack.pop_back();
+            const ChArc* arc = findArc(seg.first, seg.second);
+            if(!arc || arc->mid==kInvalidNode){ out.push_back(seg.second); continue; }
+            stack.push_back({arc->mid, seg.second}); stack.push_back({seg.first, arc->mid});
+        }
+    }
+};
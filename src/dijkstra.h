@@ -1,71 +1,84 @@
 #pragma once
 #include "graph.h"
-#include <queue>
-#include <unordered_map>
+#include "search_workspace.h"
+#include <vector>
+#include <string>
 #include <limits>
-#include <functional>
+#include <utility>
 #include <algorithm>
 #include <iostream>
 
 // Dijkstra module ~130 LOC including extras:
-// - Computes shortest path from src to dst
+// - Computes shortest path from src to dst on the per-thread SearchWorkspace
+//   (indexed 4-ary heap, generation-stamped labels; no per-query allocation)
 // - Prints distance table when requested
-// - Supports on-visit callback for visualization
+// - Supports on-visit callback (template parameter) for visualization
+// - dijkstra() reports its latency and search counters to metrics.h
 
 struct PathResult {
     int distance = std::numeric_limits<int>::max();
-    std::vector<char> path;
+    std::vector<NodeId> path;
 };
 
-inline void printDistanceTable(const std::unordered_map<char,int>& dist){
-    std::vector<std::pair<char,int>> v(dist.begin(), dist.end());
-    std::sort(v.begin(), v.end(), [](auto&a, auto&b){return a.first<b.first;});
+inline void printDistanceTable(const Graph& g, const std::vector<int>& dist){
     std::cout << "+------+-----------+\n";
     std::cout << "| Node | Distance |\n";
     std::cout << "+------+-----------+\n";
-    for(auto &p: v){
-        std::cout << "|  "<<p.first<<"   | ";
-        if(p.second==std::numeric_limits<int>::max()) std::cout << "INF";
-        else std::cout << p.second;
+    for(NodeId u=0; u<dist.size(); ++u){
+        std::cout << "|  "<<g.name(u)<<"   | ";
+        if(dist[u]==std::numeric_limits<int>::max()) std::cout << "INF";
+        else std::cout << dist[u];
         std::cout << std::string(9,' ').substr(0,9) << "|\n";
     }
     std::cout << "+------+-----------+\n";
 }
 
-inline PathResult dijkstra(const Graph& g, char src, char dst,
-                           std::function<void(char,int)> onVisit=nullptr,
-                           bool verbose=false){
-    using P = std::pair<int,char>; // (dist, node)
-    std::priority_queue<P, std::vector<P>, std::greater<P>> pq;
-    std::unordered_map<char,int> dist;
-    std::unordered_map<char,char> parent;
-
-    auto nodes = g.nodes();
-    for(char u: nodes) dist[u]=std::numeric_limits<int>::max();
-    if(!g.hasNode(src) || !g.hasNode(dst)) return {};
+// Callback used when the caller does not need per-node visits; compiles away.
+struct NoVisit { void operator()(NodeId, int) const {} };
 
-    dist[src]=0; pq.push(P(0,src));
-    while(!pq.empty()){
-        P top = pq.top(); pq.pop();
-        int d = top.first; char u=top.second;
-        if(d!=dist[u]) continue; // stale
-        if(onVisit) onVisit(u,d);
-        if(u==dst) break;
+// Core search: settles nodes from src until dst is popped. Leaves labels in ws
+// for path extraction. Returns INF if dst is unreachable.
+template<class OnVisit = NoVisit>
+inline int dijkstraSearch(const Graph& g, NodeId src, NodeId dst, SearchWorkspace& ws, OnVisit&& onVisit = OnVisit()){
+    ws.reset(g.nodeCount());
+    if(!g.hasNode(src) || !g.hasNode(dst)) return SearchWorkspace::INF;
+    ws.label(src, 0, kInvalidNode); ws.heap.push(src, 0);
+    while(!ws.heap.empty()){
+        auto top = ws.heap.pop();
+        NodeId u = top.node; int d = top.key;
+        onVisit(u, d);
+        if(u==dst) return d;
+        ws.countArcs(g.neighbors(u).size());
         for(const auto &e: g.neighbors(u)){
-            char v=e.v; int w=e.w;
-            if(dist[v] > dist[u] + w){
-                dist[v] = dist[u] + w; parent[v]=u; pq.push(P(dist[v], v));
-            }
+            int nd = d + e.w;
+            if(nd < ws.distance(e.v)){ ws.label(e.v, nd, u); ws.heap.pushOrDecrease(e.v, nd); }
         }
     }
+    return SearchWorkspace::INF;
+}
 
-    if(verbose) printDistanceTable(dist);
+template<class OnVisit = NoVisit>
+inline PathResult dijkstra(const Graph& g, NodeId src, NodeId dst,
+                           OnVisit&& onVisit = OnVisit(),
+                           bool verbose=false){
+    ScopedTimer timer(kTimeRoute);
+    SearchWorkspace& ws = threadWorkspace(); SearchCounters before = ws.counters();
+    PathResult res; res.distance = dijkstraSearch(g, src, dst, ws, std::forward<OnVisit>(onVisit));
+    Metrics::global().search(kSearchDijkstra, ws.counters() - before);
+    if(verbose){ std::vector<int> dist(g.nodeCount()); for(NodeId u=0; u<dist.size(); ++u) dist[u]=ws.distance(u); printDistanceTable(g, dist); }
+    if(res.distance!=SearchWorkspace::INF) ws.extractPath(src, dst, res.path);
+    return res;
+}
 
-    PathResult res; res.distance = dist.count(dst)? dist[dst] : std::numeric_limits<int>::max();
-    if(res.distance==std::numeric_limits<int>::max()) return res;
+// Convenience overload taking node names as they appear in the map file.
+template<class OnVisit = NoVisit>
+inline PathResult dijkstra(const Graph& g, const std::string& src, const std::string& dst,
+                           OnVisit&& onVisit = OnVisit(),
+                           bool verbose=false){
+    return dijkstra(g, g.id(src), g.id(dst), std::forward<OnVisit>(onVisit), verbose);
+}
 
-    // Reconstruct
-    std::vector<char> rev; char cur=dst; rev.push_back(cur);
-    while(cur!=src){ auto it=parent.find(cur); if(it==parent.end()){ rev.clear(); break; } cur=it->second; rev.push_back(cur);} 
-    std::reverse(rev.begin(), rev.end()); res.path=rev; return res;
+// "A->C->G" style rendering used by history and console output.
+inline std::string pathString(const Graph& g, const std::vector<NodeId>& path, const std::string& sep="->"){
+    std::string s; for(size_t i=0;i<path.size();++i){ s+=g.name(path[i]); if(i+1<path.size()) s+=sep; } return s;
 }
@@ -0,0 +1,2 @@
+#include "dynamic_sssp.h"
+// Header-only; this TU keeps the one-file-per-module build layout.
@@ -0,0 +1,181 @@
+#pragma once
+#include "graph.h"
+#include "dijkstra.h"
+#include "search_workspace.h"
+#include "traffic_simulator.h"
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+
+// Dynamic shortest-path tree ~170 LOC
+// - Full single-source tree (dist + parent for every node) from one source
+// - repair(changes): after TrafficSimulator::apply, only the subtrees hanging
+//   off slower roads are cut and re-attached, and only nodes that a faster
+//   road can improve are re-relaxed (Ramalingam-Reps style)
+// - RouteTracker: one tree per distinct source for a set of watched routes
+// Weight changes must be reported through repair(), one batch per weight
+// version (Graph::applyUpdates, TrafficSimulator::apply). Any other edit to
+// the graph (new nodes/roads, unreported weights, a batch split over several
+// versions) is caught by weightVersion() and falls back to a full rebuild.
+// Graph::renumber moves layoutVersion(): the tree rebuilds from the same ID,
+// which now names another node, and RouteTracker drops its routes.
+
+class ShortestPathTree {
+public:
+    enum : int { INF = std::numeric_limits<int>::max() };
+
+    explicit ShortestPathTree(const Graph& g): graph(g) {}
+
+    NodeId source() const { return src; }
+    bool isCurrent() const { return src!=kInvalidNode && syncedVersion==graph.weightVersion() && syncedLayout==graph.layoutVersion() && dist.size()==graph.nodeCount(); }
+    int distance(NodeId u) const { return u<dist.size() ? dist[u] : INF; }
+    const std::vector<int>& distances() const { return dist; }
+
+    // Orphaned plus settled nodes in the last build or repair.
+    std::size_t lastTouched() const { return touched; }
+
+    // Recompute everything from s with a plain Dijkstra.
+    void build(NodeId s){
+        std::size_t n = graph.nodeCount();
+        src = s; dist.assign(n, INF); parent.assign(n, kInvalidNode); heap.reserveNodes(n); heap.clear();
+        touched = 0; syncedVersion = graph.weightVersion(); syncedLayout = graph.layoutVersion();
+        if(!graph.hasNode(s)) return;
+        dist[s] = 0; heap.push(s, 0);
+        settle();
+    }
+
+    // Keep the tree rooted at s, rebuilding only if the source or graph moved on.
+    void ensure(NodeId s){ if(s!=src || !isCurrent()) build(s); }
+
+    // Bring the tree up to date with one batch of weight changes already
+    // applied to the graph: the batch must be the only edit since the tree
+    // was last current, i.e. exactly one weight version.
+    void repair(const std::vector<TrafficChange>& changes){
+        if(src==kInvalidNode || isCurrent()) return;
+        if(dist.size()!=graph.nodeCount() || graph.weightVersion()!=syncedVersion+1 || graph.layoutVersion()!=syncedLayout){ build(src); return; }
+        std::size_t n = graph.nodeCount();
+        if(cut.size()<n){ cut.resize(n, 0); }
+        if(++cutGen==0){ std::fill(cut.begin(), cut.end(), 0u); cutGen=1; }
+        heap.clear(); touched = 0;
+
+        // Slower roads: a child whose tree arc no longer yields its label loses
+        // its whole subtree.
+        orphans.clear();
+        for(const auto &c: changes){ invalidate(c.u, c.v); invalidate(c.v, c.u); }
+        for(std::size_t i=0; i<orphans.size(); ++i){
+            NodeId x = orphans[i];
+            for(const auto &e: graph.neighbors(x)) if(parent[e.v]==x && !isCut(e.v)){ cut[e.v]=cutGen; orphans.push_back(e.v); }
+        }
+        for(NodeId x: orphans){ dist[x] = INF; parent[x] = kInvalidNode; }
+        // Re-attach each orphan to its best intact neighbour.
+        for(NodeId x: orphans){
+            for(const auto &e: graph.neighbors(x)){
+                if(isCut(e.v) || dist[e.v]==INF) continue;
+                int nd = dist[e.v] + e.w;
+                if(nd < dist[x]){ dist[x] = nd; parent[x] = e.v; }
+            }
+            if(dist[x]!=INF) heap.push(x, dist[x]);
+        }
+        touched += orphans.size();
+
+        // Faster roads: seed the far endpoint if the road now improves it.
+        for(const auto &c: changes){ improve(c.u, c.v); improve(c.v, c.u); }
+
+        settle();
+        syncedVersion = graph.weightVersion();
+    }
+
+    // src -> dst along the tree; empty if dst is unreachable.
+    void path(NodeId dst, std::vector<NodeId>& out) const {
+        out.clear(); if(dst>=dist.size() || dist[dst]==INF) return;
+        for(NodeId cur=dst; cur!=kInvalidNode; cur=parent[cur]) out.push_back(cur);
+        std::reverse(out.begin(), out.end());
+    }
+    PathResult route(NodeId dst) const { PathResult res; path(dst, res.path); if(!res.path.empty()) res.distance = dist[dst]; return res; }
+
+private:
+    const Graph& graph;
+    NodeId src = kInvalidNode;
+    std::uint64_t syncedVersion = ~0ull, syncedLayout = 0;
+    std::vector<int> dist;
+    std::vector<NodeId> parent;
+    IndexedDaryHeap heap;
+    std::vector<std::uint32_t> cut; std::uint32_t cutGen = 0;
+    std::vector<NodeId> orphans;
+    std::size_t touched = 0;
+
+    bool isCut(NodeId u) const { return cut[u]==cutGen; }
+
+    int minWeight(NodeId a, NodeId b) const {
+        int w = INF; for(const auto &e: graph.neighbors(a)) if(e.v==b) w = std::min(w, e.w); return w;
+    }
+
+    void invalidate(NodeId a, NodeId b){
+        if(!graph.hasNode(a) || !graph.hasNode(b) || parent[b]!=a || isCut(b)) return;
+        int w = minWeight(a, b);
+        if(w!=INF && dist[a]!=INF && dist[a] + w <= dist[b]) return;   // faster: improve() handles it
+        cut[b] = cutGen; orphans.push_back(b);
+    }
+
+    void improve(NodeId a, NodeId b){
+        if(!graph.hasNode(a) || !graph.hasNode(b) || dist[a]==INF) return;
+        int nd = dist[a] + minWeight(a, b);
+        if(nd < dist[b]){ dist[b] = nd; parent[b] = a; heap.pushOrDecrease(b, nd); }
+    }
+
+    // Dijkstra from whatever is queued; labels only ever go down here.
+    void settle(){
+        while(!heap.empty()){
+            auto top = heap.pop(); touched++;
+            NodeId u = top.node; int d = top.key;
+            for(const auto &e: graph.neighbors(u)){
+                int nd = d + e.w;
+                if(nd < dist[e.v]){ dist[e.v] = nd; parent[e.v] = u; heap.pushOrDecrease(e.v, nd); }
+            }
+        }
+    }
+};
+
+// Watched (src, dst) routes sharing one repaired tree per source.
+class RouteTracker {
+public:
+    struct Tracked { NodeId src, dst; int distance; bool changed; };
+
+    explicit RouteTracker(const Graph& g): graph(g), layout(g.layoutVersion()) {}
+
+    void track(NodeId src, NodeId dst){
+        checkLayout();
+        for(const auto &r: routes) if(r.src==src && r.dst==dst) return;
+        ShortestPathTree& t = treeFor(src); t.ensure(src);
+        routes.push_back({src, dst, t.distance(dst), false});
+    }
+    void clear(){ routes.clear(); trees.clear(); }
+
+    // Repair every tree, then flag routes whose travel time moved. After
+    // Graph::renumber (or any layout change) the tracked IDs name other
+    // places, so every route is dropped instead.
+    const std::vector<Tracked>& update(const std::vector<TrafficChange>& changes){
+        checkLayout();
+        for(auto &t: trees) t.repair(changes);
+        for(auto &r: routes){ int d = treeFor(r.src).distance(r.dst); r.changed = d!=r.distance; r.distance = d; }
+        return routes;
+    }
+
+    const std::vector<Tracked>& tracked() const { return routes; }
+    PathResult route(NodeId src, NodeId dst){ checkLayout(); ShortestPathTree& t = treeFor(src); t.ensure(src); return t.route(dst); }
+    const std::vector<int>& distances(NodeId src){ checkLayout(); ShortestPathTree& t = treeFor(src); t.ensure(src); return t.distances(); }
+
+private:
+    const Graph& graph;
+    std::vector<Tracked> routes;
+    std::vector<ShortestPathTree> trees;
+    std::uint64_t layout;
+
+    void checkLayout(){ if(graph.layoutVersion()!=layout){ clear(); layout = graph.layoutVersion(); } }
+
+    ShortestPathTree& treeFor(NodeId src){
+        for(auto &t: trees) if(t.source()==src) return t;
+        trees.emplace_back(graph); trees.back().build(src); return trees.back();
+    }
+};
@@ -6,13 +6,21 @@
 #include <iomanip>
 #include <sstream>
 #include <ctime>
+#include <cstdio>
+#include <cstdint>
 
-// File I/O ~60 LOC
-// - route history append/read
-// - timestamp helper
+// File I/O ~70 LOC
+// - plain-text route history append/read (route_history.h is the indexed
+//   binary store; importText() reads this format)
+// - timestamp helpers
 
-inline std::string nowTimestamp(){
-    auto t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+inline std::int64_t nowEpochSeconds(){
+    return (std::int64_t)std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Local time as "YYYY-MM-DD HH:MM:SS".
+inline std::string formatTimestamp(std::int64_t epoch){
+    std::time_t t = (std::time_t)epoch;
     std::tm tm{}; 
     #if defined(_MSC_VER)
         localtime_s(&tm, &t);
@@ -22,6 +30,17 @@ inline std::string nowTimestamp(){
     std::ostringstream os; os<< std::put_time(&tm, "%Y-%m-%d %H:%M:%S"); return os.str();
 }
 
+inline std::string nowTimestamp(){ return formatTimestamp(nowEpochSeconds()); }
+
+// Inverse of formatTimestamp; false if s does not start with a timestamp.
+inline bool parseTimestamp(const std::string& s, std::int64_t& epoch){
+    std::tm tm{}; tm.tm_isdst = -1;
+    if(std::sscanf(s.c_str(), "%d-%d-%d %d:%d:%d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday, &tm.tm_hour, &tm.tm_min, &tm.tm_sec)!=6) return false;
+    tm.tm_year -= 1900; tm.tm_mon -= 1;
+    std::time_t t = std::mktime(&tm); if(t==(std::time_t)-1) return false;
+    epoch = (std::int64_t)t; return true;
+}
+
 inline void appendHistory(const std::string& path, const std::string& route, int minutes){
     std::ofstream out(path, std::ios::app); if(!out.is_open()) return; out << nowTimestamp() << " | " << route << " | " << minutes << " min\n";
 }
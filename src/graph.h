@@ -4,90 +4,527 @@
 #include <string>
 #include <fstream>
 #include <sstream>
-#include <set>
 #include <iostream>
+#include <tuple>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <climits>
+#include <memory>
+#include <atomic>
+#include "mapped_file.h"
+#include "metrics.h"
 
-// Graph module (adjacency list) ~120 LOC including comments
-// - Load from file (u v w per line)
-// - Validate nodes
-// - Display adjacency and degree
+// Graph module (compressed sparse row) ~400 LOC including comments
+// - Dense uint32_t node IDs plus a name <-> ID dictionary
+// - Build phase collects undirected edges; the first read freezes them into
+//   contiguous offset/target/weight arrays (CSR)
+// - Every road has a stable EdgeId (insertion order, kept across rebuilds);
+//   its two arcs are linked through rev[] so weight updates are O(1)
+// - Per-node place label and lat/lng (data/places.txt) for display and A*
+// - Load from file (u v w per line) through a memory-mapped, allocation-light
+//   parser; display adjacency and degree
+// - Binary snapshot: CSR arrays are used straight from the mapped file and
+//   only copied to the heap on the first weight change or rebuild
+// - Views: read-only copies that share another graph's arcs and can read
+//   weights from an external per-arc array (see live_graph.h)
+// - renumber(): move every node to a new ID (names, places and arcs follow,
+//   EdgeIds stay) so a locality order from node_order.h can be applied once
+//   at load time
+// - layoutVersion(): a stamp that changes whenever node IDs, the road set or
+//   node places change, for caches of per-node or per-road data
 // - Provide helpers for algorithms and visualization
 
-struct Edge { char v; int w; };
+using NodeId = std::uint32_t;
+using EdgeId = std::uint32_t;
+static const NodeId kInvalidNode = 0xFFFFFFFFu;
+static const EdgeId kInvalidEdge = 0xFFFFFFFFu;
+
+struct Edge { NodeId v; int w; };
+
+// One weight change on road u-v, as reported by the traffic simulator. With
+// edge == kInvalidEdge the change applies to every road between u and v.
+struct TrafficChange { NodeId u; NodeId v; int delta; int newWeight; EdgeId edge = kInvalidEdge; };
+
+// Great-circle distance in km; a true metric, so it is safe for A* bounds.
+inline double haversineKm(double lat1, double lng1, double lat2, double lng2){
+    const double R=6371.0, rad=3.14159265358979323846/180.0;
+    double dlat=(lat2-lat1)*rad, dlng=(lng2-lng1)*rad;
+    double a=std::sin(dlat/2)*std::sin(dlat/2) + std::cos(lat1*rad)*std::cos(lat2*rad)*std::sin(dlng/2)*std::sin(dlng/2);
+    return 2*R*std::asin(std::min(1.0, std::sqrt(a)));
+}
 
 class Graph {
 public:
-    // adjacency list: node -> list of (neighbor, weight)
-    std::unordered_map<char, std::vector<Edge>> adj;
+    // Lightweight view over the outgoing arcs of one node. Yields Edge by value,
+    // so iterate with `for(auto e: ...)` or `for(const auto &e: ...)`.
+    struct EdgeRange {
+        const NodeId* t; const int* w; std::size_t n;
+        struct iterator {
+            const NodeId* t; const int* w;
+            Edge operator*() const { return {*t, *w}; }
+            iterator& operator++(){ ++t; ++w; return *this; }
+            bool operator!=(const iterator& o) const { return t!=o.t; }
+        };
+        iterator begin() const { return {t, w}; }
+        iterator end() const { return {t+n, w+n}; }
+        std::size_t size() const { return n; }
+        bool empty() const { return n==0; }
+    };
+
+    // ---- name dictionary ----
+    NodeId addNode(const std::string& name){
+        indexNames(); auto it=ids.find(name); if(it!=ids.end()) return it->second;
+        NodeId id=(NodeId)names.size(); names.push_back(name); ids.emplace(name,id);
+        labels.emplace_back(); lats.push_back(NAN); lngs.push_back(NAN);
+        dirty=true; return id;
+    }
+    NodeId id(const std::string& name) const { indexNames(); auto it=ids.find(name); return it==ids.end()? kInvalidNode : it->second; }
+    const std::string& name(NodeId u) const { return names[u]; }
 
-    bool hasNode(char u) const { return adj.find(u)!=adj.end(); }
+    // ---- place info ----
+    void setPlace(NodeId u, const std::string& label, double lat, double lng){ labels[u]=label; lats[u]=lat; lngs[u]=lng; layout=nextLayout(); }
+    const std::string& label(NodeId u) const { return labels[u]; }
+    double lat(NodeId u) const { return lats[u]; }
+    double lng(NodeId u) const { return lngs[u]; }
+    bool hasCoords(NodeId u) const { return !std::isnan(lats[u]) && !std::isnan(lngs[u]); }
+    bool allCoords() const { for(NodeId u=0; u<nodeCount(); ++u) if(!hasCoords(u)) return false; return nodeCount()>0; }
+    double distanceKm(NodeId u, NodeId v) const { return haversineKm(lats[u], lngs[u], lats[v], lngs[v]); }
 
-    std::vector<char> nodes() const {
-        std::set<char> s;
-        for (auto &kv: adj) s.insert(kv.first);
-        return std::vector<char>(s.begin(), s.end());
+    // Bumped on every weight change or rebuild; lets callers cache derived data.
+    std::uint64_t weightVersion() const { return version; }
+    // Changes on every rebuild, renumber(), clear(), snapshot load and place
+    // change, to a value no other layout in the process has had (copies and
+    // views share it). Anything holding node IDs, per-node or per-road data
+    // built from this graph is stale once it moves.
+    std::uint64_t layoutVersion() const { freeze(); return layout; }
+
+    std::size_t nodeCount() const { return names.size(); }
+    std::size_t arcCount() const { freeze(); return arcs(); }       // directed arcs (2 per road)
+    std::size_t edgeCount() const { return arcCount()/2; }               // undirected roads; EdgeIds are [0, edgeCount())
+
+    bool hasNode(NodeId u) const { return u<names.size(); }
+    bool hasNode(const std::string& name) const { indexNames(); return ids.count(name)!=0; }
+
+    // ---- CSR access ----
+    EdgeRange neighbors(NodeId u) const {
+        freeze(); if(u>=names.size()) return {nullptr,nullptr,0};
+        const std::uint32_t* off=offs(); std::uint32_t b=off[u], e=off[u+1];
+        return {heads()+b, wts()+b, (std::size_t)(e-b)};
     }
+    std::size_t degree(NodeId u) const { return neighbors(u).size(); }
 
-    const std::vector<Edge>& neighbors(char u) const {
-        static const std::vector<Edge> empty;
-        auto it=adj.find(u); return it==adj.end()? empty : it->second;
+    // ---- build phase ----
+    // Self-loops carry no routing information and are dropped.
+    void addEdge(NodeId u, NodeId v, int w){
+        if(u==v) return;
+        pending.push_back({u,v,w}); dirty=true;
     }
+    void addEdge(const std::string& u, const std::string& v, int w){ NodeId a=addNode(u), b=addNode(v); addEdge(a,b,w); }
 
-    void addEdge(char u, char v, int w){
-        adj[u].push_back({v,w});
-        adj[v].push_back({u,w});
+    // Build the CSR arrays from pending edges. Called lazily by every reader,
+    // so call it explicitly before sharing a graph across threads.
+    void freeze() const {
+        if(!dirty) return;
+        const_cast<Graph*>(this)->build();
     }
 
-    bool setWeight(char u, char v, int w){
-        bool ok=false;
-        auto upd=[&](char a,char b){
-            auto it=adj.find(a); if(it==adj.end()) return; 
-            for(auto &e: it->second) if(e.v==b){ e.w=w; ok=true; }
-        }; upd(u,v); upd(v,u); return ok;
+    // ---- roads by EdgeId ----
+    // The arc stored at the road's first endpoint (as passed to addEdge).
+    std::uint32_t edgeArc(EdgeId e) const { freeze(); return firstArcs()[e]; }
+    NodeId edgeSource(EdgeId e) const { std::uint32_t a=edgeArc(e); return heads()[revs()[a]]; }
+    NodeId edgeTarget(EdgeId e) const { return heads()[edgeArc(e)]; }
+    int edgeWeight(EdgeId e) const { return wts()[edgeArc(e)]; }
+    // Road owning an arc, e.g. for arcs found while scanning neighbors().
+    EdgeId arcEdge(std::uint32_t arc) const { freeze(); return edgeOfs()[arc]; }
+    std::uint32_t arcBegin(NodeId u) const { freeze(); return offs()[u]; }
+    // The same road's arc in the opposite direction.
+    std::uint32_t arcRev(std::uint32_t arc) const { freeze(); return revs()[arc]; }
+
+    // First road between u and v (either direction), or kInvalidEdge.
+    EdgeId findEdge(NodeId u, NodeId v) const {
+        std::uint32_t a=findArc(u,v); return a==kNoArc? kInvalidEdge : edgeOfs()[a];
     }
 
-    bool addWeightDelta(char u, char v, int d){
-        bool ok=false;
-        auto upd=[&](char a,char b){
-            auto it=adj.find(a); if(it==adj.end()) return; 
-            for(auto &e: it->second) if(e.v==b){ e.w = std::max(1, e.w + d); ok=true; }
-        }; upd(u,v); upd(v,u); return ok;
+    // ---- weights ----
+    bool setWeight(EdgeId e, int w){
+        freeze(); if(e>=edgeCount()) return false; detach();
+        std::uint32_t a=firstArc[e]; weight[a]=weight[rev[a]]=w; version++; return true;
+    }
+    bool addWeightDelta(EdgeId e, int d){
+        freeze(); if(e>=edgeCount()) return false; detach();
+        std::uint32_t a=firstArc[e]; weight[a]=weight[rev[a]]=std::max(1, weight[a]+d); version++; return true;
+    }
+
+    // Every road's weight in EdgeId order, and the bulk write back (one
+    // version bump); for kernels that work on a flat per-road array.
+    std::vector<int> edgeWeights() const {
+        freeze(); const std::uint32_t* fa=firstArcs(); const int* w=wts();
+        std::vector<int> out(edgeCount()); for(EdgeId e=0; e<out.size(); ++e) out[e]=w[fa[e]];
+        return out;
+    }
+    void setEdgeWeights(const int* w){
+        freeze(); detach();
+        for(EdgeId e=0; e<firstArc.size(); ++e){ std::uint32_t a=firstArc[e]; weight[a]=weight[rev[a]]=w[e]; }
+        version++;
+    }
+
+    // Pair versions touch every road between u and v; only the endpoint with
+    // the smaller degree is scanned.
+    bool setWeight(NodeId u, NodeId v, int w){
+        bool ok=false; freeze(); if(!hasNode(u) || !hasNode(v)) return false; detach();
+        forEachArc(u, v, [&](std::uint32_t i){ weight[i]=weight[rev[i]]=w; ok=true; });
+        version++; return ok;
     }
 
-    int getWeight(char u, char v) const {
-        auto it=adj.find(u); if(it==adj.end()) return -1;
-        for(auto &e: it->second) if(e.v==v) return e.w; return -1;
+    bool addWeightDelta(NodeId u, NodeId v, int d){
+        bool ok=false; freeze(); if(!hasNode(u) || !hasNode(v)) return false; detach();
+        forEachArc(u, v, [&](std::uint32_t i){ weight[i]=weight[rev[i]]=std::max(1, weight[i]+d); ok=true; });
+        version++; return ok;
     }
 
-    std::vector<std::tuple<char,char,int>> edgesUniqueUndirected() const {
-        std::set<std::pair<char,char>> seen; std::vector<std::tuple<char,char,int>> out;
-        for (auto &kv: adj){ char u=kv.first; for(auto &e: kv.second){ char v=e.v; int w=e.w; char a=std::min(u,v), b=std::max(u,v); if(!seen.count({a,b})){ seen.insert({a,b}); out.emplace_back(a,b,w);} }}
+    int getWeight(NodeId u, NodeId v) const {
+        std::uint32_t a=findArc(u,v); return a==kNoArc? -1 : wts()[a];
+    }
+
+    // Batched addWeightDelta: each change goes through its EdgeId when set,
+    // else through u-v. Fills in newWeight and bumps the version once.
+    // Returns the number of changes that matched a road.
+    std::size_t applyUpdates(std::vector<TrafficChange>& changes){
+        freeze(); detach(); std::size_t applied=0; std::size_t m=edgeCount();
+        for(auto &c: changes){
+            c.newWeight=-1;
+            if(c.edge!=kInvalidEdge){
+                if(c.edge>=m) continue;
+                std::uint32_t a=firstArc[c.edge]; weight[a]=weight[rev[a]]=std::max(1, weight[a]+c.delta);
+                c.newWeight=weight[a]; applied++;
+            } else if(hasNode(c.u) && hasNode(c.v)){
+                bool hit=false;
+                forEachArc(c.u, c.v, [&](std::uint32_t i){ weight[i]=weight[rev[i]]=std::max(1, weight[i]+c.delta); if(!hit) c.newWeight=weight[i]; hit=true; });
+                if(hit) applied++;
+            }
+        }
+        version++; return applied;
+    }
+
+    // Each road once, as (u, v, w) with u < v.
+    std::vector<std::tuple<NodeId,NodeId,int>> edgesUniqueUndirected() const {
+        std::vector<std::tuple<NodeId,NodeId,int>> out; out.reserve(edgeCount());
+        for(NodeId u=0; u<nodeCount(); ++u) for(auto e: neighbors(u)) if(u<e.v) out.emplace_back(u,e.v,e.w);
         return out;
     }
 
-    void clear(){ adj.clear(); }
+    // ---- renumbering ----
+    // Node u becomes newId[u]; newId must be a permutation of [0, nodeCount()).
+    // Names, places and arcs move with their nodes, each node keeps its arc
+    // order and every road keeps its EdgeId and first endpoint. Returns false,
+    // changing nothing, if newId is not a permutation. Moves layoutVersion():
+    // Routers recompute their A* geometry, a RouteCache drops its routes on
+    // the next invalidate(),
+    // ContractionHierarchy::matches() fails and RouteTracker drops its routes.
+    bool renumber(const std::vector<NodeId>& newId){
+        freeze(); std::size_t n=nodeCount(); if(newId.size()!=n) return false;
+        std::vector<NodeId> oldId(n, kInvalidNode);
+        for(NodeId u=0; u<n; ++u){ if(newId[u]>=n || oldId[newId[u]]!=kInvalidNode) return false; oldId[newId[u]]=u; }
+        const std::uint32_t* off=offs(); const NodeId* hd=heads(); const int* w=wts(); const std::uint32_t* rv=revs(); const EdgeId* eo=edgeOfs();
+        std::size_t m=arcs();
+        std::vector<std::uint32_t> noff(n+1,0), nrev(m), nfirst(m/2), moved(m);
+        std::vector<NodeId> nhead(m); std::vector<int> nweight(m); std::vector<EdgeId> nedge(m);
+        for(NodeId v=0; v<n; ++v) noff[v+1]=noff[v]+(off[oldId[v]+1]-off[oldId[v]]);
+        for(NodeId v=0; v<n; ++v){
+            std::uint32_t a=noff[v];
+            for(std::uint32_t i=off[oldId[v]]; i<off[oldId[v]+1]; ++i, ++a){ moved[i]=a; nhead[a]=newId[hd[i]]; nweight[a]=w[i]; nedge[a]=eo[i]; }
+        }
+        for(std::uint32_t i=0; i<m; ++i) nrev[moved[i]]=moved[rv[i]];
+        for(EdgeId e=0; e<m/2; ++e) nfirst[e]=moved[firstArcs()[e]];
+        indexNames();
+        std::vector<std::string> nnames(n), nlabels(n); std::vector<double> nlats(n), nlngs(n);
+        for(NodeId u=0; u<n; ++u){ NodeId v=newId[u]; nnames[v].swap(names[u]); nlabels[v].swap(labels[u]); nlats[v]=lats[u]; nlngs[v]=lngs[u]; }
+        names.swap(nnames); labels.swap(nlabels); lats.swap(nlats); lngs.swap(nlngs);
+        for(auto &kv: ids) kv.second=newId[kv.second];
+        snap.reset();
+        offset.swap(noff); head.swap(nhead); weight.swap(nweight); rev.swap(nrev); edgeOf.swap(nedge); firstArc.swap(nfirst);
+        version++; layout=nextLayout(); return true;
+    }
+
+    // ---- views ----
+    // Read-only copy serving its arcs from this graph's frozen arrays; names
+    // and places are copied. This graph must outlive the view and must not be
+    // written or rebuilt meanwhile. Writing to the view copies its arcs out.
+    Graph view() const {
+        freeze(); indexNames();
+        Graph v; v.names=names; v.ids=ids; v.labels=labels; v.lats=lats; v.lngs=lngs;
+        auto sp=std::make_shared<Snapshot>();
+        sp->offset=offs(); sp->head=heads(); sp->weight=wts(); sp->rev=revs(); sp->edgeOf=edgeOfs(); sp->firstArc=firstArcs();
+        sp->arcs=arcs(); sp->nodes=nodeCount(); if(snap) sp->owner=snap->owner;
+        v.snap=std::move(sp); v.version=version; v.layout=layout;
+        return v;
+    }
+
+    // Make a view read weights from w (one int per arc, in this graph's arc
+    // order) and report ver as its weightVersion(). The caller keeps w alive.
+    // False on graphs that own their arcs.
+    bool bindWeights(const int* w, std::uint64_t ver){
+        if(!snap || dirty) return false;
+        if(snap.use_count()>1) snap=std::make_shared<Snapshot>(*snap);   // other copies keep theirs
+        snap->weight=w; version=ver; return true;
+    }
+
+    void clear(){ names.clear(); ids.clear(); idsStale=false; labels.clear(); lats.clear(); lngs.clear(); pending.clear(); offset.assign(1,0); head.clear(); weight.clear(); rev.clear(); edgeOf.clear(); firstArc.clear(); snap.reset(); dirty=false; version++; layout=nextLayout(); }
+
+    // Approximate heap footprint of the frozen graph (excluding names). Arcs
+    // still served from a snapshot mapping do not count.
+    std::size_t memoryBytes() const {
+        freeze();
+        return offset.capacity()*sizeof(std::uint32_t) + head.capacity()*sizeof(NodeId) + weight.capacity()*sizeof(int)
+             + rev.capacity()*sizeof(std::uint32_t) + edgeOf.capacity()*sizeof(EdgeId) + firstArc.capacity()*sizeof(std::uint32_t);
+    }
 
-    // Load: each line "U V W"; lines starting with # ignored
+    // Load: each line "U V W"; lines starting with # ignored. Node names are
+    // arbitrary whitespace-free tokens. A binary snapshot (saveSnapshot) is
+    // recognised by its magic and loaded instead.
     bool loadFromFile(const std::string& path){
-        std::ifstream in(path); if(!in.is_open()) return false; clear();
+        ScopedTimer timer(kTimeLoad);
+        auto file=std::make_shared<MappedFile>(); if(!file->open(path)) return false;
+        if(isSnapshot(*file)) return mapSnapshot(std::move(file));
+        clear();
+        const char *p=file->data(), *end=p+file->size();
+        pending.reserve((std::size_t)std::count(p,end,'\n')+1);
+        std::string u, v; int w;
+        while(p<end){
+            const char* eol=(const char*)std::memchr(p,'\n',(std::size_t)(end-p)); if(!eol) eol=end;
+            const char* q=p;
+            if(p<eol && *p!='#' && nextToken(q,eol,u) && nextToken(q,eol,v) && parseInt(q,eol,w)) addEdge(u,v,w);
+            p = eol==end ? end : eol+1;
+        }
+        freeze();
+        return true;
+    }
+
+    // Snapshot layout (native endianness): header, lat[n], lng[n],
+    // offset[n+1], head[m], weight[m], rev[m], edgeOf[m], firstArc[m/2],
+    // nameOff[n+1], labelOff[n+1], text.
+    bool saveSnapshot(const std::string& path) const {
+        freeze(); std::ofstream out(path, std::ios::binary); if(!out.is_open()) return false;
+        std::size_t n=nodeCount();
+        std::vector<std::uint32_t> nameOff(1,0), labelOff(1,0); std::string text;
+        for(NodeId u=0; u<n; ++u){ text+=names[u]; nameOff.push_back((std::uint32_t)text.size()); }
+        labelOff[0]=(std::uint32_t)text.size();
+        for(NodeId u=0; u<n; ++u){ text+=labels[u]; labelOff.push_back((std::uint32_t)text.size()); }
+        if(text.size()>0xFFFFFFFFull) return false;
+        SnapshotHeader h; std::memcpy(h.magic, snapshotMagic(), 8); h.version=kSnapshotVersion;
+        h.nodes=(std::uint32_t)n; h.arcs=(std::uint32_t)arcs(); h.reserved=0; h.textBytes=text.size();
+        out.write((const char*)&h, sizeof(h));
+        out.write((const char*)lats.data(), n*sizeof(double)); out.write((const char*)lngs.data(), n*sizeof(double));
+        out.write((const char*)offs(), (n+1)*sizeof(std::uint32_t));
+        out.write((const char*)heads(), arcs()*sizeof(NodeId)); out.write((const char*)wts(), arcs()*sizeof(int));
+        out.write((const char*)revs(), arcs()*sizeof(std::uint32_t)); out.write((const char*)edgeOfs(), arcs()*sizeof(EdgeId));
+        out.write((const char*)firstArcs(), arcs()/2*sizeof(std::uint32_t));
+        out.write((const char*)nameOff.data(), nameOff.size()*sizeof(std::uint32_t));
+        out.write((const char*)labelOff.data(), labelOff.size()*sizeof(std::uint32_t));
+        out.write(text.data(), (std::streamsize)text.size());
+        return (bool)out;
+    }
+
+    bool loadSnapshot(const std::string& path){
+        auto file=std::make_shared<MappedFile>(); if(!file->open(path) || !isSnapshot(*file)) return false;
+        return mapSnapshot(std::move(file));
+    }
+
+    // Places: each line "U LAT LNG Label words..."; # comments. Unknown node
+    // IDs are skipped so a shared places file can cover several maps.
+    bool loadPlaces(const std::string& path){
+        std::ifstream in(path); if(!in.is_open()) return false;
         std::string line; while(std::getline(in,line)){
             if(line.empty() || line[0]=='#') continue; std::stringstream ss(line);
-            char u,v; int w; if(ss>>u>>v>>w){ addEdge(u,v,w);} }
+            std::string u, label; double la, lo; if(!(ss>>u>>la>>lo)) continue;
+            std::getline(ss>>std::ws, label); NodeId id=this->id(u); if(id!=kInvalidNode) setPlace(id, label, la, lo); }
         return true;
     }
 
     // Debug/Display: print adjacency info
     void printSummary(std::ostream& os=std::cout) const{
-        os << "Nodes: "; auto ns=nodes(); for(char u: ns) os<<u<<" "; os<<"\n";
-        for(char u: ns){ os<<u<<": "; for(auto &e: neighbors(u)) os<<"("<<e.v<<","<<e.w<<") "; os<<"\n"; }
+        os << "Nodes: "; for(NodeId u=0; u<nodeCount(); ++u) os<<name(u)<<" "; os<<"\n";
+        for(NodeId u=0; u<nodeCount(); ++u){ os<<name(u)<<": "; for(auto e: neighbors(u)) os<<"("<<name(e.v)<<","<<e.w<<") "; os<<"\n"; }
     }
 
     // Simple ASCII adjacency table
     void printTable(std::ostream& os=std::cout) const{
-        auto ns = nodes(); os << "+------+---------------------------+\n";
+        os << "+------+---------------------------+\n";
         os << "| Node | Neighbors (v:w)          |\n";
         os << "+------+---------------------------+\n";
-        for(char u: ns){ os << "|  "<<u<<"   | "; bool first=true; for(auto &e: neighbors(u)){ if(!first) os<<", "; first=false; os<<e.v<<":"<<e.w; } os << std::string(27, ' ').substr(0,27) << "|\n"; }
+        for(NodeId u=0; u<nodeCount(); ++u){ os << "|  "<<name(u)<<"   | "; bool first=true; for(auto e: neighbors(u)){ if(!first) os<<", "; first=false; os<<name(e.v)<<":"<<e.w; } os << std::string(27, ' ').substr(0,27) << "|\n"; }
         os << "+------+---------------------------+\n";
     }
+
+private:
+    struct PendingEdge { NodeId u, v; int w; };
+
+    static const char* snapshotMagic(){ return "SCGRAPH"; }   // 8 bytes with the NUL
+    enum : std::uint32_t { kSnapshotVersion = 2, kNoArc = 0xFFFFFFFFu };
+    struct SnapshotHeader { char magic[8]; std::uint32_t version, nodes, arcs, reserved; std::uint64_t textBytes; };
+
+    // Arc arrays owned elsewhere (a mapped snapshot, or the graph a view was
+    // taken from) plus typed pointers into them. Shared read-only between
+    // copies of a Graph; arcs are copied out before they are written.
+    struct Snapshot {
+        std::shared_ptr<const void> owner;   // the mapping, if any
+        const std::uint32_t* offset; const NodeId* head; const int* weight;
+        const std::uint32_t* rev; const EdgeId* edgeOf; const std::uint32_t* firstArc; std::size_t arcs;
+        std::size_t nodes;   // offset has nodes+1 entries; addNode() may have grown names since
+    };
+
+    std::vector<std::string> names;
+    mutable std::unordered_map<std::string, NodeId> ids;
+    mutable bool idsStale=false;   // set by snapshot loads; rebuilt on first name lookup
+    std::vector<std::string> labels;
+    std::vector<double> lats, lngs;
+    std::vector<PendingEdge> pending;
+
+    // CSR: arcs of node u live in [offset[u], offset[u+1])
+    std::vector<std::uint32_t> offset = std::vector<std::uint32_t>(1,0);
+    std::vector<NodeId> head;
+    std::vector<int> weight;
+    // Road links: rev[a] is the opposite arc of the same road, edgeOf[a] its
+    // EdgeId, firstArc[e] the arc at the road's first endpoint.
+    std::vector<std::uint32_t> rev;
+    std::vector<EdgeId> edgeOf;
+    std::vector<std::uint32_t> firstArc;
+    std::shared_ptr<Snapshot> snap;
+    bool dirty=false;
+    std::uint64_t version=0, layout=nextLayout();
+
+    const std::uint32_t* offs() const { return snap? snap->offset : offset.data(); }
+    const NodeId* heads() const { return snap? snap->head : head.data(); }
+    const int* wts() const { return snap? snap->weight : weight.data(); }
+    const std::uint32_t* revs() const { return snap? snap->rev : rev.data(); }
+    const EdgeId* edgeOfs() const { return snap? snap->edgeOf : edgeOf.data(); }
+    const std::uint32_t* firstArcs() const { return snap? snap->firstArc : firstArc.data(); }
+    std::size_t arcs() const { return snap? snap->arcs : head.size(); }
+
+    // Arc u->v found by scanning whichever endpoint has fewer arcs.
+    std::uint32_t findArc(NodeId u, NodeId v) const {
+        freeze(); if(!hasNode(u) || !hasNode(v)) return kNoArc;
+        const std::uint32_t* off=offs(); const NodeId* hd=heads();
+        if(off[u+1]-off[u] <= off[v+1]-off[v]){ for(std::uint32_t i=off[u]; i<off[u+1]; ++i) if(hd[i]==v) return i; }
+        else { for(std::uint32_t i=off[v]; i<off[v+1]; ++i) if(hd[i]==u) return revs()[i]; }
+        return kNoArc;
+    }
+
+    // fn(arc) once per road between u and v, with the arc on the scanned side.
+    template<class F> void forEachArc(NodeId u, NodeId v, F&& fn){
+        NodeId a=u, b=v; if(offset[u+1]-offset[u] > offset[v+1]-offset[v]) std::swap(a, b);
+        for(std::uint32_t i=offset[a]; i<offset[a+1]; ++i) if(head[i]==b) fn(i);
+    }
+
+    // Copy mapped CSR arrays to the heap so they can be modified.
+    void detach(){
+        if(!snap) return;
+        // Nodes added after the snapshot have no arcs yet: pad with its end.
+        std::size_t n=snap->nodes;
+        offset.assign(snap->offset, snap->offset+n+1); offset.resize(nodeCount()+1, snap->offset[n]);
+        head.assign(snap->head, snap->head+snap->arcs); weight.assign(snap->weight, snap->weight+snap->arcs);
+        rev.assign(snap->rev, snap->rev+snap->arcs); edgeOf.assign(snap->edgeOf, snap->edgeOf+snap->arcs);
+        firstArc.assign(snap->firstArc, snap->firstArc+snap->arcs/2);
+        snap.reset();
+    }
+
+    static bool isSnapshot(const MappedFile& f){
+        return f.size()>=sizeof(SnapshotHeader) && std::memcmp(f.data(), snapshotMagic(), 8)==0;
+    }
+
+    // Sizes are checked against the file; arc contents are trusted so that
+    // untouched pages are never read at load time.
+    bool mapSnapshot(std::shared_ptr<MappedFile> file){
+        SnapshotHeader h; std::memcpy(&h, file->data(), sizeof(h));
+        if(h.version!=kSnapshotVersion) return false;
+        std::uint64_t n=h.nodes, m=h.arcs;
+        std::uint64_t need=sizeof(h) + 2*n*sizeof(double) + (n+1)*4 + 4*m*4 + m/2*4 + 2*(n+1)*4 + h.textBytes;
+        if(file->size()!=need) return false;
+        const char* p=file->data()+sizeof(h);
+        const double* la=(const double*)p; p+=n*sizeof(double);
+        const double* lo=(const double*)p; p+=n*sizeof(double);
+        auto sp=std::make_shared<Snapshot>();
+        sp->offset=(const std::uint32_t*)p; p+=(n+1)*4;
+        sp->head=(const NodeId*)p; p+=m*4;
+        sp->weight=(const int*)p; p+=m*4;
+        sp->rev=(const std::uint32_t*)p; p+=m*4;
+        sp->edgeOf=(const EdgeId*)p; p+=m*4;
+        sp->firstArc=(const std::uint32_t*)p; p+=m/2*4;
+        const std::uint32_t* nameOff=(const std::uint32_t*)p; p+=(n+1)*4;
+        const std::uint32_t* labelOff=(const std::uint32_t*)p; p+=(n+1)*4;
+        const char* text=p;
+        if(m%2 || sp->offset[0]!=0 || sp->offset[n]!=m || nameOff[n]>labelOff[0] || labelOff[n]!=h.textBytes) return false;
+        clear();
+        names.reserve(n); labels.reserve(n); idsStale=true;
+        for(std::uint64_t u=0; u<n; ++u){
+            names.emplace_back(text+nameOff[u], nameOff[u+1]-nameOff[u]);
+            labels.emplace_back(text+labelOff[u], labelOff[u+1]-labelOff[u]);
+        }
+        lats.resize(n); lngs.resize(n);
+        std::memcpy(lats.data(), la, n*sizeof(double)); std::memcpy(lngs.data(), lo, n*sizeof(double));
+        sp->arcs=m; sp->nodes=n; sp->owner=std::move(file); snap=std::move(sp);
+        version++; layout=nextLayout();
+        return true;
+    }
+
+    static std::uint64_t nextLayout(){ static std::atomic<std::uint64_t> next{1}; return next++; }
+
+    // Routing by NodeId never needs the name index, so snapshot loads defer it.
+    // Not thread-safe: do one name lookup before sharing such a graph.
+    void indexNames() const {
+        if(!idsStale) return;
+        ids.reserve(names.size()); for(NodeId u=0; u<names.size(); ++u) ids.emplace(names[u], u);
+        idsStale=false;
+    }
+
+    static bool isSpace(char c){ return c==' ' || c=='\t' || c=='\r' || c=='\v' || c=='\f'; }
+
+    static bool nextToken(const char*& p, const char* end, std::string& out){
+        while(p<end && isSpace(*p)) ++p;
+        const char* b=p; while(p<end && !isSpace(*p)) ++p;
+        if(b==p) return false; out.assign(b, p); return true;
+    }
+
+    // Optional sign and decimal digits, like `stream >> int`; rejects overflow.
+    static bool parseInt(const char*& p, const char* end, int& out){
+        while(p<end && isSpace(*p)) ++p;
+        bool neg=false; if(p<end && (*p=='-' || *p=='+')){ neg=*p=='-'; ++p; }
+        long long v=0; const char* b=p;
+        while(p<end && *p>='0' && *p<='9'){ v=v*10+(*p-'0'); if(v>(long long)INT_MAX+1) return false; ++p; }
+        if(b==p || (!neg && v>INT_MAX)) return false;
+        out=(int)(neg? -v : v); return true;
+    }
+
+    // Counting sort of frozen + pending edges into CSR; keeps insertion order
+    // per node. pending[i] becomes EdgeId i.
+    void build(){
+        thaw();
+        std::size_t n=names.size(), m=pending.size();
+        offset.assign(n+1,0);
+        for(auto &e: pending){ offset[e.u+1]++; offset[e.v+1]++; }
+        for(std::size_t i=0;i<n;i++) offset[i+1]+=offset[i];
+        head.assign(offset[n],0); weight.assign(offset[n],0);
+        rev.assign(offset[n],0); edgeOf.assign(offset[n],0); firstArc.assign(m,0);
+        std::vector<std::uint32_t> pos(offset.begin(), offset.end()-1);
+        for(std::size_t i=0;i<m;i++){
+            const PendingEdge& e=pending[i];
+            std::uint32_t a=pos[e.u]++; head[a]=e.v; weight[a]=e.w;
+            std::uint32_t b=pos[e.v]++; head[b]=e.u; weight[b]=e.w;
+            rev[a]=b; rev[b]=a; edgeOf[a]=edgeOf[b]=(EdgeId)i; firstArc[i]=a;
+        }
+        std::vector<PendingEdge>().swap(pending);
+        dirty=false; version++; layout=nextLayout();
+    }
+
+    // Move already-frozen roads, in EdgeId order, in front of the pending list
+    // before a rebuild so existing ids survive.
+    void thaw(){
+        detach(); if(head.empty()) return;
+        std::vector<PendingEdge> all; all.reserve(firstArc.size()+pending.size());
+        for(std::uint32_t a: firstArc) all.push_back({head[rev[a]], head[a], weight[a]});
+        all.insert(all.end(), pending.begin(), pending.end()); pending.swap(all);
+        offset.assign(1,0); head.clear(); weight.clear(); rev.clear(); edgeOf.clear(); firstArc.clear();
+    }
 };
@@ -0,0 +1,2 @@
+#include "http_server.h"
+// Header-only; this TU keeps the one-file-per-module build layout.
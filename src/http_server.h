@@ -0,0 +1,444 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+#include <chrono>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <cerrno>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+#endif
+
+// Embedded HTTP/1.1 server ~360 LOC, no dependencies
+// - One event-loop thread owns every socket: epoll on Linux, poll()/WSAPoll
+//   elsewhere (those wake on a 10 ms tick instead of an eventfd)
+// - Complete requests go to a fixed set of worker threads; finished responses
+//   come back to the loop through a queue, so slow handlers never stall I/O
+// - Keep-alive and pipelining: one request per connection is in flight and
+//   responses leave in request order
+// - Content-Length bodies only (no chunked uploads); 16 KB of headers and
+//   1 MB of body at most. A connection buffers no more than one such request
+//   while another is in flight; past that it gets a 413 and is closed
+// - Out of file descriptors, the listener is paused until a connection
+//   closes or 100 ms pass, so a level-triggered poll does not spin on it
+
+namespace net {
+#if defined(_WIN32)
+using SocketFd = SOCKET;
+static const SocketFd kBadSocket = INVALID_SOCKET;
+inline void closeSocket(SocketFd s){ closesocket(s); }
+inline bool wouldBlock(){ int e = WSAGetLastError(); return e==WSAEWOULDBLOCK || e==WSAEINTR; }
+inline bool outOfResources(){ int e = WSAGetLastError(); return e==WSAEMFILE || e==WSAENOBUFS; }
+inline bool setNonBlocking(SocketFd s){ u_long on = 1; return ioctlsocket(s, FIONBIO, &on)==0; }
+inline void startup(){ static bool done = false; if(!done){ WSADATA d; WSAStartup(MAKEWORD(2,2), &d); done = true; } }
+#else
+using SocketFd = int;
+static const SocketFd kBadSocket = -1;
+inline void closeSocket(SocketFd s){ ::close(s); }
+inline bool wouldBlock(){ return errno==EAGAIN || errno==EWOULDBLOCK || errno==EINTR; }
+inline bool outOfResources(){ return errno==EMFILE || errno==ENFILE || errno==ENOBUFS || errno==ENOMEM; }
+inline bool setNonBlocking(SocketFd s){ int fl = fcntl(s, F_GETFL, 0); return fl>=0 && fcntl(s, F_SETFL, fl | O_NONBLOCK)==0; }
+inline void startup(){}
+#endif
+#if defined(MSG_NOSIGNAL)
+static const int kSendFlags = MSG_NOSIGNAL;   // a dropped client must not raise SIGPIPE
+#else
+static const int kSendFlags = 0;
+#endif
+
+inline void noDelay(SocketFd s){ int on = 1; setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char*)&on, sizeof(on)); }
+
+// Blocking client connection, for tests and the load generator.
+inline SocketFd connectTo(const std::string& host, int port){
+    startup();
+    SocketFd s = socket(AF_INET, SOCK_STREAM, 0); if(s==kBadSocket) return s;
+    sockaddr_in a; std::memset(&a, 0, sizeof(a)); a.sin_family = AF_INET; a.sin_port = htons((unsigned short)port);
+    inet_pton(AF_INET, host.c_str(), &a.sin_addr);
+    if(connect(s, (const sockaddr*)&a, sizeof(a))!=0){ closeSocket(s); return kBadSocket; }
+    noDelay(s); return s;
+}
+
+inline bool sendAll(SocketFd s, const std::string& data){
+    for(std::size_t off = 0; off < data.size(); ){
+        int n = (int)send(s, data.data()+off, (int)(data.size()-off), kSendFlags);
+        if(n<=0) return false;
+        off += (std::size_t)n;
+    }
+    return true;
+}
+
+// One response (Content-Length framed) from a blocking socket. `pending`
+// carries bytes of the next response between calls, for pipelining.
+inline bool readResponse(SocketFd s, std::string& pending, int& status, std::string& body){
+    char buf[16384]; std::size_t hdrEnd;
+    while((hdrEnd = pending.find("\r\n\r\n"))==std::string::npos){
+        int n = (int)recv(s, buf, sizeof(buf), 0); if(n<=0) return false; pending.append(buf, (std::size_t)n);
+    }
+    status = std::atoi(pending.c_str()+9);   // "HTTP/1.1 200"
+    std::size_t len = 0, cl = pending.find("Content-Length: ");
+    if(cl!=std::string::npos && cl<hdrEnd) len = (std::size_t)std::strtoul(pending.c_str()+cl+16, nullptr, 10);
+    while(pending.size() < hdrEnd+4+len){
+        int n = (int)recv(s, buf, sizeof(buf), 0); if(n<=0) return false; pending.append(buf, (std::size_t)n);
+    }
+    body = pending.substr(hdrEnd+4, len); pending.erase(0, hdrEnd+4+len);
+    return true;
+}
+} // namespace net
+
+struct HttpRequest {
+    std::string method, path, query, body;
+    std::vector<std::pair<std::string,std::string>> headers;   // names lower-cased
+    bool keepAlive = true;
+
+    std::string header(const std::string& name) const {
+        for(auto &h: headers) if(h.first==name) return h.second;
+        return std::string();
+    }
+    // Percent-decoded query parameter, or fallback when absent.
+    std::string param(const std::string& name, const std::string& fallback = std::string()) const {
+        std::size_t p = 0;
+        while(p <= query.size()){
+            std::size_t amp = query.find('&', p); if(amp==std::string::npos) amp = query.size();
+            std::size_t eq = query.find('=', p);
+            std::size_t keyEnd = (eq==std::string::npos || eq>amp) ? amp : eq;
+            if(decode(query.substr(p, keyEnd-p))==name) return keyEnd==amp ? std::string() : decode(query.substr(keyEnd+1, amp-keyEnd-1));
+            p = amp+1;
+        }
+        return fallback;
+    }
+    static std::string decode(const std::string& s){
+        std::string out; out.reserve(s.size());
+        for(std::size_t i=0; i<s.size(); ++i){
+            if(s[i]=='+') out += ' ';
+            else if(s[i]=='%' && i+2<s.size() && std::isxdigit((unsigned char)s[i+1]) && std::isxdigit((unsigned char)s[i+2])){
+                out += (char)std::strtol(s.substr(i+1, 2).c_str(), nullptr, 16); i += 2;
+            } else out += s[i];
+        }
+        return out;
+    }
+};
+
+struct HttpResponse {
+    int status = 200;
+    std::string contentType = "application/json";
+    std::string body;
+    std::vector<std::pair<std::string,std::string>> headers;
+};
+
+inline const char* httpReason(int status){
+    switch(status){
+        case 200: return "OK"; case 204: return "No Content"; case 400: return "Bad Request"; case 404: return "Not Found";
+        case 405: return "Method Not Allowed"; case 413: return "Payload Too Large"; case 431: return "Request Header Fields Too Large";
+        case 501: return "Not Implemented"; case 505: return "HTTP Version Not Supported"; default: return "Internal Server Error";
+    }
+}
+
+class HttpServer {
+public:
+    using Handler = std::function<void(const HttpRequest&, HttpResponse&, unsigned worker)>;
+    enum : std::size_t { kMaxHeader = 16*1024, kMaxBody = 1<<20, kMaxBuffered = kMaxHeader + 4 + kMaxBody };
+
+    // workers == 0: one per hardware thread. handler(req, res, worker) runs on
+    // the worker threads; worker is a stable index in [0, workerCount()).
+    explicit HttpServer(Handler h, unsigned workers = 0): handler(std::move(h)) {
+        net::startup();
+        if(workers==0) workers = std::max(1u, std::thread::hardware_concurrency());
+        for(unsigned w=0; w<workers; ++w) pool.emplace_back([this, w]{ work(w); });
+    }
+    ~HttpServer(){
+        stop();
+        for(auto &t: pool) t.join();
+        for(auto &c: conns) net::closeSocket(c.first);
+        if(listener!=net::kBadSocket) net::closeSocket(listener);
+    }
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    unsigned workerCount() const { return (unsigned)pool.size(); }
+    int port() const { return boundPort; }
+
+    // port 0 picks a free one (see port()). False if the address is taken.
+    bool listen(int port, const std::string& host = "127.0.0.1"){
+        listener = socket(AF_INET, SOCK_STREAM, 0); if(listener==net::kBadSocket) return false;
+        int on = 1; setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char*)&on, sizeof(on));
+        sockaddr_in a; std::memset(&a, 0, sizeof(a)); a.sin_family = AF_INET; a.sin_port = htons((unsigned short)port);
+        if(inet_pton(AF_INET, host.c_str(), &a.sin_addr)!=1 || bind(listener, (const sockaddr*)&a, sizeof(a))!=0
+           || ::listen(listener, SOMAXCONN)!=0 || !net::setNonBlocking(listener)){ net::closeSocket(listener); listener = net::kBadSocket; return false; }
+        socklen_t len = sizeof(a); getsockname(listener, (sockaddr*)&a, &len); boundPort = ntohs(a.sin_port);
+        poller.add(listener);
+        return true;
+    }
+
+    // Event loop on the calling thread until stop().
+    void run(){
+        std::vector<Poller::Event> events;
+        while(!stopping.load()){
+            poller.wait(events, acceptPaused ? 100 : -1);
+            if(acceptPaused && std::chrono::steady_clock::now() >= acceptRetry) resumeAccept();
+            for(auto &ev: events){
+                if(ev.fd==listener){ acceptAll(); continue; }
+                auto it = conns.find(ev.fd); if(it==conns.end()) continue;
+                if(ev.readable && !readFrom(it->second)){ closeConn(ev.fd); continue; }
+                it = conns.find(ev.fd);   // a parse error may have closed it
+                if(it!=conns.end() && ev.writable) writeTo(it->second);
+            }
+            deliver();
+        }
+    }
+
+    // Safe from any thread, including handlers.
+    void stop(){
+        stopping.store(true); poller.wake();
+        { std::lock_guard<std::mutex> lk(jobMutex); } jobReady.notify_all();
+    }
+
+private:
+    // ---- readiness polling ----
+    class Poller {
+    public:
+        struct Event { net::SocketFd fd; bool readable, writable; };
+#if defined(__linux__)
+        Poller(){ ep = epoll_create1(EPOLL_CLOEXEC); wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC); ctl(EPOLL_CTL_ADD, wakeFd, EPOLLIN); }
+        ~Poller(){ ::close(wakeFd); ::close(ep); }
+        void add(net::SocketFd fd){ ctl(EPOLL_CTL_ADD, fd, EPOLLIN); }
+        void setWrite(net::SocketFd fd, bool on){ ctl(EPOLL_CTL_MOD, fd, EPOLLIN | (on ? (unsigned)EPOLLOUT : 0u)); }
+        void remove(net::SocketFd fd){ epoll_ctl(ep, EPOLL_CTL_DEL, fd, nullptr); }
+        void wake(){ std::uint64_t one = 1; if(::write(wakeFd, &one, sizeof(one))<0){} }
+        void wait(std::vector<Event>& out, int timeoutMs = -1){
+            epoll_event evs[256]; out.clear();
+            int n = epoll_wait(ep, evs, 256, timeoutMs);
+            for(int i=0; i<n; ++i){
+                if(evs[i].data.fd==wakeFd){ std::uint64_t v; if(::read(wakeFd, &v, sizeof(v))<0){} continue; }
+                bool err = (evs[i].events & (EPOLLERR | EPOLLHUP))!=0;
+                out.push_back({evs[i].data.fd, err || (evs[i].events & EPOLLIN)!=0, (evs[i].events & EPOLLOUT)!=0});
+            }
+        }
+    private:
+        int ep, wakeFd;
+        void ctl(int op, int fd, unsigned events){ epoll_event ev; std::memset(&ev, 0, sizeof(ev)); ev.events = events; ev.data.fd = fd; epoll_ctl(ep, op, fd, &ev); }
+#else
+        void add(net::SocketFd fd){ watched[fd] = false; }
+        void setWrite(net::SocketFd fd, bool on){ watched[fd] = on; }
+        void remove(net::SocketFd fd){ watched.erase(fd); }
+        void wake(){}
+        void wait(std::vector<Event>& out, int = -1){   // always a 10 ms tick
+            fds.clear(); out.clear();
+            for(auto &w: watched){ pollfd p; p.fd = w.first; p.events = POLLIN | (w.second ? POLLOUT : 0); p.revents = 0; fds.push_back(p); }
+#if defined(_WIN32)
+            int n = fds.empty() ? (Sleep(10), 0) : WSAPoll(fds.data(), (ULONG)fds.size(), 10);
+#else
+            int n = poll(fds.data(), (nfds_t)fds.size(), 10);
+#endif
+            for(int i=0; n>0 && i<(int)fds.size(); ++i){
+                short r = fds[i].revents; if(!r) continue;
+                out.push_back({fds[i].fd, (r & (POLLIN | POLLERR | POLLHUP))!=0, (r & POLLOUT)!=0});
+            }
+        }
+    private:
+        std::unordered_map<net::SocketFd, bool> watched; std::vector<pollfd> fds;
+#endif
+    };
+
+    struct Conn {
+        net::SocketFd fd; std::uint64_t id;
+        std::string in, out; std::size_t outOff = 0;
+        bool busy = false, closing = false, wantWrite = false;
+        bool overflow = false;   // buffered past kMaxBuffered while busy: 413 after the current response
+    };
+    struct Job { net::SocketFd fd; std::uint64_t id; HttpRequest req; };
+    struct Done { net::SocketFd fd; std::uint64_t id; std::string bytes; bool close; };
+
+    Handler handler;
+    std::vector<std::thread> pool;
+    Poller poller;
+    net::SocketFd listener = net::kBadSocket; int boundPort = 0;
+    std::atomic<bool> stopping{false};
+    std::unordered_map<net::SocketFd, Conn> conns;   // event-loop thread only
+    std::uint64_t nextId = 1;
+    bool acceptPaused = false; std::chrono::steady_clock::time_point acceptRetry;
+    std::mutex jobMutex; std::condition_variable jobReady; std::deque<Job> jobs;
+    std::mutex doneMutex; std::vector<Done> done, doneScratch;
+
+    void acceptAll(){
+        for(;;){
+            net::SocketFd s = accept(listener, nullptr, nullptr);
+            if(s==net::kBadSocket){
+                // The pending connection stays queued, so the listener would
+                // poll readable again at once: stop watching it for a while.
+                if(net::outOfResources()){ poller.remove(listener); acceptPaused = true; acceptRetry = std::chrono::steady_clock::now() + std::chrono::milliseconds(100); }
+                return;
+            }
+            if(!net::setNonBlocking(s)){ net::closeSocket(s); continue; }
+            net::noDelay(s);
+            Conn c; c.fd = s; c.id = nextId++; conns.emplace(s, std::move(c)); poller.add(s);
+        }
+    }
+
+    void resumeAccept(){ if(acceptPaused){ acceptPaused = false; poller.add(listener); } }
+
+    // False once the peer is gone. Input to a closing connection is dropped,
+    // and no more than kMaxBuffered bytes are held for a busy one.
+    bool readFrom(Conn& c){
+        char buf[16384];
+        for(;;){
+            int n = (int)recv(c.fd, buf, sizeof(buf), 0);
+            if(n>0){
+                if(c.closing) break;
+                c.in.append(buf, (std::size_t)n);
+                if(c.in.size() > kMaxBuffered){
+                    if(!c.busy) break;   // parse() rejects or takes the first request
+                    c.in.clear(); c.closing = true; c.overflow = true; break;
+                }
+                if(n<(int)sizeof(buf)) break; continue;
+            }
+            if(n<0 && net::wouldBlock()) break;
+            return false;
+        }
+        dispatch(c);
+        return true;
+    }
+
+    void writeTo(Conn& c){
+        while(c.outOff < c.out.size()){
+            int n = (int)send(c.fd, c.out.data()+c.outOff, (int)(c.out.size()-c.outOff), net::kSendFlags);
+            if(n>0){ c.outOff += (std::size_t)n; continue; }
+            if(n<0 && net::wouldBlock()){ if(!c.wantWrite){ c.wantWrite = true; poller.setWrite(c.fd, true); } return; }
+            closeConn(c.fd); return;
+        }
+        c.out.clear(); c.outOff = 0;
+        if(c.wantWrite){ c.wantWrite = false; poller.setWrite(c.fd, false); }
+        if(c.closing && !c.busy) closeConn(c.fd);
+    }
+
+    void closeConn(net::SocketFd fd){ poller.remove(fd); net::closeSocket(fd); conns.erase(fd); resumeAccept(); }
+
+    // Hand the next complete request of an idle connection to the workers.
+    void dispatch(Conn& c){
+        if(c.busy || c.closing) return;
+        HttpRequest req; int st = parse(c.in, req);
+        if(st==0) return;
+        if(st<0){
+            c.out += errorResponse(-st); c.closing = true; c.in.clear(); writeTo(c); return;
+        }
+        c.busy = true;
+        { std::lock_guard<std::mutex> lk(jobMutex); jobs.push_back({c.fd, c.id, std::move(req)}); }
+        jobReady.notify_one();
+    }
+
+    // Responses from the workers; the id guards against a reused socket.
+    void deliver(){
+        { std::lock_guard<std::mutex> lk(doneMutex); doneScratch.swap(done); }
+        for(auto &d: doneScratch){
+            auto it = conns.find(d.fd); if(it==conns.end() || it->second.id!=d.id) continue;
+            Conn& c = it->second; c.busy = false; c.closing = c.closing || d.close;
+            c.out += d.bytes;
+            if(c.overflow){ c.out += errorResponse(413); c.overflow = false; }
+            net::SocketFd fd = c.fd; writeTo(c);
+            it = conns.find(fd); if(it!=conns.end() && it->second.id==d.id) dispatch(it->second);
+        }
+        doneScratch.clear();
+    }
+
+    void work(unsigned w){
+        for(;;){
+            Job job;
+            {
+                std::unique_lock<std::mutex> lk(jobMutex);
+                jobReady.wait(lk, [this]{ return stopping.load() || !jobs.empty(); });
+                if(stopping.load()) return;
+                job = std::move(jobs.front()); jobs.pop_front();
+            }
+            HttpResponse res; handler(job.req, res, w);
+            Done d{job.fd, job.id, serialize(res, job.req.keepAlive), !job.req.keepAlive};
+            { std::lock_guard<std::mutex> lk(doneMutex); done.push_back(std::move(d)); }
+            poller.wake();
+        }
+    }
+
+    static std::string errorResponse(int status){
+        HttpResponse res; res.status = status; res.body = std::string("{\"error\": \"") + httpReason(status) + "\"}\n";
+        return serialize(res, false);
+    }
+
+    static std::string serialize(const HttpResponse& res, bool keepAlive){
+        std::string s = "HTTP/1.1 " + std::to_string(res.status) + " " + httpReason(res.status) + "\r\n";
+        s += "Content-Type: " + res.contentType + "\r\nContent-Length: " + std::to_string(res.body.size()) + "\r\n";
+        s += keepAlive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+        s += "Access-Control-Allow-Origin: *\r\n";   // the UI may be opened from file://
+        for(auto &h: res.headers) s += h.first + ": " + h.second + "\r\n";
+        s += "\r\n"; s += res.body;
+        return s;
+    }
+
+    // 1: one request parsed and consumed from `in`; 0: need more bytes;
+    // negative: the HTTP status to fail the connection with.
+    static int parse(std::string& in, HttpRequest& req){
+        std::size_t hdrEnd = in.find("\r\n\r\n");
+        if(hdrEnd==std::string::npos) return in.size() > kMaxHeader ? -431 : 0;
+        if(hdrEnd > kMaxHeader) return -431;
+        std::size_t lineEnd = in.find("\r\n");
+        std::string line = in.substr(0, lineEnd);
+        std::size_t sp1 = line.find(' '), sp2 = line.rfind(' ');
+        if(sp1==std::string::npos || sp2<=sp1) return -400;
+        req.method = line.substr(0, sp1);
+        std::string target = line.substr(sp1+1, sp2-sp1-1), version = line.substr(sp2+1);
+        if(version!="HTTP/1.1" && version!="HTTP/1.0") return version.compare(0, 5, "HTTP/")==0 ? -505 : -400;
+        if(target.empty() || target[0]!='/') return -400;
+        std::size_t q = target.find('?');
+        req.path = HttpRequest::decode(target.substr(0, q));
+        req.query = q==std::string::npos ? std::string() : target.substr(q+1);
+        std::size_t contentLength = 0; std::string connection;
+        for(std::size_t p = lineEnd+2; p < hdrEnd; ){
+            std::size_t e = in.find("\r\n", p); if(e==std::string::npos || e>hdrEnd) e = hdrEnd;
+            std::size_t colon = in.find(':', p);
+            if(colon==std::string::npos || colon>e) return -400;
+            std::string name = in.substr(p, colon-p), value = in.substr(colon+1, e-colon-1);
+            std::transform(name.begin(), name.end(), name.begin(), [](char ch){ return (char)std::tolower((unsigned char)ch); });
+            value.erase(0, value.find_first_not_of(" \t")); value.erase(value.find_last_not_of(" \t")+1);
+            if(name=="content-length"){
+                if(value.empty() || value.find_first_not_of("0123456789")!=std::string::npos || value.size()>9) return -400;
+                contentLength = (std::size_t)std::strtoul(value.c_str(), nullptr, 10);
+            }
+            else if(name=="transfer-encoding") return -501;
+            else if(name=="connection"){ connection = value; std::transform(connection.begin(), connection.end(), connection.begin(), [](char ch){ return (char)std::tolower((unsigned char)ch); }); }
+            req.headers.emplace_back(std::move(name), std::move(value));
+            p = e+2;
+        }
+        if(contentLength > kMaxBody) return -413;
+        if(in.size() < hdrEnd+4+contentLength) return 0;
+        req.body = in.substr(hdrEnd+4, contentLength);
+        req.keepAlive = version=="HTTP/1.1" ? connection!="close" : connection=="keep-alive";
+        in.erase(0, hdrEnd+4+contentLength);
+        return 1;
+    }
+};
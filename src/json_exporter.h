@@ -1,75 +1,198 @@
 #pragma once
 #include "graph.h"
 #include "dijkstra.h"
-#include <fstream>
-#include <sstream>
-#include <iomanip>
+#include "json_writer.h"
+#include "traffic_assignment.h"
+#include "metrics.h"
 #include <vector>
+#include <utility>
+#include <algorithm>
 
-// JSON exporter for web UI: writes graph.json and route.json
-// Simple handcrafted JSON to avoid external libs.
+// JSON exporter for web UI: writes graph.json, graph_delta.json and route.json
+// through JsonWriter (buffered, atomic replace). Handcrafted to avoid external libs.
+// The *Json(..., JsonWriter&) forms write the same documents into any writer,
+// e.g. an HTTP response body.
+// - graph.json carries "version" = Graph::weightVersion() at export time
+// - graph_delta.json lists only the roads a TrafficChange batch touched, with
+//   the version it applies to ("base") and the version it produces; a client
+//   on any other version reloads graph.json instead
+// - route.json from KShortestPaths keeps the single-route fields for the best
+//   route and adds "alternatives": every route found, best first
+// - assignment.json: equilibrium flow, congested minutes and flow/capacity
+//   per road in EdgeId order, for the web heatmap
+// - metrics.json: a metrics.h snapshot (latency percentiles from the log2
+//   histograms, search counter totals, route cache events); the document builders themselves
+//   count as "export" time
+// Road weights are listed per u-v pair in edgesUniqueUndirected() order, so
+// parallel roads can be patched positionally.
 
-struct PlaceInfo {
-    std::string name;
-    double lat;
-    double lng;
-};
-
-inline void writeGraphJson(const Graph& g, const std::string& path) {
-    std::ofstream out(path);
-    if (!out.is_open()) return;
-    out << "{\n  \"nodes\": {\n";
-    bool firstNode = true;
-    // Assign real Delhi place names and coordinates (closer together for real roads)
-    std::unordered_map<char, PlaceInfo> places = {
-        {'A', {"Connaught Place", 28.6308, 77.2177}},
-        {'B', {"Palika Bazar", 28.6315, 77.2185}},
-        {'C', {"Janpath", 28.6295, 77.2190}},
-        {'D', {"Barakhamba", 28.6320, 77.2150}},
-        {'E', {"Bengali Market", 28.6285, 77.2200}},
-        {'F', {"Parliament Street", 28.6270, 77.2140}},
-        {'G', {"India Gate", 28.6297, 77.2245}},
-        {'H', {"Patel Chowk", 28.6330, 77.2160}},
-        {'I', {"Rajiv Chowk", 28.6310, 77.2190}},
-        {'J', {"Barakhamba Road", 28.6325, 77.2175}},
-        {'K', {"Moolchand", 28.5696, 77.2194}},
-        {'L', {"Lajpat Nagar", 28.5672, 77.2433}},
-        {'M', {"South Extension", 28.5696, 77.2194}},
-        {'N', {"Defence Colony", 28.5805, 77.2315}},
-        {'O', {"Greater Kailash", 28.5438, 77.2489}},
-        {'P', {"Hauz Khas", 28.5539, 77.2081}},
-        {'Q', {"Green Park", 28.5642, 77.2034}},
-        {'R', {"Saket", 28.5285, 77.2069}},
-        {'S', {"Nitika Nagar", 28.5400, 77.2500}},
-        {'T', {"Nehru Place", 28.5470, 77.2510}}
-    };
-    for (char u : g.nodes()) {
-        if (!firstNode) out << ",\n";
-        out << "    \"" << u << "\": {\"name\": \"" << places[u].name << "\", \"coords\": [" << places[u].lat << ", " << places[u].lng << "]}";
-        firstNode = false;
+inline void graphJson(const Graph& g, JsonWriter& out) {
+    ScopedTimer timer(kTimeExport);
+    g.freeze();   // a pending rebuild would bump the version mid-export
+    out.raw("{\n  \"version\": ").integer((long long)g.weightVersion()).raw(",\n  \"nodes\": {\n");
+    for (NodeId id = 0; id < g.nodeCount(); ++id) {
+        if (id) out.raw(",\n");
+        // Place label and coordinates come from data/places.txt via the graph
+        double lat = g.hasCoords(id) ? g.lat(id) : 0.0, lng = g.hasCoords(id) ? g.lng(id) : 0.0;
+        out.raw("    ").str(g.name(id)).raw(": {\"name\": ").str(g.label(id));
+        out.raw(", \"coords\": [").number(lat).raw(", ").number(lng).raw("]}");
     }
-    out << "\n  },\n  \"edges\": [\n";
+    out.raw("\n  },\n  \"edges\": [\n");
     bool firstEdge = true;
-    for (auto& e : g.edgesUniqueUndirected()) {
-        if (!firstEdge) out << ",\n";
-        char a, b; int w; std::tie(a, b, w) = e;
-        out << "    {\"from\": \"" << a << "\", \"to\": \"" << b << "\", \"weight\": " << w << "}";
-        firstEdge = false;
+    for (NodeId u = 0; u < g.nodeCount(); ++u) {
+        for (auto e : g.neighbors(u)) {
+            if (e.v < u) continue;
+            if (!firstEdge) out.raw(",\n");
+            out.raw("    {\"from\": ").str(g.name(u)).raw(", \"to\": ").str(g.name(e.v)).raw(", \"weight\": ").integer(e.w).raw('}');
+            firstEdge = false;
+        }
+    }
+    out.raw("\n  ]\n}\n");
+}
+
+inline bool writeGraphJson(const Graph& g, const std::string& path) {
+    JsonWriter out(path);
+    if (!out.ok()) return false;
+    graphJson(g, out);
+    return out.commit();
+}
+
+// Patch for the roads in `changes`, taking a client from `baseVersion` to the
+// graph's current weightVersion().
+inline void graphDeltaJson(const Graph& g, const std::vector<TrafficChange>& changes,
+                           std::uint64_t baseVersion, JsonWriter& out) {
+    ScopedTimer timer(kTimeExport);
+    g.freeze();
+    std::vector<std::pair<NodeId,NodeId>> roads; roads.reserve(changes.size());
+    for (auto& c : changes) if (g.hasNode(c.u) && g.hasNode(c.v)) roads.emplace_back(std::min(c.u, c.v), std::max(c.u, c.v));
+    std::sort(roads.begin(), roads.end()); roads.erase(std::unique(roads.begin(), roads.end()), roads.end());
+    out.raw("{\n  \"base\": ").integer((long long)baseVersion).raw(",\n  \"version\": ").integer((long long)g.weightVersion()).raw(",\n  \"edges\": [\n");
+    for (std::size_t i = 0; i < roads.size(); ++i) {
+        NodeId u = roads[i].first, v = roads[i].second;
+        if (i) out.raw(",\n");
+        out.raw("    {\"from\": ").str(g.name(u)).raw(", \"to\": ").str(g.name(v)).raw(", \"weights\": [");
+        bool first = true;
+        for (auto e : g.neighbors(u)) if (e.v == v) { if (!first) out.raw(", "); out.integer(e.w); first = false; }
+        out.raw("]}");
     }
-    out << "\n  ]\n}\n";
+    out.raw("\n  ]\n}\n");
+}
+
+inline bool writeGraphDeltaJson(const Graph& g, const std::vector<TrafficChange>& changes,
+                                std::uint64_t baseVersion, const std::string& path) {
+    JsonWriter out(path);
+    if (!out.ok()) return false;
+    graphDeltaJson(g, changes, baseVersion, out);
+    return out.commit();
 }
 
-inline void writeRouteJson(const PathResult& res, const std::string& path) {
-    std::ofstream out(path);
-    if (!out.is_open()) return;
+inline void routeJson(const Graph& g, const PathResult& res, JsonWriter& out) {
+    ScopedTimer timer(kTimeExport);
     if (res.path.empty() || res.distance == std::numeric_limits<int>::max()) {
-        out << "{\"error\": \"No path found\"}\n";
+        out.raw("{\"error\": \"No path found\"}\n");
         return;
     }
-    out << "{\n  \"path\": [";
+    out.raw("{\n  \"path\": [");
     for (size_t i = 0; i < res.path.size(); ++i) {
-        out << "\"" << res.path[i] << "\"";
-        if (i + 1 < res.path.size()) out << ", ";
+        out.str(g.name(res.path[i]));
+        if (i + 1 < res.path.size()) out.raw(", ");
+    }
+    out.raw("],\n  \"distance\": ").integer(res.distance);
+    out.raw(",\n  \"version\": ").integer((long long)g.weightVersion()).raw("\n}\n");
+}
+
+inline bool writeRouteJson(const Graph& g, const PathResult& res, const std::string& path) {
+    JsonWriter out(path);
+    if (!out.ok()) return false;
+    routeJson(g, res, out);
+    return out.commit();
+}
+
+inline void routeJson(const Graph& g, const std::vector<PathResult>& routes, JsonWriter& out) {
+    ScopedTimer timer(kTimeExport);
+    if (routes.empty() || routes[0].path.empty()) {
+        out.raw("{\"error\": \"No path found\"}\n");
+        return;
     }
-    out << "],\n  \"distance\": " << res.distance << "\n}\n";
+    auto names = [&](const std::vector<NodeId>& p) {
+        out.raw('[');
+        for (size_t i = 0; i < p.size(); ++i) { if (i) out.raw(", "); out.str(g.name(p[i])); }
+        out.raw(']');
+    };
+    out.raw("{\n  \"path\": "); names(routes[0].path);
+    out.raw(",\n  \"distance\": ").integer(routes[0].distance);
+    out.raw(",\n  \"version\": ").integer((long long)g.weightVersion());
+    out.raw(",\n  \"alternatives\": [\n");
+    for (size_t i = 0; i < routes.size(); ++i) {
+        if (i) out.raw(",\n");
+        out.raw("    {\"path\": "); names(routes[i].path);
+        out.raw(", \"distance\": ").integer(routes[i].distance).raw('}');
+    }
+    out.raw("\n  ]\n}\n");
+}
+
+inline bool writeRouteJson(const Graph& g, const std::vector<PathResult>& routes, const std::string& path) {
+    JsonWriter out(path);
+    if (!out.ok()) return false;
+    routeJson(g, routes, out);
+    return out.commit();
+}
+
+inline void assignmentJson(const Graph& g, const AssignmentResult& r, JsonWriter& out) {
+    ScopedTimer timer(kTimeExport);
+    out.raw("{\n  \"version\": ").integer((long long)g.weightVersion());
+    out.raw(",\n  \"iterations\": ").integer(r.iterations).raw(",\n  \"gap\": ").number(r.relativeGap);
+    out.raw(",\n  \"totalMinutes\": ").number(r.totalTime).raw(",\n  \"unassigned\": ").number(r.unassigned);
+    out.raw(",\n  \"edges\": [\n");
+    for (EdgeId e = 0; e < r.flow.size(); ++e) {
+        if (e) out.raw(",\n");
+        out.raw("    {\"from\": ").str(g.name(g.edgeSource(e))).raw(", \"to\": ").str(g.name(g.edgeTarget(e)));
+        out.raw(", \"flow\": ").number(r.flow[e]).raw(", \"time\": ").number(r.time[e]);
+        out.raw(", \"ratio\": ").number(e < r.capacity.size() && r.capacity[e] > 0 ? r.flow[e] / r.capacity[e] : 0.0).raw('}');
+    }
+    out.raw("\n  ]\n}\n");
+}
+
+inline bool writeAssignmentJson(const Graph& g, const AssignmentResult& r, const std::string& path) {
+    JsonWriter out(path);
+    if (!out.ok()) return false;
+    assignmentJson(g, r, out);
+    return out.commit();
+}
+
+inline void metricsJson(const MetricsSnapshot& m, JsonWriter& out) {
+    auto histogram = [&](const HistogramSnapshot& h, const char* unit) {
+        out.raw("{\"count\": ").integer((long long)h.count);
+        out.raw(", \"mean").raw(unit).raw("\": ").number(h.mean(), 3);
+        out.raw(", \"p50").raw(unit).raw("\": ").number(h.quantile(0.5), 0);
+        out.raw(", \"p90").raw(unit).raw("\": ").number(h.quantile(0.9), 0);
+        out.raw(", \"p99").raw(unit).raw("\": ").number(h.quantile(0.99), 0);
+        out.raw(", \"buckets\": [");
+        for (unsigned i = 0; i < HistogramSnapshot::kBuckets; ++i) { if (i) out.raw(", "); out.integer((long long)h.bucket[i]); }
+        out.raw("]}");
+    };
+    out.raw("{\n  \"enabled\": ").raw(kMetricsEnabled ? "true" : "false").raw(",\n  \"latency\": {\n");
+    for (unsigned t = 0; t < kTimers; ++t) {
+        if (t) out.raw(",\n");
+        out.raw("    ").str(metricTimerName(t)).raw(": "); histogram(m.latencyUs[t], "Us");
+    }
+    out.raw("\n  },\n  \"search\": {\n");
+    for (unsigned k = 0; k < kSearchKinds; ++k) {
+        const SearchCounters& c = m.search[k];
+        if (k) out.raw(",\n");
+        out.raw("    ").str(metricSearchName(k)).raw(": {\"queries\": ").integer((long long)m.queries[k]);
+        out.raw(", \"settled\": ").integer((long long)c.settled).raw(", \"relaxed\": ").integer((long long)c.relaxed);
+        out.raw(", \"pushes\": ").integer((long long)c.pushes).raw(", \"decreases\": ").integer((long long)c.decreases).raw('}');
+    }
+    out.raw("\n  },\n  \"settledPerQuery\": "); histogram(m.settled, "");
+    out.raw(",\n  \"routeCache\": {");
+    for (unsigned c = 0; c < kCacheEvents; ++c) out.str(metricCacheName(c)).raw(": ").integer((long long)m.cache[c]).raw(", ");
+    out.raw("\"hitRate\": ").number(m.cacheHitRate(), 4).raw("}\n}\n");
+}
+
+inline bool writeMetricsJson(const MetricsSnapshot& m, const std::string& path) {
+    JsonWriter out(path);
+    if (!out.ok()) return false;
+    metricsJson(m, out);
+    return out.commit();
 }
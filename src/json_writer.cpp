@@ -0,0 +1,2 @@
+#include "json_writer.h"
+// Header-only; this TU keeps the one-file-per-module build layout.
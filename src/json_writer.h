@@ -0,0 +1,118 @@
+#pragma once
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+// JSON writer ~120 LOC
+// - Fixed 64 KB buffer flushed straight to a FILE*; no ostream formatting
+// - Hand-rolled integer and fixed-point double formatting (snprintf only for
+//   doubles beyond 64-bit fixed point)
+// - Writes to "<path>.tmp" and renames over <path> on commit(), so a reader
+//   (the web UI) never sees a half-written file
+// - Or appends to a std::string (HTTP response bodies); commit() just flushes
+// Structure (commas, nesting) is left to the caller.
+
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string path): target(std::move(path)), tmp(target + ".tmp") {
+        f = std::fopen(tmp.c_str(), "wb");
+    }
+    explicit JsonWriter(std::string* sink): mem(sink) {}
+    ~JsonWriter(){ if(f){ std::fclose(f); std::remove(tmp.c_str()); } else flush(); }
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    bool ok() const { return f!=nullptr || mem!=nullptr; }
+
+    JsonWriter& raw(char c){ if(len==kCap) flush(); buf[len++] = c; return *this; }
+    JsonWriter& raw(const char* s, std::size_t n){
+        if(n > kCap - len){ flush(); if(n > kCap){ if(f) std::fwrite(s, 1, n, f); else if(mem) mem->append(s, n); return *this; } }
+        std::memcpy(buf+len, s, n); len += n; return *this;
+    }
+    JsonWriter& raw(const char* s){ return raw(s, std::strlen(s)); }
+
+    // Quoted and escaped.
+    JsonWriter& str(const std::string& s){
+        static const char hex[] = "0123456789abcdef";
+        raw('"');
+        for(char c: s){
+            switch(c){
+                case '"': raw("\\\"", 2); break;
+                case '\\': raw("\\\\", 2); break;
+                case '\n': raw("\\n", 2); break;
+                case '\r': raw("\\r", 2); break;
+                case '\t': raw("\\t", 2); break;
+                default:
+                    if((unsigned char)c < 0x20){ char e[7] = {'\\','u','0','0', hex[(c>>4)&0xF], hex[c&0xF], 0}; raw(e, 6); }
+                    else raw(c);
+            }
+        }
+        return raw('"');
+    }
+
+    JsonWriter& integer(long long v){
+        char tmpDigits[24]; int n = 0;
+        unsigned long long u = v<0 ? 0ull - (unsigned long long)v : (unsigned long long)v;
+        do { tmpDigits[n++] = (char)('0' + u%10); u /= 10; } while(u);
+        if(v<0) raw('-');
+        while(n) raw(tmpDigits[--n]);
+        return *this;
+    }
+
+    // Fixed point with up to `decimals` digits, trailing zeros trimmed
+    // (28.613900 -> 28.6139). Values too large for that go through %.17g;
+    // NaN and infinities, which JSON cannot express, are written as null.
+    JsonWriter& number(double v, int decimals = 6){
+        if(!std::isfinite(v)) return raw("null", 4);
+        static const double kPow10[] = {1,10,100,1e3,1e4,1e5,1e6,1e7,1e8,1e9};
+        decimals = decimals<0 ? 0 : decimals>9 ? 9 : decimals;
+        double scaled = std::fabs(v) * kPow10[decimals];
+        if(scaled >= 9e18){ char d[32]; int n = std::snprintf(d, sizeof d, "%.17g", v); return raw(d, (std::size_t)n); }
+        unsigned long long q = (unsigned long long)std::llround(scaled), p = (unsigned long long)kPow10[decimals];
+        unsigned long long ip = q / p, fp = q % p;
+        if(v<0 && q!=0) raw('-');
+        integer((long long)ip);
+        if(fp){
+            char d[9]; int n = decimals;
+            while(n && fp%10==0){ fp /= 10; n--; }
+            for(int i=n-1; i>=0; --i){ d[i] = (char)('0' + fp%10); fp /= 10; }
+            raw('.'); raw(d, (std::size_t)n);
+        }
+        return *this;
+    }
+
+    // Flush, close and move the temp file into place. False on any I/O error.
+    bool commit(){
+        if(mem){ flush(); return true; }
+        if(!f) return false;
+        flush(); bool good = !std::ferror(f); good = std::fclose(f)==0 && good; f = nullptr;
+        if(!good){ std::remove(tmp.c_str()); return false; }
+#if defined(_WIN32)
+        if(!MoveFileExA(tmp.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING)){ std::remove(tmp.c_str()); return false; }
+#else
+        if(std::rename(tmp.c_str(), target.c_str())!=0){ std::remove(tmp.c_str()); return false; }
+#endif
+        return true;
+    }
+
+private:
+    enum : std::size_t { kCap = 1<<16 };
+    std::string target, tmp;
+    std::FILE* f = nullptr;
+    std::string* mem = nullptr;
+    char buf[kCap];
+    std::size_t len = 0;
+
+    void flush(){ if(len){ if(f) std::fwrite(buf, 1, len, f); else if(mem) mem->append(buf, len); } len = 0; }
+};
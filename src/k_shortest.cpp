@@ -0,0 +1,2 @@
+#include "k_shortest.h"
+// Header-only; this TU keeps the one-file-per-module build layout.
@@ -0,0 +1,158 @@
+#pragma once
+#include "graph.h"
+#include "dijkstra.h"
+#include "search_workspace.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+// K shortest loopless paths (Yen) ~150 LOC
+// - One reverse Dijkstra from dst, stopped as soon as src settles, is shared
+//   by every spur search: settled nodes know their exact distance to dst and
+//   the rest are at least the search radius away, which makes a consistent
+//   A* heuristic
+// - A spur whose tree path to dst avoids the banned nodes and arcs is read
+//   straight off the tree, no search needed
+// - Only the candidates that can still be returned are kept, and spurs (or
+//   spur searches) that cannot beat the worst of them stop early, so k = 3-5
+//   costs a small multiple of one query
+// Paths are node sequences; between parallel roads the cheapest one counts.
+
+class KShortestPaths {
+public:
+    explicit KShortestPaths(const Graph& g): graph(g) {}
+
+    // Up to k loopless paths from src to dst, shortest first. Empty if dst is
+    // unreachable; fewer than k if the graph has no more.
+    std::vector<PathResult> route(NodeId src, NodeId dst, int k){
+        ScopedTimer timer(kTimeRoute);
+        SearchCounters before = tree.counters() + spur.counters();
+        std::vector<PathResult> out = paths(src, dst, k);
+        Metrics::global().search(kSearchAlternatives, tree.counters() + spur.counters() - before);
+        return out;
+    }
+
+    // Nodes settled by the last route() across the tree and all spur searches.
+    std::size_t lastSettled() const { return settled; }
+    // Spur paths that needed a search (the rest came from the tree or were pruned).
+    std::size_t lastSpurSearches() const { return searches; }
+
+private:
+    struct Candidate { PathResult route; std::size_t dev = 0; };
+
+    const Graph& graph;
+    SearchWorkspace tree, spur;   // reverse tree rooted at dst; spur A*
+    int radius = 0;               // tree search radius when it stopped
+    std::vector<std::uint32_t> banStamp; std::uint32_t banGen = 0;
+    std::size_t settled = 0, searches = 0;
+
+    std::vector<PathResult> paths(NodeId src, NodeId dst, int k){
+        settled = 0; searches = 0;
+        std::vector<PathResult> out;
+        if(k<=0 || !graph.hasNode(src) || !graph.hasNode(dst)) return out;
+        if(!growTree(src, dst)) return out;
+        out.emplace_back(); out.back().distance = tree.dist[src];
+        treePath(src, out.back().path);
+
+        std::vector<std::size_t> dev(1, 0);   // spur index each path left its parent at
+        std::vector<Candidate> cand;          // sorted by distance, at most k - found
+        std::vector<NodeId> root, tail, bannedNext;
+        while((int)out.size() < k){
+            std::size_t need = (std::size_t)k - out.size();
+            const std::vector<NodeId>& last = out.back().path;
+            if(banStamp.size()<graph.nodeCount()) banStamp.resize(graph.nodeCount(), 0);
+            if(++banGen==0){ std::fill(banStamp.begin(), banStamp.end(), 0u); banGen = 1; }
+            long long rootCost = 0; root.clear();
+            for(std::size_t i=0; i+1<last.size(); ++i){
+                NodeId spurNode = last[i]; root.push_back(spurNode);
+                // Spurs before the deviation point were tried from the parent path (Lawler).
+                if(i>=dev.back()){
+                    bannedNext.clear();   // next hops already taken from this exact root
+                    for(auto &p: out) if(p.path.size()>i+1 && std::equal(root.begin(), root.end(), p.path.begin())) bannedNext.push_back(p.path[i+1]);
+                    long long bound = cand.size()>=need ? cand[need-1].route.distance : (long long)SearchWorkspace::INF;
+                    if(rootCost + heuristic(spurNode) < bound){
+                        int spurCost = spurPath(spurNode, dst, bannedNext, bound - rootCost, tail);
+                        if(spurCost!=SearchWorkspace::INF){
+                            Candidate c; c.dev = i; c.route.distance = (int)(rootCost + spurCost);
+                            c.route.path.assign(root.begin(), root.end()-1); c.route.path.insert(c.route.path.end(), tail.begin(), tail.end());
+                            insertCandidate(cand, std::move(c), need);
+                        }
+                    }
+                }
+                rootCost += cheapest(spurNode, last[i+1]);
+                banStamp[spurNode] = banGen;   // later spurs may not revisit the root
+            }
+            if(cand.empty()) break;
+            out.push_back(std::move(cand.front().route)); dev.push_back(cand.front().dev); cand.erase(cand.begin());
+        }
+        return out;
+    }
+
+    bool treeSettled(NodeId u) const { return tree.reached(u) && !tree.heap.contains(u); }
+    int heuristic(NodeId u) const { return treeSettled(u) ? tree.dist[u] : radius; }
+
+    // Dijkstra from dst until src settles; the heap is kept so treeSettled()
+    // can tell settled labels from tentative ones.
+    bool growTree(NodeId src, NodeId dst){
+        tree.reset(graph.nodeCount());
+        tree.label(dst, 0, kInvalidNode); tree.heap.push(dst, 0);
+        while(!tree.heap.empty()){
+            auto top = tree.heap.pop(); settled++;
+            NodeId u = top.node; int d = top.key; radius = d;
+            if(u==src) return true;
+            tree.countArcs(graph.neighbors(u).size());
+            for(const auto &e: graph.neighbors(u)){
+                int nd = d + e.w;
+                if(nd < tree.distance(e.v)){ tree.label(e.v, nd, u); tree.heap.pushOrDecrease(e.v, nd); }
+            }
+        }
+        return false;
+    }
+
+    // u -> dst along tree parents (u must be settled).
+    void treePath(NodeId u, std::vector<NodeId>& out) const {
+        out.clear(); for(NodeId cur=u; cur!=kInvalidNode; cur=tree.parent[cur]) out.push_back(cur);
+    }
+
+    int cheapest(NodeId u, NodeId v) const {
+        int best = SearchWorkspace::INF; for(const auto &e: graph.neighbors(u)) if(e.v==v) best = std::min(best, e.w);
+        return best;
+    }
+
+    static bool contains(const std::vector<NodeId>& v, NodeId x){ return std::find(v.begin(), v.end(), x)!=v.end(); }
+
+    // Cheapest spurNode -> dst path avoiding banned nodes and the banned first
+    // hops, or INF if none costs less than `limit`.
+    int spurPath(NodeId s, NodeId dst, const std::vector<NodeId>& bannedNext, long long limit, std::vector<NodeId>& out){
+        if(treeSettled(s) && !contains(bannedNext, tree.parent[s])){
+            bool clean = true;
+            for(NodeId cur=tree.parent[s]; cur!=kInvalidNode && clean; cur=tree.parent[cur]) clean = banStamp[cur]!=banGen;
+            if(clean){ treePath(s, out); return tree.dist[s]; }
+        }
+        searches++;
+        spur.reset(graph.nodeCount());
+        spur.label(s, 0, kInvalidNode); spur.heap.push(s, heuristic(s));
+        while(!spur.heap.empty()){
+            auto top = spur.heap.pop(); settled++;
+            if(top.key >= limit) return SearchWorkspace::INF;
+            NodeId u = top.node; int d = spur.dist[u];
+            if(u==dst){ spur.extractPath(s, dst, out); return d; }
+            spur.countArcs(graph.neighbors(u).size());
+            for(const auto &e: graph.neighbors(u)){
+                if(banStamp[e.v]==banGen || (u==s && contains(bannedNext, e.v))) continue;
+                int nd = d + e.w;
+                if(nd < spur.distance(e.v)){ spur.label(e.v, nd, u); spur.heap.pushOrDecrease(e.v, nd + heuristic(e.v)); }
+            }
+        }
+        return SearchWorkspace::INF;
+    }
+
+    // Sorted insert without duplicates; anything past `keep` can never be
+    // returned and is dropped.
+    static void insertCandidate(std::vector<Candidate>& cand, Candidate c, std::size_t keep){
+        for(auto &x: cand) if(x.route.distance==c.route.distance && x.route.path==c.route.path) return;
+        auto at = std::upper_bound(cand.begin(), cand.end(), c.route.distance, [](int d, const Candidate& x){ return d < x.route.distance; });
+        cand.insert(at, std::move(c));
+        if(cand.size()>keep) cand.resize(keep);
+    }
+};
@@ -0,0 +1,159 @@
+#pragma once
+#include "graph.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// Live weights for concurrent routing ~170 LOC
+// - Topology and names stay in one frozen base Graph; weights live in
+//   immutable generations (one int per arc), newest published through an
+//   atomic pointer
+// - Writers (the traffic feed) copy the newest generation, apply a batch of
+//   TrafficChange and publish it; writers are serialised among themselves
+//   but never wait for readers
+// - Readers pin a generation without locks: each reader slot announces the
+//   generation it holds (a hazard pointer) and the writer only recycles
+//   generations nobody announces. A pin is one store and two loads, so a
+//   query sees one consistent weight set from start to finish, and at most
+//   readers + 2 generations are ever allocated
+// - Reader::pin() hands back a Graph view bound to the pinned weights, so
+//   dijkstra(), Router, BatchRouter and the JSON writers run on it unchanged
+
+class LiveGraph {
+    struct Generation { std::uint64_t version = 0; std::vector<int> weight; };
+    // Padded so readers on different cores do not share a cache line.
+    struct Slot { std::atomic<const Generation*> pinned{nullptr}; std::atomic<bool> taken{false}; char pad[48]; };
+public:
+    // base must be frozen-ready and outlive this object; it is not written again.
+    // At most maxReaders Reader objects exist at once (0: 2 per hardware thread).
+    explicit LiveGraph(const Graph& base, unsigned maxReaders = 0): g(base) {
+        g.freeze();
+        if(maxReaders==0) maxReaders = std::max(8u, 2*std::thread::hardware_concurrency());
+        slotCount = maxReaders; slots.reset(new Slot[slotCount]);
+        std::unique_ptr<Generation> first(new Generation); first->version = g.weightVersion();
+        first->weight.reserve(g.arcCount());
+        for(NodeId u=0; u<g.nodeCount(); ++u) for(auto e: g.neighbors(u)) first->weight.push_back(e.w);
+        published.store(first->version); current.store(first.get()); pool.push_back(std::move(first));
+    }
+    LiveGraph(const LiveGraph&) = delete;
+    LiveGraph& operator=(const LiveGraph&) = delete;
+
+    const Graph& base() const { return g; }
+    // Newest published version. Read from its own atomic: the generation behind
+    // `current` may already be recycled and rewritten by the time it is read.
+    std::uint64_t version() const { return published.load(); }
+    // Generations allocated so far; at most the number of Readers plus two.
+    std::size_t generationCount() const { std::lock_guard<std::mutex> lk(writer); return pool.size(); }
+
+    // Same contract as Graph::applyUpdates: fills newWeight (-1 if no road
+    // matched) and returns how many changes hit a road. Publishes one new
+    // generation per call, so batch changes where possible.
+    std::size_t publish(std::vector<TrafficChange>& changes){
+        std::lock_guard<std::mutex> lk(writer);
+        Generation* cur = current.load();
+        Generation* next = recycle();
+        next->weight = cur->weight;   // reuses the recycled buffer's capacity
+        std::size_t applied = 0, m = g.edgeCount();
+        int* w = next->weight.data();
+        for(auto &c: changes){
+            c.newWeight = -1;
+            if(c.edge!=kInvalidEdge){
+                if(c.edge>=m) continue;
+                std::uint32_t a = g.edgeArc(c.edge); w[a] = w[g.arcRev(a)] = std::max(1, w[a]+c.delta);
+                c.newWeight = w[a]; applied++;
+            } else if(g.hasNode(c.u) && g.hasNode(c.v)){
+                bool hit = false; std::uint32_t a = g.arcBegin(c.u);
+                for(auto e: g.neighbors(c.u)){
+                    if(e.v==c.v){ w[a] = w[g.arcRev(a)] = std::max(1, w[a]+c.delta); if(!hit) c.newWeight = w[a]; hit = true; }
+                    ++a;
+                }
+                if(hit) applied++;
+            }
+        }
+        next->version = cur->version + 1;
+        current.store(next); published.store(next->version);
+        retired.push_back(cur);
+        return applied;
+    }
+
+    // Per-thread read handle. Owns a Graph view (names are copied once) and a
+    // reclamation slot; pin() is lock-free and allocation-free. Destroy every
+    // Reader before its LiveGraph.
+    class Reader {
+    public:
+        explicit Reader(LiveGraph& live): lg(live), view(live.g.view()) {
+            // Claim a free slot; waits if maxReaders handles already exist.
+            for(;;){
+                for(unsigned i=0; i<lg.slotCount; ++i){ bool f = false; if(lg.slots[i].taken.compare_exchange_strong(f, true)){ slot = &lg.slots[i]; return; } }
+                std::this_thread::yield();
+            }
+        }
+        ~Reader(){ unpin(); slot->taken.store(false); }
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        // Pins the newest generation and returns the view bound to it. The
+        // weights stay valid until unpin(), the next pin() or destruction.
+        const Graph& pin(){
+            // Announce, then confirm it is still current: if so the writer's
+            // next scan sees the announcement and leaves it alone.
+            const Generation* p = lg.current.load();
+            for(;;){ slot->pinned.store(p); const Generation* again = lg.current.load(); if(again==p) break; p = again; }
+            gen = p;
+            view.bindWeights(gen->weight.data(), gen->version);
+            return view;
+        }
+        void unpin(){ slot->pinned.store(nullptr); gen = nullptr; }
+        // The view pin() binds, e.g. to construct a Router once per reader.
+        // Only read through it while pinned.
+        const Graph& graph() const { return view; }
+        std::uint64_t version() const { return gen ? gen->version : 0; }
+
+    private:
+        LiveGraph& lg;
+        Graph view;
+        Slot* slot = nullptr;
+        const Generation* gen = nullptr;
+    };
+
+    // RAII pin for one query.
+    class Pin {
+    public:
+        explicit Pin(Reader& r): reader(r), graph(r.pin()) {}
+        ~Pin(){ reader.unpin(); }
+        Pin(const Pin&) = delete;
+        Pin& operator=(const Pin&) = delete;
+        const Graph& operator*() const { return graph; }
+        const Graph* operator->() const { return &graph; }
+    private:
+        Reader& reader; const Graph& graph;
+    };
+
+private:
+    const Graph& g;
+    std::atomic<Generation*> current{nullptr};
+    std::atomic<std::uint64_t> published{0};   // current's version, set alongside it
+    std::unique_ptr<Slot[]> slots; unsigned slotCount = 0;
+    mutable std::mutex writer;
+    std::vector<std::unique_ptr<Generation>> pool;   // owns every generation
+    std::vector<Generation*> retired, spare;
+    std::vector<const Generation*> pinnedScratch;
+
+    // A retired generation no slot announces. Allocates only when every
+    // retired one is still pinned.
+    Generation* recycle(){
+        pinnedScratch.clear();
+        for(unsigned i=0; i<slotCount; ++i) if(const Generation* p = slots[i].pinned.load()) pinnedScratch.push_back(p);
+        std::size_t keep = 0;
+        for(Generation* r: retired){
+            if(std::find(pinnedScratch.begin(), pinnedScratch.end(), r)==pinnedScratch.end()) spare.push_back(r); else retired[keep++] = r;
+        }
+        retired.resize(keep);
+        if(!spare.empty()){ Generation* s = spare.back(); spare.pop_back(); return s; }
+        pool.emplace_back(new Generation); return pool.back().get();
+    }
+};
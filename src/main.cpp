@@ -2,18 +2,79 @@
 #include "menu.h"
 #include "visualize.h"
 #include "json_exporter.h"
+#include "http_server.h"
+#include "route_service.h"
+#include "traffic_assignment.h"
+#include "city_generator.h"
+#include "node_order.h"
 #include <iostream>
+#include <string>
+#include <thread>
+#include <cstdlib>
 
-int main(){
+// traffic.exe                       interactive menu
+// traffic.exe --serve [port] [host] headless HTTP service (default 127.0.0.1:8080)
+// traffic.exe --assign [demand]     user-equilibrium assignment of an OD file
+//                                   (default data/od_demand.txt) into data/assignment.json
+// traffic.exe --generate KIND NODES [seed] [map] [places]
+//                                   synthetic grid|geometric|scalefree city (default
+//                                   seed 1 into data/synthetic_map.txt + _places.txt)
+// traffic.exe --reorder ORDER ...   the menu, --serve or --assign with nodes renumbered
+//                                   for memory locality (bfs|hilbert|bisection); not
+//                                   --generate, which streams the map without a Graph
+int main(int argc, char** argv){
     using namespace UI;
+    NodeOrdering ordering = NodeOrdering::Input;
+    if(argc>1 && std::string(argv[1])=="--reorder"){
+        if(argc<3 || !parseNodeOrdering(argv[2], ordering)){ std::cout<<RED<<"Usage: --reorder input|bfs|hilbert|bisection [--serve|--assign args]"<<RESET<<"\n"; return 1; }
+        argc -= 2; argv += 2;
+    }
+    if(argc>1 && std::string(argv[1])=="--generate"){
+        if(ordering!=NodeOrdering::Input){ std::cout<<RED<<"--reorder does not apply to --generate; reorder when loading the map instead"<<RESET<<"\n"; return 1; }
+        CitySpec spec;
+        if(argc<4 || !parseCityKind(argv[2], spec.kind)){ std::cout<<RED<<"Usage: --generate grid|geometric|scalefree NODES [seed] [map] [places]"<<RESET<<"\n"; return 1; }
+        spec.nodes = (std::size_t)std::atof(argv[3]); if(argc>4) spec.seed = std::strtoull(argv[4], nullptr, 10);
+        std::string map = argc>5 ? argv[5] : "data/synthetic_map.txt", places = argc>6 ? argv[6] : "data/synthetic_places.txt";
+        if(!writeCityMap(spec, map, places)){ std::cout<<RED<<"Cannot write "<<map<<RESET<<"\n"; return 1; }
+        std::cout<<GREEN<<"Wrote a "<<cityKindName(spec.kind)<<" city of "<<CityGenerator(spec).nodeCount()<<" junctions to "<<map<<" and "<<places<<RESET<<"\n";
+        return 0;
+    }
+    bool serve = argc>1 && std::string(argv[1])=="--serve", assign = argc>1 && std::string(argv[1])=="--assign";
     std::cout<< BLUE << "Loading Smart City graph..." << RESET << "\n";
     Graph g; if(!g.loadFromFile("data/city_map.txt")){ std::cout<<RED<<"Failed to load data/city_map.txt"<<RESET<<"\n"; return 1; }
+    if(!g.loadPlaces("data/places.txt")) std::cout<<YELLOW<<"data/places.txt not found; places will be unnamed."<<RESET<<"\n";
+    if(ordering!=NodeOrdering::Input){
+        Partition cells = reorderNodes(g, ordering);
+        std::cout<<GREEN<<"Nodes in "<<nodeOrderingName(ordering)<<" order; "<<cells.cells()<<" cells cut "<<cells.cutRoads()<<" of "<<g.edgeCount()<<" roads."<<RESET<<"\n";
+    }
+    if(serve){
+        int port = argc>2 ? std::atoi(argv[2]) : 8080; std::string host = argc>3 ? argv[3] : "127.0.0.1";
+        unsigned workers = std::max(2u, std::thread::hardware_concurrency());
+        RouteService service(g, workers);
+        HttpServer server([&service](const HttpRequest& req, HttpResponse& res, unsigned w){ service.handle(req, res, w); }, workers);
+        if(!server.listen(port, host)){ std::cout<<RED<<"Cannot listen on "<<host<<":"<<port<<RESET<<"\n"; return 1; }
+        std::cout<<GREEN<<"Serving web/ and the routing API on http://"<<host<<":"<<server.port()<<"/ ("<<workers<<" workers)"<<RESET<<"\n";
+        server.run();
+        return 0;
+    }
+    if(assign){
+        std::string path = argc>2 ? argv[2] : "data/od_demand.txt";
+        auto demand = loadDemand(g, path);
+        if(demand.empty()){ std::cout<<RED<<"No demand in "<<path<<RESET<<"\n"; return 1; }
+        TrafficAssignment ta(g); AssignmentResult r = ta.solve(demand);
+        std::cout<<(r.converged ? GREEN : YELLOW)<<"Equilibrium after "<<r.iterations<<" iterations, relative gap "<<r.relativeGap
+                 <<", "<<r.totalTime<<" trip-minutes"<<RESET<<"\n";
+        if(r.unassigned>0) std::cout<<YELLOW<<r.unassigned<<" trips had no route."<<RESET<<"\n";
+        if(!writeAssignmentJson(g, r, "data/assignment.json")){ std::cout<<RED<<"Cannot write data/assignment.json"<<RESET<<"\n"; return 1; }
+        std::cout<<GREEN<<"Exported flows to data/assignment.json for the web heatmap."<<RESET<<"\n";
+        return 0;
+    }
     loading("Initializing modules...", 800);
     // Export graph for web UI
     writeGraphJson(g, "data/graph.json");
     std::cout << GREEN << "Exported graph to data/graph.json for web UI." << RESET << "\n";
 
-    Menu menu(g, "data/routes_history.txt");
+    Menu menu(g, "data/routes_history.bin", "data/routes_history.txt");
     while(true){
         std::system("cls"); menu.showMain(); int ch; if(!(std::cin>>ch)) break; if(ch==6){ std::cout<<GREEN<<"Goodbye!"<<RESET<<"\n"; break; }
         switch(ch){
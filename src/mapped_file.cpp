@@ -0,0 +1,2 @@
+#include "mapped_file.h"
+// Header-only; this TU keeps the one-file-per-module build layout.
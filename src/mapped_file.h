@@ -0,0 +1,78 @@
+#pragma once
+#include <string>
+#include <cstddef>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Read-only memory-mapped file ~60 LOC
+// - Whole file mapped at once; pages come in on demand from the OS cache
+// - Empty files open fine with size()==0 and data()==nullptr
+// - Non-copyable; share it through std::shared_ptr
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile(){ close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path){
+        close();
+#if defined(_WIN32)
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if(file==INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER sz; if(!GetFileSizeEx(file, &sz)){ close(); return false; }
+        len = (std::size_t)sz.QuadPart; if(len==0) return true;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if(!mapping){ close(); return false; }
+        ptr = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if(!ptr){ close(); return false; }
+#else
+        fd = ::open(path.c_str(), O_RDONLY); if(fd<0) return false;
+        struct stat st; if(fstat(fd, &st)!=0){ close(); return false; }
+        len = (std::size_t)st.st_size; if(len==0) return true;
+        void* p = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(p==MAP_FAILED){ close(); return false; }
+        ptr = (const char*)p;
+#endif
+        return true;
+    }
+
+    void close(){
+#if defined(_WIN32)
+        if(ptr) UnmapViewOfFile(ptr);
+        if(mapping) CloseHandle(mapping);
+        if(file!=INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr; file = INVALID_HANDLE_VALUE;
+#else
+        if(ptr) munmap((void*)ptr, len);
+        if(fd>=0) ::close(fd);
+        fd = -1;
+#endif
+        ptr = nullptr; len = 0;
+    }
+
+    const char* data() const { return ptr; }
+    std::size_t size() const { return len; }
+
+private:
+    const char* ptr = nullptr;
+    std::size_t len = 0;
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE, mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
@@ -5,18 +5,36 @@
 #include "visualize.h"
 #include "file_manager.h"
 #include "json_exporter.h"
+#include "router.h"
+#include "dynamic_sssp.h"
+#include "time_dependent.h"
+#include "k_shortest.h"
+#include "route_history.h"
 #include <iostream>
 #include <cstdlib>
 
 // Menu ~90 LOC
 // - Top-level navigation
-// - Routing flow
+// - Routing flow (routes found here are tracked and repaired after each
+//   traffic simulation instead of re-searched)
+// - Up to two alternative routes (k shortest loopless paths) next to the best
+// - Time-of-day ETA from profiles built out of the traffic log, extended by
+//   every simulation step; data/traffic_profiles_demo.txt stands in, labelled,
+//   while the log has no timestamped lines
 // - Visualization screen
 
 class Menu{
-    Graph& graph; TrafficSimulator sim; std::string histPath;
+    Graph& graph; TrafficSimulator sim; RouteHistoryWriter histLog; RouteHistory hist; Router router; RouteTracker tracker; TravelTimeProfiles::Builder profileLog; TravelTimeProfiles profiles; bool demoProfiles = false; KShortestPaths alternatives;
 public:
-    Menu(Graph& g, std::string history): graph(g), sim("data/traffic_logs.txt"), histPath(std::move(history)){}
+    // history is the binary route log; legacyText, if given, is imported into
+    // it while the log is still empty.
+    Menu(Graph& g, std::string history, const std::string& legacyText = ""): graph(g), sim("data/traffic_logs.txt"), histLog(std::move(history)), router(g), tracker(g), profileLog(g), alternatives(g){
+        // A log without timestamped lines has no history yet: show the demo
+        // profiles, labelled, until the first simulation step.
+        if(profileLog.addLog("data/traffic_logs.txt")==0) demoProfiles = profileLog.addLog("data/traffic_profiles_demo.txt")>0;
+        profiles = profileLog.build();
+        if(!legacyText.empty() && histLog.recordCount()==0) histLog.importText(legacyText);
+    }
 
     static void cls(){ std::system("cls"); }
 
@@ -34,29 +52,50 @@ public:
     void showGraph(){ loading("Rendering city..."); drawCity(graph, {}); pause(); }
 
     void findRoute(){
-        using namespace UI; char s,d; std::cout<<"Enter source (A-J): "; std::cin>>s; std::cout<<"Enter destination (A-J): "; std::cin>>d; loading("Finding route...");
-        std::vector<char> visit; auto res = dijkstra(graph,s,d,[&](char u,int dist){ visit.push_back(u); }, true);
+        using namespace UI; std::string s,d; std::cout<<"Enter source (A-J): "; std::cin>>s; std::cout<<"Enter destination (A-J): "; std::cin>>d; loading("Finding route...");
+        NodeId src=graph.id(s), dst=graph.id(d);
+        if(!graph.hasNode(src) || !graph.hasNode(dst)){ std::cout<<UI::RED<<"Unknown place."<<UI::RESET<<"\n"; pause(); return; }
+        auto res = tracker.route(src,dst); printDistanceTable(graph, tracker.distances(src));
         if(res.path.empty() || res.distance==std::numeric_limits<int>::max()){ std::cout<<UI::RED<<"No path found."<<UI::RESET<<"\n"; pause(); return; }
-        std::cout<<UI::GREEN<<"Shortest Path: "<<UI::RESET; for(size_t i=0;i<res.path.size();++i){ std::cout<<res.path[i]; if(i+1<res.path.size()) std::cout<<" -> "; }
-        std::cout<<"\nTime: "<<res.distance<<" minutes\n"; drawCity(graph, res.path);
-        std::string route; for(size_t i=0;i<res.path.size();++i){ route.push_back(res.path[i]); if(i+1<res.path.size()) route+="->"; }
-        appendHistory(histPath, route, res.distance); std::cout<<UI::GREEN<<"Saved to history."<<UI::RESET<<"\n";
+        std::cout<<UI::GREEN<<"Shortest Path: "<<UI::RESET; std::cout<<pathString(graph, res.path, " -> ");
+        std::cout<<"\nTime: "<<res.distance<<" minutes\n";
+        // The tracked route leads; on ties Yen may have picked another path first.
+        auto routes = alternatives.route(src,dst,3); routes.erase(std::remove_if(routes.begin(), routes.end(), [&](const PathResult& r){ return r.path==res.path; }), routes.end());
+        routes.insert(routes.begin(), res); if(routes.size()>3) routes.pop_back();
+        for(size_t i=1;i<routes.size();i++) std::cout<<UI::YELLOW<<"Alternative "<<i<<": "<<UI::RESET<<pathString(graph, routes[i].path, " -> ")<<" ("<<routes[i].distance<<" minutes)\n";
+        if(profiles.profiledCount()){ auto td = timeDependentDijkstra(graph, profiles, src, dst, minuteOfDayNow()); if(!td.path.empty()) std::cout<<(demoProfiles ? "Leaving now (demo profiles, not observed traffic): " : "Leaving now (typical traffic): ")<<td.distance<<" minutes via "<<pathString(graph, td.path, " -> ")<<"\n"; }
+        drawCity(graph, res.path); tracker.track(src,dst);
+        histLog.append(pathString(graph, res.path), res.distance); std::cout<<UI::GREEN<<"Saved to history."<<UI::RESET<<"\n";
         // Export route JSON for web UI
-        writeRouteJson(res, "data/route.json");
+        writeRouteJson(graph, routes, "data/route.json");
         std::cout << UI::GREEN << "Exported route to data/route.json for web UI." << UI::RESET << "\n";
         pause();
     }
 
-    void simulate(){ loading("Updating road conditions..."); auto changes = sim.apply(graph, 4); using namespace UI; if(changes.empty()){ std::cout<<RED<<"No edges to update."<<RESET<<"\n"; }
-        else { for(auto &c: changes){ if(c.delta>0) std::cout<<RED<<"Traffic increased on "<<c.u<<"-"<<c.v<<" by "<<c.delta<<" min. New="<<c.newWeight<<RESET<<"\n"; else std::cout<<GREEN<<"Traffic eased on "<<c.u<<"-"<<c.v<<" by "<<-c.delta<<" min. New="<<c.newWeight<<RESET<<"\n"; } }
-        // Re-export graph after simulation
-        writeGraphJson(graph, "data/graph.json");
-        std::cout << UI::GREEN << "Updated data/graph.json for web UI." << UI::RESET << "\n";
+    void simulate(){ loading("Updating road conditions..."); std::uint64_t base = graph.weightVersion(); auto changes = sim.apply(graph, 4); router.noteChanges(changes, base, graph.weightVersion()); if(demoProfiles){ profileLog.clear(); demoProfiles = false; } profileLog.add(changes, minuteOfDayNow()); profiles = profileLog.build(); using namespace UI; if(changes.empty()){ std::cout<<RED<<"No edges to update."<<RESET<<"\n"; }
+        else { for(auto &c: changes){ if(c.delta>0) std::cout<<RED<<"Traffic increased on "<<graph.name(c.u)<<"-"<<graph.name(c.v)<<" by "<<c.delta<<" min. New="<<c.newWeight<<RESET<<"\n"; else std::cout<<GREEN<<"Traffic eased on "<<graph.name(c.u)<<"-"<<graph.name(c.v)<<" by "<<-c.delta<<" min. New="<<c.newWeight<<RESET<<"\n"; }
+            for(auto &r: tracker.update(changes)) if(r.changed){ std::cout<<YELLOW<<"Route "<<graph.name(r.src)<<"->"<<graph.name(r.dst)<<" now ";
+                if(r.distance==SearchWorkspace::INF) std::cout<<"unreachable"; else std::cout<<r.distance<<" min"; std::cout<<RESET<<"\n"; } }
+        // Re-export graph after simulation; open pages patch from the delta
+        writeGraphJson(graph, "data/graph.json"); writeGraphDeltaJson(graph, changes, base, "data/graph_delta.json");
+        std::cout << UI::GREEN << "Updated data/graph.json and data/graph_delta.json for web UI." << UI::RESET << "\n";
         pause(); }
 
-    void history(){ auto lines=readHistory(histPath); if(lines.empty()) std::cout<<"No history yet.\n"; else { std::cout<<"Past Routes:\n"; for(auto &s: lines) std::cout<<"- "<<s<<"\n"; } pause(); }
+    void history(){
+        histLog.flush(); bool ok = hist.size() ? hist.refresh() : hist.open(histLog.path());
+        if(!ok || hist.size()==0){ std::cout<<"No history yet.\n"; pause(); return; }
+        std::cout<<"Recent Routes:\n";
+        for(std::size_t i=hist.size()>10 ? hist.size()-10 : 0; i<hist.size(); ++i){ auto r=hist.record(i); std::cout<<"- "<<formatTimestamp(r.time)<<" | "<<hist.route(r.route)<<" | "<<r.minutes<<" min\n"; }
+        std::int64_t weekAgo = nowEpochSeconds() - 7*24*3600; std::string o, d;
+        std::cout<<UI::GREEN<<"\nMost travelled routes (last 7 days):"<<UI::RESET<<"\n";
+        for(auto &t: hist.topRoutes(5, weekAgo)){
+            routeEnds(hist.route(t.route), o, d); TripStats all = hist.odStats(o, d, weekAgo);
+            std::cout<<"- "<<hist.route(t.route)<<": "<<t.stats.trips<<" trips, avg "<<t.stats.average()<<" min ("<<o<<"->"<<d<<" by any route: avg "<<all.average()<<" min)\n";
+        }
+        pause();
+    }
 
-    void visualize(){ char s,d; std::cout<<"Enter source (A-J): "; std::cin>>s; std::cout<<"Enter destination (A-J): "; std::cin>>d; loading("Visualizing..."); auto res=dijkstra(graph,s,d,nullptr,false); drawCity(graph, res.path); pause(); }
+    void visualize(){ std::string s,d; std::cout<<"Enter source (A-J): "; std::cin>>s; std::cout<<"Enter destination (A-J): "; std::cin>>d; loading("Visualizing..."); auto res=router.route(s,d,SearchMode::AStar); drawCity(graph, res.path); pause(); }
 
     static void pause(){ std::cout<<"\nPress Enter to continue..."; std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); std::cin.get(); }
 };
@@ -0,0 +1,2 @@
+#include "metrics.h"
+// Header-only; this TU keeps the one-file-per-module build layout.
@@ -0,0 +1,200 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+// Metrics ~190 LOC
+// - Search counters: each IndexedDaryHeap counts pushes, decrease-keys and
+//   pops, and the query loops add the arcs they scan, as plain ints in the
+//   per-thread workspace. Pops are settled nodes: the indexed heap never
+//   holds a stale entry, so there are no stale pops to count
+// - A process-wide registry collects per-query counter totals per search kind,
+//   a settled-nodes-per-query histogram, latency histograms for load, route,
+//   simulate, export and assign, and route cache event counts. It is sharded
+//   over cache-line-sized slots of relaxed atomics, so recording threads do
+//   not contend
+// - Histograms use log2 buckets (1 us .. 2^26 us). Snapshots render as
+//   Prometheus text here and as JSON in json_exporter.h
+// - Build with -DTRAFFIC_METRICS=0 and every counter and timer is dead code
+
+#ifndef TRAFFIC_METRICS
+#define TRAFFIC_METRICS 1
+#endif
+constexpr bool kMetricsEnabled = TRAFFIC_METRICS != 0;
+
+// Work done by one search (or a sum of searches).
+struct SearchCounters {
+    std::uint64_t settled = 0, relaxed = 0, pushes = 0, decreases = 0;   // relaxed: arcs scanned from settled nodes
+    SearchCounters& operator+=(const SearchCounters& o){ settled+=o.settled; relaxed+=o.relaxed; pushes+=o.pushes; decreases+=o.decreases; return *this; }
+    SearchCounters operator+(const SearchCounters& o) const { SearchCounters r = *this; return r += o; }
+    SearchCounters operator-(const SearchCounters& o) const { return {settled-o.settled, relaxed-o.relaxed, pushes-o.pushes, decreases-o.decreases}; }
+};
+
+// Indices follow SearchMode, then the k-shortest search.
+enum MetricSearch : unsigned { kSearchDijkstra, kSearchBidirectional, kSearchAStar, kSearchAlternatives, kSearchKinds };
+enum MetricTimer : unsigned { kTimeLoad, kTimeRoute, kTimeSimulate, kTimeExport, kTimeAssign, kTimers };
+enum MetricCache : unsigned { kCacheHit, kCacheMiss, kCacheEvict, kCacheDrop, kCacheKeep, kCacheEvents };   // route_cache.h
+
+inline const char* metricSearchName(unsigned k){
+    static const char* names[kSearchKinds] = {"dijkstra", "bidirectional", "astar", "alternatives"}; return names[k];
+}
+inline const char* metricTimerName(unsigned t){
+    static const char* names[kTimers] = {"load", "route", "simulate", "export", "assign"}; return names[t];
+}
+inline const char* metricCacheName(unsigned c){
+    static const char* names[kCacheEvents] = {"hit", "miss", "evict", "invalidate", "carry"}; return names[c];
+}
+
+// Bucket 0 counts values up to 1, bucket i values in (2^(i-1), 2^i], the
+// last one everything larger (upper bounds are inclusive, as in Prometheus).
+struct HistogramSnapshot {
+    enum : unsigned { kBuckets = 28 };
+    std::uint64_t count = 0; double sum = 0; std::uint64_t bucket[kBuckets] = {};
+
+    static double upperBound(unsigned i){ return i+1<kBuckets ? std::ldexp(1.0, (int)i) : std::numeric_limits<double>::infinity(); }
+    double mean() const { return count ? sum/count : 0.0; }
+    // Upper bound of the bucket holding the q-quantile (q in [0, 1]); 0 if empty.
+    double quantile(double q) const {
+        if(!count) return 0;
+        std::uint64_t rank = (std::uint64_t)std::ceil(q*count), seen = 0; if(rank==0) rank = 1;
+        for(unsigned i=0; i<kBuckets; ++i){ seen += bucket[i]; if(seen>=rank) return i+1<kBuckets ? upperBound(i) : upperBound(i-1); }
+        return upperBound(kBuckets-2);
+    }
+};
+
+struct MetricsSnapshot {
+    HistogramSnapshot latencyUs[kTimers];
+    std::uint64_t queries[kSearchKinds] = {}; SearchCounters search[kSearchKinds];
+    HistogramSnapshot settled;   // settled nodes per query, all kinds
+    std::uint64_t cache[kCacheEvents] = {};   // route cache events
+    double cacheHitRate() const { return cache[kCacheHit]+cache[kCacheMiss] ? (double)cache[kCacheHit]/(cache[kCacheHit]+cache[kCacheMiss]) : 0.0; }
+};
+
+class Metrics {
+public:
+    enum : unsigned { kShards = 16 };
+
+    static Metrics& global(){ static Metrics m; return m; }
+
+    void time(MetricTimer t, double us){ if(kMetricsEnabled) shard().latency[t].add(us); }
+    void search(unsigned kind, const SearchCounters& c){
+        if(!kMetricsEnabled) return;
+        Shard& s = shard(); const std::memory_order r = std::memory_order_relaxed;
+        s.queries[kind].fetch_add(1, r);
+        s.counters[kind][0].fetch_add(c.settled, r); s.counters[kind][1].fetch_add(c.relaxed, r);
+        s.counters[kind][2].fetch_add(c.pushes, r); s.counters[kind][3].fetch_add(c.decreases, r);
+        s.settled.add((double)c.settled);
+    }
+
+    void cache(MetricCache event, std::uint64_t n = 1){ if(kMetricsEnabled && n) shard().cache[event].fetch_add(n, std::memory_order_relaxed); }
+
+    // Sums the shards; concurrent recording may land on either side of it.
+    MetricsSnapshot snapshot() const {
+        MetricsSnapshot out;
+        for(const Shard& s: shards){
+            for(unsigned t=0; t<kTimers; ++t) s.latency[t].addTo(out.latencyUs[t]);
+            for(unsigned k=0; k<kSearchKinds; ++k){
+                out.queries[k] += s.queries[k].load(std::memory_order_relaxed);
+                SearchCounters c{s.counters[k][0].load(std::memory_order_relaxed), s.counters[k][1].load(std::memory_order_relaxed),
+                                 s.counters[k][2].load(std::memory_order_relaxed), s.counters[k][3].load(std::memory_order_relaxed)};
+                out.search[k] += c;
+            }
+            s.settled.addTo(out.settled);
+            for(unsigned c=0; c<kCacheEvents; ++c) out.cache[c] += s.cache[c].load(std::memory_order_relaxed);
+        }
+        return out;
+    }
+
+    void reset(){
+        for(Shard& s: shards){
+            for(auto &h: s.latency) h.clear();
+            for(auto &q: s.queries) q.store(0, std::memory_order_relaxed);
+            for(auto &row: s.counters) for(auto &c: row) c.store(0, std::memory_order_relaxed);
+            s.settled.clear();
+            for(auto &c: s.cache) c.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct Histogram {
+        std::atomic<std::uint64_t> count{0}, sumMilli{0}, bucket[HistogramSnapshot::kBuckets] = {};
+        void add(double v){
+            const std::memory_order r = std::memory_order_relaxed;
+            unsigned i = 0; for(std::uint64_t x = v<=1 ? 0 : (std::uint64_t)std::ceil(std::min(v, 1e18)) - 1; x && i+1<HistogramSnapshot::kBuckets; x >>= 1) i++;
+            bucket[i].fetch_add(1, r); count.fetch_add(1, r); sumMilli.fetch_add((std::uint64_t)(v*1000), r);
+        }
+        void addTo(HistogramSnapshot& h) const {
+            h.count += count.load(std::memory_order_relaxed); h.sum += sumMilli.load(std::memory_order_relaxed)/1000.0;
+            for(unsigned i=0; i<HistogramSnapshot::kBuckets; ++i) h.bucket[i] += bucket[i].load(std::memory_order_relaxed);
+        }
+        void clear(){ count.store(0); sumMilli.store(0); for(auto &b: bucket) b.store(0); }
+    };
+    struct alignas(64) Shard {
+        Histogram latency[kTimers];
+        std::atomic<std::uint64_t> queries[kSearchKinds] = {}, counters[kSearchKinds][4] = {};
+        Histogram settled;
+        std::atomic<std::uint64_t> cache[kCacheEvents] = {};
+    };
+    Shard shards[kShards];
+
+    Shard& shard(){
+        static std::atomic<unsigned> next{0};
+        thread_local unsigned mine = next.fetch_add(1, std::memory_order_relaxed) % kShards;
+        return shards[mine];
+    }
+};
+
+// Records the lifetime of the scope under one timer.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(MetricTimer t): timer(t) { if(kMetricsEnabled) start = std::chrono::steady_clock::now(); }
+    ~ScopedTimer(){
+        if(kMetricsEnabled) Metrics::global().time(timer, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+private:
+    MetricTimer timer; std::chrono::steady_clock::time_point start;
+};
+
+// Prometheus text exposition format 0.0.4.
+inline std::string prometheusText(const MetricsSnapshot& s){
+    std::string out; char line[160];
+    auto histogram = [&](const char* name, const char* label, const char* value, const HistogramSnapshot& h, double scale){
+        std::uint64_t cum = 0;
+        for(unsigned i=0; i<HistogramSnapshot::kBuckets; ++i){
+            cum += h.bucket[i];
+            if(i+1<HistogramSnapshot::kBuckets) std::snprintf(line, sizeof(line), "%s_bucket{%s=\"%s\",le=\"%g\"} %llu\n", name, label, value, HistogramSnapshot::upperBound(i)*scale, (unsigned long long)cum);
+            else std::snprintf(line, sizeof(line), "%s_bucket{%s=\"%s\",le=\"+Inf\"} %llu\n", name, label, value, (unsigned long long)cum);
+            out += line;
+        }
+        std::snprintf(line, sizeof(line), "%s_sum{%s=\"%s\"} %.9g\n%s_count{%s=\"%s\"} %llu\n", name, label, value, h.sum*scale, name, label, value, (unsigned long long)h.count);
+        out += line;
+    };
+    out += "# HELP traffic_latency_seconds Wall time of graph loads, routes, simulator steps, exports and assignments.\n# TYPE traffic_latency_seconds histogram\n";
+    for(unsigned t=0; t<kTimers; ++t) histogram("traffic_latency_seconds", "op", metricTimerName(t), s.latencyUs[t], 1e-6);
+    struct { const char* name; const char* help; } counters[] = {
+        {"traffic_search_queries_total", "Route queries."}, {"traffic_search_settled_nodes_total", "Nodes settled by route queries."},
+        {"traffic_search_relaxed_arcs_total", "Arcs scanned by route queries."}, {"traffic_search_heap_pushes_total", "Heap inserts by route queries."},
+        {"traffic_search_heap_decreases_total", "Heap decrease-keys by route queries."}};
+    for(unsigned c=0; c<5; ++c){
+        out += "# HELP "; out += counters[c].name; out += ' '; out += counters[c].help; out += "\n# TYPE "; out += counters[c].name; out += " counter\n";
+        for(unsigned k=0; k<kSearchKinds; ++k){
+            const SearchCounters& sc = s.search[k];
+            std::uint64_t v = c==0 ? s.queries[k] : c==1 ? sc.settled : c==2 ? sc.relaxed : c==3 ? sc.pushes : sc.decreases;
+            std::snprintf(line, sizeof(line), "%s{search=\"%s\"} %llu\n", counters[c].name, metricSearchName(k), (unsigned long long)v); out += line;
+        }
+    }
+    out += "# HELP traffic_search_settled_nodes Nodes settled per route query.\n# TYPE traffic_search_settled_nodes histogram\n";
+    histogram("traffic_search_settled_nodes", "search", "all", s.settled, 1.0);
+    out += "# HELP traffic_route_cache_events_total Route cache lookups, evictions and invalidation outcomes.\n# TYPE traffic_route_cache_events_total counter\n";
+    for(unsigned c=0; c<kCacheEvents; ++c){
+        std::snprintf(line, sizeof(line), "traffic_route_cache_events_total{event=\"%s\"} %llu\n", metricCacheName(c), (unsigned long long)s.cache[c]); out += line;
+    }
+    return out;
+}
@@ -0,0 +1,2 @@
+#include "node_order.h"
+// Header-only; this TU keeps the one-file-per-module build layout.
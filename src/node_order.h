@@ -0,0 +1,167 @@
+#pragma once
+#include "graph.h"
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cstdint>
+
+// Node ordering and partitioning ~200 LOC
+// - Load-time renumbering for memory locality: IDs in file order scatter a
+//   search's reads over the whole CSR, ordered IDs keep a neighbourhood in a
+//   few cache lines and pages. Apply with Graph::renumber (reorderNodes)
+// - Bfs: breadth-first from a pseudo-peripheral node (Cuthill-McKee without
+//   the degree sort), one component after another
+// - Hilbert: Hilbert-curve index of lat/lng on a 2^16 x 2^16 grid over the
+//   bounding box; graphs without coordinates fall back to Bfs
+// - Bisection: recursive bisection, split across the longer side of the
+//   part's bounding box with coordinates, else at the middle of a BFS order
+//   inside the part; parts are halved down to kLeaf-node leaves
+// - Every ordering comes with a Partition into cells of contiguous IDs (the
+//   bisection's own parts, or equal slices of the order) and the number of
+//   roads it cuts, so parallel code can group work by region
+
+enum class NodeOrdering { Input, Bfs, Hilbert, Bisection };
+
+inline const char* nodeOrderingName(NodeOrdering o){
+    return o==NodeOrdering::Input ? "input" : o==NodeOrdering::Bfs ? "bfs" : o==NodeOrdering::Hilbert ? "hilbert" : "bisection";
+}
+inline bool parseNodeOrdering(const std::string& s, NodeOrdering& out){
+    if(s=="input") out = NodeOrdering::Input;
+    else if(s=="bfs") out = NodeOrdering::Bfs;
+    else if(s=="hilbert") out = NodeOrdering::Hilbert;
+    else if(s=="bisection") out = NodeOrdering::Bisection;
+    else return false;
+    return true;
+}
+
+// Cells of nodes with contiguous IDs: cell k holds [begin(k), end(k)).
+class Partition {
+public:
+    Partition() = default;
+    // starts: each cell's first ID, ascending from 0. Cut roads are counted on g.
+    Partition(const Graph& g, std::vector<NodeId> starts): start(std::move(starts)), cell(g.nodeCount()) {
+        start.push_back((NodeId)g.nodeCount());
+        for(std::uint32_t k=0; k+1<start.size(); ++k) std::fill(cell.begin()+start[k], cell.begin()+start[k+1], k);
+        for(EdgeId e=0; e<g.edgeCount(); ++e) if(cell[g.edgeSource(e)]!=cell[g.edgeTarget(e)]) cut++;
+    }
+
+    std::size_t cells() const { return start.empty() ? 0 : start.size()-1; }
+    NodeId begin(std::uint32_t k) const { return start[k]; }
+    NodeId end(std::uint32_t k) const { return start[k+1]; }
+    std::uint32_t cellOf(NodeId u) const { return cell[u]; }
+    std::size_t nodeCount() const { return cell.size(); }
+    std::size_t cutRoads() const { return cut; }   // roads whose ends lie in different cells
+
+private:
+    std::vector<NodeId> start; std::vector<std::uint32_t> cell; std::size_t cut = 0;
+};
+
+// newId[u] is node u's position in the order (as Graph::renumber takes it);
+// cellStarts holds each cell's first position.
+struct NodeOrder { std::vector<NodeId> newId, cellStarts; };
+
+class NodeOrderer {
+public:
+    enum : unsigned { kLeaf = 32 };
+
+    explicit NodeOrderer(const Graph& graph): g(graph), part(graph.nodeCount(), 0), seen(graph.nodeCount(), 0) {
+        g.freeze();
+        if(!g.allCoords()) return;
+        double lo = g.lat(0), hi = g.lat(0);
+        for(NodeId u=0; u<g.nodeCount(); ++u){ lo = std::min(lo, g.lat(u)); hi = std::max(hi, g.lat(u)); }
+        double kx = std::cos((lo+hi)/2 * 3.14159265358979323846/180);   // equal-area enough at city scale
+        x.resize(g.nodeCount()); y.resize(g.nodeCount());
+        for(NodeId u=0; u<g.nodeCount(); ++u){ x[u] = g.lng(u)*kx; y[u] = g.lat(u); }
+    }
+
+    // The order plus `cells` cells (at most one per node).
+    NodeOrder order(NodeOrdering how, unsigned cells = 64){
+        std::size_t n = g.nodeCount(); NodeOrder out;
+        if(n==0) return out;
+        cells = (unsigned)std::max<std::size_t>(1, std::min<std::size_t>(cells, n));
+        if(how==NodeOrdering::Hilbert && x.empty()) how = NodeOrdering::Bfs;
+        std::vector<NodeId> seq(n); std::iota(seq.begin(), seq.end(), 0);   // seq[i]: the node placed at i
+        if(how==NodeOrdering::Bfs) bfsOrder(seq.data(), seq.data()+n);
+        else if(how==NodeOrdering::Hilbert) hilbertOrder(seq);
+        else if(how==NodeOrdering::Bisection) bisect(seq.data(), seq.data()+n, cells, seq.data(), out.cellStarts);
+        if(how!=NodeOrdering::Bisection) for(unsigned k=0; k<cells; ++k) out.cellStarts.push_back((NodeId)(k*n/cells));
+        out.newId.resize(n); for(std::size_t i=0; i<n; ++i) out.newId[seq[i]] = (NodeId)i;
+        return out;
+    }
+
+private:
+    const Graph& g;
+    std::vector<std::uint32_t> part, seen; std::uint32_t stamp = 0, partMark = 0, seenMark = 0;   // stamps: nothing to clear between parts
+    std::vector<double> x, y;   // projected coordinates, if every node has them
+
+    // Appends the nodes of the current part reachable from s, in BFS order.
+    void bfs(NodeId s, std::vector<NodeId>& out){
+        std::size_t head = out.size(); out.push_back(s); seen[s] = seenMark;
+        while(head<out.size()){
+            NodeId u = out[head++];
+            for(auto e: g.neighbors(u)) if(part[e.v]==partMark && seen[e.v]!=seenMark){ seen[e.v] = seenMark; out.push_back(e.v); }
+        }
+    }
+
+    // Rewrites [first, last) in BFS order over the roads inside it. Each
+    // component starts from the last node a BFS from its first member reaches,
+    // so the levels run across the part rather than out from its middle.
+    void bfsOrder(NodeId* first, NodeId* last){
+        partMark = ++stamp; for(NodeId* p=first; p!=last; ++p) part[*p] = partMark;
+        std::vector<NodeId> out, sweep; out.reserve(last-first);
+        std::uint32_t placed = ++stamp;
+        for(NodeId* p=first; p!=last; ++p){
+            if(seen[*p]==placed) continue;
+            sweep.clear(); seenMark = ++stamp; bfs(*p, sweep);
+            seenMark = placed; bfs(sweep.back(), out);
+        }
+        std::copy(out.begin(), out.end(), first);
+    }
+
+    // Position on the order-16 Hilbert curve (the classic xy2d).
+    static std::uint64_t hilbert(std::uint32_t hx, std::uint32_t hy){
+        const std::uint32_t n = 1u << 16; std::uint64_t d = 0;
+        for(std::uint32_t s=n/2; s>0; s/=2){
+            std::uint32_t rx = (hx & s) ? 1 : 0, ry = (hy & s) ? 1 : 0;
+            d += (std::uint64_t)s*s*((3*rx) ^ ry);
+            if(ry==0){ if(rx==1){ hx = n-1-hx; hy = n-1-hy; } std::swap(hx, hy); }
+        }
+        return d;
+    }
+
+    void hilbertOrder(std::vector<NodeId>& seq){
+        double x0 = *std::min_element(x.begin(), x.end()), y0 = *std::min_element(y.begin(), y.end());
+        double span = std::max(*std::max_element(x.begin(), x.end())-x0, *std::max_element(y.begin(), y.end())-y0);
+        double scale = span>0 ? 65535/span : 0;
+        std::vector<std::uint64_t> key(seq.size());
+        for(NodeId u=0; u<seq.size(); ++u) key[u] = hilbert((std::uint32_t)((x[u]-x0)*scale), (std::uint32_t)((y[u]-y0)*scale));
+        std::sort(seq.begin(), seq.end(), [&](NodeId a, NodeId b){ return key[a]!=key[b] ? key[a]<key[b] : a<b; });
+    }
+
+    // Splits [first, last) into `parts` cells, recording where each starts,
+    // then keeps halving every cell down to kLeaf nodes for the order inside.
+    void bisect(NodeId* first, NodeId* last, unsigned parts, NodeId* base, std::vector<NodeId>& starts){
+        std::size_t n = last-first;
+        if(parts==1){ starts.push_back((NodeId)(first-base)); parts = 0; }
+        if(parts==0 && n<=kLeaf) return;
+        unsigned left = parts ? parts/2 : 0;
+        NodeId* mid = first + (parts ? n*left/parts : n/2);
+        if(!x.empty()){
+            double x0 = x[*first], x1 = x0, y0 = y[*first], y1 = y0;
+            for(NodeId* p=first; p!=last; ++p){ x0 = std::min(x0, x[*p]); x1 = std::max(x1, x[*p]); y0 = std::min(y0, y[*p]); y1 = std::max(y1, y[*p]); }
+            const std::vector<double>& c = x1-x0 >= y1-y0 ? x : y;
+            std::nth_element(first, mid, last, [&](NodeId a, NodeId b){ return c[a]!=c[b] ? c[a]<c[b] : a<b; });
+        } else bfsOrder(first, last);
+        bisect(first, mid, left, base, starts);
+        bisect(mid, last, parts ? parts-left : 0, base, starts);
+    }
+};
+
+// Renumbers g in the given order and returns its partition in the new IDs.
+inline Partition reorderNodes(Graph& g, NodeOrdering how, unsigned cells = 64){
+    NodeOrder o = NodeOrderer(g).order(how, cells);
+    g.renumber(o.newId);
+    return Partition(g, std::move(o.cellStarts));
+}
@@ -0,0 +1,2 @@
+#include "route_cache.h"
+// Header-only; this TU keeps the one-file-per-module build layout.
@@ -0,0 +1,181 @@
+#pragma once
+#include "graph.h"
+#include "dijkstra.h"
+#include "metrics.h"
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+
+// Route cache ~190 LOC
+// - Shortest routes keyed by (src, dst), each valid for one weight version;
+//   a lookup on any other version misses. Bounded, with CLOCK eviction per
+//   shard; shards are picked by key hash, each behind its own mutex
+// - invalidate() carries entries across one batch of TrafficChanges instead
+//   of flushing: a route is dropped only if it uses a changed road, or if a
+//   road that got cheaper could now undercut it. The second test is a lower
+//   bound: the new weight plus straight-line bounds from src to the road and
+//   from the road to dst at the fewest minutes per km any road allows
+//   (0 without coordinates, where any cheaper road below the route's cost
+//   drops it)
+// - Hits, misses, evictions, drops and carries go to metrics.h
+// Routes found by any search mode are interchangeable: only exact shortest
+// distances are cached.
+
+class RouteCache {
+public:
+    enum : unsigned { kShards = 16 };
+    struct Stats {
+        std::uint64_t hits = 0, misses = 0, evictions = 0, dropped = 0, carried = 0; std::size_t size = 0;
+        double hitRate() const { return hits+misses ? (double)hits/(hits+misses) : 0.0; }
+    };
+
+    // capacity: routes kept in total (split evenly over the shards).
+    explicit RouteCache(const Graph& g, std::size_t capacity = 4096): perShard(std::max<std::size_t>(1, (capacity + kShards - 1) / kShards)) {
+        refreshLayout(g);
+    }
+
+    // The route for (src, dst) at weight version `version`, if cached.
+    bool lookup(NodeId src, NodeId dst, std::uint64_t version, PathResult& out){
+        Shard& s = shard(key(src, dst)); std::lock_guard<std::mutex> lk(s.mutex);
+        auto it = s.index.find(key(src, dst));
+        if(it==s.index.end() || s.slots[it->second].version!=version){ s.stats.misses++; Metrics::global().cache(kCacheMiss); return false; }
+        Slot& e = s.slots[it->second]; e.used = true; out = e.route;
+        s.stats.hits++; Metrics::global().cache(kCacheHit); return true;
+    }
+
+    // Stores a route found at `version`; unreachable results are not cached
+    // and an entry for a newer version is never replaced by an older one.
+    void insert(NodeId src, NodeId dst, std::uint64_t version, const PathResult& route){
+        if(route.path.empty() || route.distance==SearchWorkspace::INF) return;
+        std::uint64_t k = key(src, dst); Shard& s = shard(k); std::lock_guard<std::mutex> lk(s.mutex);
+        auto it = s.index.find(k);
+        if(it!=s.index.end()){ Slot& e = s.slots[it->second]; if(e.version<=version){ e.version = version; e.route = route; e.used = true; } return; }
+        std::uint32_t i;
+        if(!s.free.empty()){ i = s.free.back(); s.free.pop_back(); }
+        else if(s.slots.size()<perShard){ i = (std::uint32_t)s.slots.size(); s.slots.emplace_back(); }
+        else {   // CLOCK: the first slot not used since the hand last passed it
+            while(s.slots[s.hand].used){ s.slots[s.hand].used = false; s.hand = (s.hand+1) % (std::uint32_t)s.slots.size(); }
+            i = s.hand; s.hand = (s.hand+1) % (std::uint32_t)s.slots.size();
+            s.index.erase(s.slots[i].key); s.stats.evictions++; Metrics::global().cache(kCacheEvict);
+        }
+        Slot& e = s.slots[i]; e.key = k; e.version = version; e.route = route; e.used = true; e.live = true;
+        s.index[k] = i;
+    }
+
+    // `changes` took g from weight version `from` to g.weightVersion() (as
+    // from TrafficSimulator::apply). Entries still valid move to the new
+    // version, the rest are dropped, as is anything cached at neither version.
+    // Returns the number of routes dropped. If g's layout moved (renumber,
+    // rebuild, new places) every entry is dropped: its node IDs are stale.
+    std::size_t invalidate(const Graph& g, const std::vector<TrafficChange>& changes, std::uint64_t from){
+        std::lock_guard<std::mutex> lk(invalidateMutex);
+        if(g.layoutVersion()!=layout){
+            std::size_t n = stats().size; clear(); refreshLayout(g);
+            Metrics::global().cache(kCacheDrop, n); return n;
+        }
+        std::uint64_t to = g.weightVersion();
+        std::unordered_set<std::uint64_t> roads; std::vector<Cheaper> cheaper;
+        for(auto &c: changes){
+            if(c.newWeight<0 || !g.hasNode(c.u) || !g.hasNode(c.v)) continue;
+            roads.insert(key(std::min(c.u, c.v), std::max(c.u, c.v)));
+            if(c.delta<0) cheaper.push_back({c.u, c.v, c.newWeight});
+        }
+        refreshBound(g, from, cheaper);
+        std::size_t dropped = 0, carried = 0;
+        for(Shard& s: shards){
+            std::lock_guard<std::mutex> lk(s.mutex);
+            for(std::uint32_t i=0; i<s.slots.size(); ++i){
+                Slot& e = s.slots[i]; if(!e.live || e.version==to) continue;   // already found on the new weights
+                if(e.version!=from || usesRoad(e.route.path, roads) || undercut(e, cheaper)){
+                    e.live = false; e.used = false; e.route = PathResult(); s.index.erase(e.key); s.free.push_back(i);
+                    s.stats.dropped++; dropped++;
+                } else { e.version = to; s.stats.carried++; carried++; }
+            }
+        }
+        Metrics::global().cache(kCacheDrop, dropped); Metrics::global().cache(kCacheKeep, carried);
+        return dropped;
+    }
+
+    void clear(){
+        for(Shard& s: shards){ std::lock_guard<std::mutex> lk(s.mutex); s.slots.clear(); s.index.clear(); s.free.clear(); s.hand = 0; }
+    }
+
+    Stats stats() const {
+        Stats t;
+        for(const Shard& s: shards){
+            std::lock_guard<std::mutex> lk(s.mutex);
+            t.hits += s.stats.hits; t.misses += s.stats.misses; t.evictions += s.stats.evictions;
+            t.dropped += s.stats.dropped; t.carried += s.stats.carried; t.size += s.index.size();
+        }
+        return t;
+    }
+
+private:
+    struct Slot { std::uint64_t key = 0, version = 0; PathResult route; bool used = false, live = false; };
+    struct Shard {
+        mutable std::mutex mutex;
+        std::vector<Slot> slots; std::unordered_map<std::uint64_t, std::uint32_t> index;
+        std::vector<std::uint32_t> free; std::uint32_t hand = 0; Stats stats;
+    };
+    struct Cheaper { NodeId a, b; int weight; };
+
+    std::size_t perShard;
+    Shard shards[kShards];
+    std::mutex invalidateMutex;   // one invalidate() at a time; guards the bound below
+    bool useBound = false; double minutesPerKm = 0; std::uint64_t boundVersion = ~0ull;
+    std::vector<double> xyz;   // unit-sphere points scaled to km, as in Router
+    std::uint64_t layout = 0;   // Graph::layoutVersion() xyz was built for
+
+    void refreshLayout(const Graph& g){
+        layout = g.layoutVersion(); useBound = g.allCoords(); boundVersion = ~0ull; xyz.clear();
+        if(useBound){ xyz.resize(3*g.nodeCount()); for(NodeId u=0; u<g.nodeCount(); ++u) toXyz(g.lat(u), g.lng(u), &xyz[3*u]); }
+    }
+
+    static std::uint64_t key(NodeId a, NodeId b){ return ((std::uint64_t)a << 32) | b; }
+    Shard& shard(std::uint64_t k){ k ^= k >> 33; k *= 0xff51afd7ed558ccdull; k ^= k >> 33; return shards[k & (kShards-1)]; }
+
+    static void toXyz(double lat, double lng, double* p){
+        const double R = 6371.0, rad = 3.14159265358979323846/180;
+        p[0] = R*std::cos(lat*rad)*std::cos(lng*rad); p[1] = R*std::cos(lat*rad)*std::sin(lng*rad); p[2] = R*std::sin(lat*rad);
+    }
+    double chordKm(NodeId a, NodeId b) const {
+        const double *p = &xyz[3*a], *q = &xyz[3*b];
+        return std::sqrt((p[0]-q[0])*(p[0]-q[0]) + (p[1]-q[1])*(p[1]-q[1]) + (p[2]-q[2])*(p[2]-q[2]));
+    }
+
+    // minutesPerKm must stay <= weight / chord for every road. Lowering it for
+    // the cheaper roads keeps that across a batch; if weights moved some other
+    // way since the last batch, it is measured again.
+    void refreshBound(const Graph& g, std::uint64_t from, const std::vector<Cheaper>& cheaper){
+        if(!useBound) return;
+        if(boundVersion!=from){
+            minutesPerKm = std::numeric_limits<double>::infinity();
+            for(EdgeId e=0; e<g.edgeCount(); ++e){ double km = chordKm(g.edgeSource(e), g.edgeTarget(e)); if(km>0) minutesPerKm = std::min(minutesPerKm, g.edgeWeight(e)/km); }
+        } else {
+            for(auto &c: cheaper){ double km = chordKm(c.a, c.b); if(km>0) minutesPerKm = std::min(minutesPerKm, c.weight/km); }
+        }
+        if(!std::isfinite(minutesPerKm)) minutesPerKm = 0;
+        boundVersion = g.weightVersion();
+    }
+
+    static bool usesRoad(const std::vector<NodeId>& path, const std::unordered_set<std::uint64_t>& roads){
+        if(roads.empty()) return false;
+        for(std::size_t i=0; i+1<path.size(); ++i) if(roads.count(key(std::min(path[i], path[i+1]), std::max(path[i], path[i+1])))) return true;
+        return false;
+    }
+
+    // Could a route over one of the cheaper roads cost less than this one?
+    bool undercut(const Slot& e, const std::vector<Cheaper>& cheaper) const {
+        NodeId s = e.route.path.front(), t = e.route.path.back(); double d = e.route.distance;
+        for(auto &c: cheaper){
+            double via = c.weight;
+            if(useBound) via += minutesPerKm * std::min(chordKm(s, c.a) + chordKm(c.b, t), chordKm(s, c.b) + chordKm(c.a, t)) * (1 - 1e-9);
+            if(via < d) return true;
+        }
+        return false;
+    }
+};
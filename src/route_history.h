@@ -0,0 +1,220 @@
+#pragma once
+#include "file_manager.h"
+#include "mapped_file.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <limits>
+
+// Route history store ~220 LOC
+// - Log file: 16-byte header, then fixed 16-byte records {epoch seconds,
+//   route id, minutes}; native endianness, append-only. A torn last record is
+//   ignored by readers and overwritten by the next writer
+// - "<log>.routes" interns route strings: line i is route id i
+// - RouteHistoryWriter buffers records and writes them with one fwrite per
+//   flush; new route names reach disk first, so no record names an unknown id
+// - RouteHistory maps the log and indexes it once (refresh() indexes only what
+//   was appended since): per-route trip times with running minute sums and an
+//   origin/destination -> routes table, so window counts and averages are
+//   binary searches rather than scans while the log is in time order
+
+struct HistoryRecord { std::int64_t time; std::uint32_t route; std::int32_t minutes; };
+static_assert(sizeof(HistoryRecord)==16, "history records are 16 bytes on disk");
+
+struct HistoryHeader { char magic[8]; std::uint32_t version, recordBytes; };
+enum : std::uint32_t { kHistoryVersion = 1 };
+inline const char* historyMagic(){ return "RTHIST\0\0"; }
+
+// Trips and total minutes over some window.
+struct TripStats {
+    std::size_t trips = 0; long long minutes = 0;
+    double average() const { return trips ? (double)minutes/trips : 0.0; }
+};
+
+// "A->C->G" -> origin "A", destination "G".
+inline void routeEnds(const std::string& route, std::string& origin, std::string& dest){
+    std::size_t a = route.find("->"), b = route.rfind("->");
+    origin = route.substr(0, a); dest = a==std::string::npos ? route : route.substr(b+2);
+}
+
+class RouteHistoryWriter {
+public:
+    explicit RouteHistoryWriter(std::string path, std::size_t bufferRecords = 4096): logPath(std::move(path)), cap(std::max<std::size_t>(1, bufferRecords)) {
+        {   // A name torn by a crash is terminated and kept so ids stay aligned;
+            // no record can refer to it because names are flushed first.
+            std::ifstream in(logPath + ".routes", std::ios::binary); std::string s;
+            while(std::getline(in, s)){ intern(s); if(in.eof()) pendingNames = "\n"; }
+        }
+        names = std::fopen((logPath + ".routes").c_str(), "ab");
+        log = std::fopen(logPath.c_str(), "r+b");
+        HistoryHeader h{};
+        if(!log){
+            log = std::fopen(logPath.c_str(), "w+b"); if(!log) return;
+            std::memcpy(h.magic, historyMagic(), 8); h.version = kHistoryVersion; h.recordBytes = sizeof(HistoryRecord);
+            if(std::fwrite(&h, sizeof(h), 1, log)!=1){ close(); return; }
+        } else if(std::fread(&h, sizeof(h), 1, log)!=1 || std::memcmp(h.magic, historyMagic(), 8)!=0 || h.recordBytes!=sizeof(HistoryRecord)){ close(); return; }
+        // Resume after the last whole record.
+        seek(0, SEEK_END); long long size = tell();
+        written = (std::size_t)((size - (long long)sizeof(HistoryHeader)) / sizeof(HistoryRecord));
+        seek((long long)sizeof(HistoryHeader) + (long long)(written*sizeof(HistoryRecord)), SEEK_SET);
+        buf.reserve(cap);
+    }
+    ~RouteHistoryWriter(){ flush(); close(); }
+    RouteHistoryWriter(const RouteHistoryWriter&) = delete;
+    RouteHistoryWriter& operator=(const RouteHistoryWriter&) = delete;
+
+    bool ok() const { return log && names; }
+    const std::string& path() const { return logPath; }
+    std::size_t recordCount() const { return written + buf.size(); }
+    std::size_t routeCount() const { return routes.size(); }
+
+    void append(const std::string& route, int minutes, std::int64_t time = nowEpochSeconds()){
+        if(!ok()) return;
+        std::size_t before = routes.size(); std::uint32_t id = intern(route);
+        if(routes.size()!=before){ pendingNames += route; pendingNames += '\n'; }
+        buf.push_back({time, id, minutes});
+        if(buf.size()>=cap) flush();
+    }
+
+    bool flush(){
+        if(!ok()) return false;
+        if(!pendingNames.empty()){
+            if(std::fwrite(pendingNames.data(), 1, pendingNames.size(), names)!=pendingNames.size() || std::fflush(names)!=0) return false;
+            pendingNames.clear();
+        }
+        if(buf.empty()) return true;
+        bool good = std::fwrite(buf.data(), sizeof(HistoryRecord), buf.size(), log)==buf.size() && std::fflush(log)==0;
+        if(good){ written += buf.size(); buf.clear(); }
+        return good;
+    }
+
+    // Appends the old text history ("YYYY-MM-DD HH:MM:SS | route | N min");
+    // returns how many lines were imported.
+    std::size_t importText(const std::string& textPath){
+        std::size_t n = 0;
+        for(auto &line: readHistory(textPath)){
+            std::size_t a = line.find(" | "), b = line.rfind(" | "); std::int64_t t;
+            if(a==std::string::npos || b<=a || !parseTimestamp(line.substr(0, a), t)) continue;
+            append(line.substr(a+3, b-a-3), std::atoi(line.c_str()+b+3), t); n++;
+        }
+        flush(); return n;
+    }
+
+private:
+    std::string logPath; std::size_t cap;
+    std::FILE* log = nullptr; std::FILE* names = nullptr;
+    std::vector<HistoryRecord> buf; std::size_t written = 0;
+    std::vector<std::string> routes; std::unordered_map<std::string, std::uint32_t> ids;
+    std::string pendingNames;
+
+    std::uint32_t intern(const std::string& route){
+        auto it = ids.find(route); if(it!=ids.end()) return it->second;
+        std::uint32_t id = (std::uint32_t)routes.size(); routes.push_back(route); ids.emplace(route, id); return id;
+    }
+    void close(){ if(log) std::fclose(log); if(names) std::fclose(names); log = names = nullptr; }
+    // 64-bit offsets: the log outgrows 2 GB long before anyone rotates it.
+    void seek(long long off, int whence){
+#if defined(_WIN32)
+        _fseeki64(log, off, whence);
+#else
+        fseeko(log, (off_t)off, whence);
+#endif
+    }
+    long long tell(){
+#if defined(_WIN32)
+        return _ftelli64(log);
+#else
+        return (long long)ftello(log);
+#endif
+    }
+};
+
+class RouteHistory {
+public:
+    enum : std::int64_t { kBegin = std::numeric_limits<std::int64_t>::min(), kEnd = std::numeric_limits<std::int64_t>::max() };
+    struct RouteTrips { std::uint32_t route; TripStats stats; };
+
+    bool open(const std::string& path){
+        logPath = path; routes.clear(); od.clear(); index.clear(); namesRead = 0; indexed = 0; ordered = true; lastTime = kBegin;
+        return refresh();
+    }
+
+    // Picks up records and routes appended since open() or the last refresh().
+    bool refresh(){
+        if(!file.open(logPath)) return false;
+        if(file.size()<sizeof(HistoryHeader)) return true;
+        HistoryHeader h; std::memcpy(&h, file.data(), sizeof(h));
+        if(std::memcmp(h.magic, historyMagic(), 8)!=0 || h.recordBytes!=sizeof(HistoryRecord)){ file.close(); return false; }
+        std::ifstream in(logPath + ".routes", std::ios::binary); in.seekg((std::streamoff)namesRead);
+        std::string s, origin, dest;
+        while(std::getline(in, s) && !in.eof()){   // a line without '\n' may still be growing
+            namesRead += s.size()+1; routeEnds(s, origin, dest);
+            od[origin + '\0' + dest].push_back((std::uint32_t)routes.size());
+            routes.push_back(s); index.emplace_back();
+        }
+        std::size_t n = size();
+        for(; indexed<n; ++indexed){
+            HistoryRecord r = record(indexed);
+            if(r.route>=routes.size()) break;   // name not flushed yet; retry on the next refresh
+            Postings& p = index[r.route];
+            if(!p.time.empty() && r.time<p.time.back()) p.ordered = false;
+            ordered = ordered && r.time>=lastTime; lastTime = r.time;
+            p.time.push_back(r.time); p.sum.push_back(p.sum.back() + r.minutes);
+        }
+        return true;
+    }
+
+    std::size_t size() const { return file.size()<sizeof(HistoryHeader) ? 0 : (file.size()-sizeof(HistoryHeader))/sizeof(HistoryRecord); }
+    HistoryRecord record(std::size_t i) const { HistoryRecord r; std::memcpy(&r, file.data()+sizeof(HistoryHeader)+i*sizeof(HistoryRecord), sizeof(r)); return r; }
+    std::size_t routeCount() const { return routes.size(); }
+    const std::string& route(std::uint32_t id) const { return routes[id]; }
+    // True while every record is at or after the one before it; window
+    // queries fall back to scanning a route's trips otherwise.
+    bool timeOrdered() const { return ordered; }
+
+    // Trips on one route with time in [from, to).
+    TripStats routeStats(std::uint32_t id, std::int64_t from = kBegin, std::int64_t to = kEnd) const {
+        TripStats s; if(id>=index.size() || from>=to) return s;
+        const Postings& p = index[id];
+        if(p.ordered){
+            std::size_t lo = std::lower_bound(p.time.begin(), p.time.end(), from) - p.time.begin();
+            std::size_t hi = std::lower_bound(p.time.begin(), p.time.end(), to) - p.time.begin();
+            s.trips = hi-lo; s.minutes = p.sum[hi]-p.sum[lo]; return s;
+        }
+        for(std::size_t i=0; i<p.time.size(); ++i) if(p.time[i]>=from && p.time[i]<to){ s.trips++; s.minutes += p.sum[i+1]-p.sum[i]; }
+        return s;
+    }
+
+    // All trips from origin to destination in [from, to), whichever route they took.
+    TripStats odStats(const std::string& origin, const std::string& dest, std::int64_t from = kBegin, std::int64_t to = kEnd) const {
+        TripStats s; auto it = od.find(origin + '\0' + dest); if(it==od.end()) return s;
+        for(std::uint32_t id: it->second){ TripStats r = routeStats(id, from, to); s.trips += r.trips; s.minutes += r.minutes; }
+        return s;
+    }
+
+    // The n most travelled routes in [from, to), most trips first.
+    std::vector<RouteTrips> topRoutes(std::size_t n, std::int64_t from = kBegin, std::int64_t to = kEnd) const {
+        std::vector<RouteTrips> all;
+        for(std::uint32_t id=0; id<routes.size(); ++id){ TripStats s = routeStats(id, from, to); if(s.trips) all.push_back({id, s}); }
+        n = std::min(n, all.size());
+        std::partial_sort(all.begin(), all.begin()+n, all.end(), [](const RouteTrips& a, const RouteTrips& b){ return a.stats.trips!=b.stats.trips ? a.stats.trips>b.stats.trips : a.route<b.route; });
+        all.resize(n); return all;
+    }
+
+private:
+    // Trip times of one route in log order; sum[i] = minutes of the first i.
+    struct Postings { std::vector<std::int64_t> time; std::vector<long long> sum{0}; bool ordered = true; };
+
+    std::string logPath;
+    MappedFile file;
+    std::vector<std::string> routes; std::size_t namesRead = 0;
+    std::unordered_map<std::string, std::vector<std::uint32_t>> od;
+    std::vector<Postings> index; std::size_t indexed = 0;
+    bool ordered = true; std::int64_t lastTime = kBegin;
+};
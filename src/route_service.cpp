@@ -0,0 +1,2 @@
+#include "route_service.h"
+// Header-only; this TU keeps the one-file-per-module build layout.
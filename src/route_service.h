@@ -0,0 +1,198 @@
+#pragma once
+#include "graph.h"
+#include "router.h"
+#include "live_graph.h"
+#include "k_shortest.h"
+#include "traffic_assignment.h"
+#include "json_writer.h"
+#include "json_exporter.h"
+#include "traffic_simulator.h"
+#include "http_server.h"
+#include "metrics.h"
+#include "route_cache.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+// Routing service ~130 LOC: the HTTP face of the engine
+//   GET  /route?from=A&to=B[&mode=dijkstra|bidirectional|astar][&alternatives=K]
+//                          route.json document plus the weight version used;
+//                          with K > 1 it also lists up to K routes, best first
+//   GET  /graph            graph.json of the newest weight generation
+//   GET  /traffic          graph_delta.json of the last traffic batch
+//   POST /traffic[?changes=N]  one TrafficSimulator step, published as a new
+//                          generation; answers with its delta
+//   GET  /assignment       assignment.json: user-equilibrium flows for the
+//                          demand file on the newest generation (solved once
+//                          per weight version)
+//   GET  /metrics          metrics.h snapshot as Prometheus text;
+//                          /metrics.json as JSON
+// Single routes go through a shared RouteCache that each traffic step
+// invalidates selectively. /graph.json, /graph_delta.json and /assignment.json alias the live documents and anything
+// else is a static file from the web root, so web/ runs against the service
+// unchanged. Each worker routes on its own pinned LiveGraph generation and
+// never waits on traffic updates.
+
+class RouteService {
+public:
+    // workers must match the HttpServer's worker count. An empty logPath
+    // turns traffic logging off.
+    RouteService(const Graph& g, unsigned workers, std::string webRoot = "web", std::string logPath = "data/traffic_logs.txt",
+                 std::string demandPath = "data/od_demand.txt")
+        : lg(g), root(std::move(webRoot)), cache(g), sim(logPath), logTraffic(!logPath.empty()), trafficReader(lg), demandFile(std::move(demandPath)), assignReader(lg) {
+        for(unsigned w=0; w<workers; ++w) states.emplace_back(new Worker(lg));
+        const Graph& view = trafficReader.pin();
+        JsonWriter out(&lastDelta); graphDeltaJson(view, {}, view.weightVersion(), out); out.commit();
+        trafficReader.unpin();
+    }
+
+    LiveGraph& live(){ return lg; }
+    const RouteCache& routeCache() const { return cache; }
+
+    void handle(const HttpRequest& req, HttpResponse& res, unsigned worker){
+        const std::string& p = req.path;
+        res.headers.emplace_back("X-Routing-Service", "1");   // lets web/app.js switch to the API
+        if(p=="/route") route(req, res, *states[worker]);
+        else if(p=="/graph" || p=="/graph.json") graph(req, res, *states[worker]);
+        else if(p=="/traffic" || p=="/graph_delta.json") traffic(req, res);
+        else if(p=="/assignment" || p=="/assignment.json") assignment(req, res);
+        else if(p=="/metrics" || p=="/metrics.json") metrics(req, res);
+        else staticFile(req, res);
+    }
+
+private:
+    enum { kMaxAlternatives = 10 };
+
+    struct Worker {
+        LiveGraph::Reader reader; Router router; KShortestPaths alternatives;
+        // Traffic batches the router has not seen yet, as one span of versions
+        // [notedFrom, notedTo]; only the cheaper changes are kept.
+        std::mutex notesMutex; std::vector<TrafficChange> notes; std::uint64_t notedFrom = 0, notedTo = 0; bool noted = false;
+        explicit Worker(LiveGraph& live): reader(live), router(reader.graph()), alternatives(reader.graph()) {}
+
+        void note(const std::vector<TrafficChange>& changes, std::uint64_t from, std::uint64_t to){
+            std::lock_guard<std::mutex> lk(notesMutex);
+            // A gap, or a backlog bigger than a rescan, just lets the router rescan.
+            if(!noted || notedTo!=from || notes.size()>reader.graph().edgeCount()){ notes.clear(); notedFrom = from; noted = true; }
+            for(auto &c: changes) if(c.delta<0) notes.push_back(c);
+            notedTo = to;
+        }
+        void drainNotes(){
+            std::vector<TrafficChange> batch; std::uint64_t from, to;
+            {
+                std::lock_guard<std::mutex> lk(notesMutex);
+                if(!noted) return;
+                batch.swap(notes); from = notedFrom; to = notedTo; noted = false;
+            }
+            router.noteChanges(batch, from, to);
+        }
+    };
+
+    LiveGraph lg;
+    std::string root;
+    RouteCache cache;
+    std::vector<std::unique_ptr<Worker>> states;
+    std::mutex trafficMutex;   // guards sim, trafficReader and lastDelta
+    TrafficSimulator sim; bool logTraffic;
+    LiveGraph::Reader trafficReader;
+    std::string lastDelta;
+    std::mutex assignMutex;    // guards everything below
+    std::string demandFile;
+    LiveGraph::Reader assignReader;
+    std::unique_ptr<TrafficAssignment> assigner;   // built on first use; owns a ThreadPool
+    std::vector<OdDemand> demand;
+    std::uint64_t assignedVersion = 0; std::string lastAssignment;
+
+    static void fail(HttpResponse& res, int status, const std::string& message){
+        res.status = status; res.body.clear();
+        JsonWriter out(&res.body); out.raw("{\"error\": ").str(message).raw("}\n"); out.commit();
+    }
+    static bool methodIs(const HttpRequest& req, HttpResponse& res, const char* m){
+        if(req.method==m) return true;
+        fail(res, 405, std::string("use ") + m); res.headers.emplace_back("Allow", m); return false;
+    }
+
+    void route(const HttpRequest& req, HttpResponse& res, Worker& w){
+        if(!methodIs(req, res, "GET")) return;
+        std::string mode = req.param("mode", "dijkstra");
+        SearchMode m = mode=="astar" ? SearchMode::AStar : mode=="bidirectional" ? SearchMode::Bidirectional : SearchMode::Dijkstra;
+        if(m==SearchMode::Dijkstra && mode!="dijkstra"){ fail(res, 400, "unknown mode: " + mode); return; }
+        int k = std::atoi(req.param("alternatives", "1").c_str());
+        if(k<1 || k>kMaxAlternatives){ fail(res, 400, "alternatives must be 1.." + std::to_string(kMaxAlternatives)); return; }
+        LiveGraph::Pin pin(w.reader); const Graph& g = *pin;
+        NodeId src = g.id(req.param("from")), dst = g.id(req.param("to"));
+        if(src==kInvalidNode || dst==kInvalidNode){ fail(res, 404, "unknown place"); return; }
+        JsonWriter out(&res.body);
+        if(k>1) routeJson(g, w.alternatives.route(src, dst, k), out);   // mode only picks the single-route search
+        else {
+            PathResult r;
+            if(!cache.lookup(src, dst, g.weightVersion(), r)){ w.drainNotes(); r = w.router.route(src, dst, m); cache.insert(src, dst, g.weightVersion(), r); }
+            routeJson(g, r, out);
+        }
+        out.commit();
+    }
+
+    void graph(const HttpRequest& req, HttpResponse& res, Worker& w){
+        if(!methodIs(req, res, "GET")) return;
+        LiveGraph::Pin pin(w.reader);
+        JsonWriter out(&res.body); graphJson(*pin, out); out.commit();
+    }
+
+    void traffic(const HttpRequest& req, HttpResponse& res){
+        std::lock_guard<std::mutex> lk(trafficMutex);
+        if(req.method=="GET"){ res.body = lastDelta; return; }
+        if(req.method!="POST" || req.path!="/traffic"){
+            fail(res, 405, "use GET, or POST /traffic"); res.headers.emplace_back("Allow", req.path=="/traffic" ? "GET, POST" : "GET"); return;
+        }
+        int n = std::atoi(req.param("changes", "4").c_str());
+        if(n<1 || n>100000){ fail(res, 400, "changes must be 1..100000"); return; }
+        std::uint64_t base = lg.version();
+        auto changes = sim.apply(lg, n, -3, 6, logTraffic);
+        const Graph& view = trafficReader.pin();
+        cache.invalidate(view, changes, base);
+        for(auto &w: states) w->note(changes, base, view.weightVersion());
+        lastDelta.clear(); JsonWriter out(&lastDelta); graphDeltaJson(view, changes, base, out); out.commit();
+        trafficReader.unpin();
+        res.body = lastDelta;
+    }
+
+    void assignment(const HttpRequest& req, HttpResponse& res){
+        if(!methodIs(req, res, "GET")) return;
+        std::lock_guard<std::mutex> lk(assignMutex);
+        LiveGraph::Pin pin(assignReader); const Graph& g = *pin;
+        if(!assigner){
+            demand = loadDemand(g, demandFile);
+            if(demand.empty()){ fail(res, 404, "no demand in " + demandFile); return; }
+            assigner.reset(new TrafficAssignment(assignReader.graph()));
+        }
+        if(lastAssignment.empty() || assignedVersion!=g.weightVersion()){
+            AssignmentResult r = assigner->solve(demand);
+            lastAssignment.clear(); JsonWriter out(&lastAssignment); assignmentJson(g, r, out); out.commit();
+            assignedVersion = g.weightVersion();
+        }
+        res.body = lastAssignment;
+    }
+
+    void metrics(const HttpRequest& req, HttpResponse& res){
+        if(!methodIs(req, res, "GET")) return;
+        MetricsSnapshot m = Metrics::global().snapshot();
+        if(req.path=="/metrics.json"){ JsonWriter out(&res.body); metricsJson(m, out); out.commit(); return; }
+        res.contentType = "text/plain; version=0.0.4"; res.body = prometheusText(m);
+    }
+
+    void staticFile(const HttpRequest& req, HttpResponse& res){
+        if(!methodIs(req, res, "GET")) return;
+        std::string p = req.path=="/" ? "/index.html" : req.path;
+        if(p.find("..")!=std::string::npos || p.find('\\')!=std::string::npos){ fail(res, 404, "not found"); return; }
+        std::ifstream in(root + p, std::ios::binary);
+        if(!in.is_open()){ fail(res, 404, "not found"); return; }
+        std::stringstream ss; ss << in.rdbuf(); res.body = ss.str();
+        std::string ext = p.substr(p.find_last_of('.')+1);
+        res.contentType = ext=="html" ? "text/html; charset=utf-8" : ext=="js" ? "application/javascript" : ext=="css" ? "text/css"
+                        : ext=="json" ? "application/json" : ext=="svg" ? "image/svg+xml" : ext=="png" ? "image/png" : "application/octet-stream";
+    }
+};
@@ -0,0 +1,184 @@
+#pragma once
+#include "graph.h"
+#include "dijkstra.h"
+#include "search_workspace.h"
+#include <vector>
+#include <string>
+#include <cmath>
+
+// Routing API ~210 LOC
+// - One entry point, selectable search strategy:
+//     Dijkstra       unidirectional, same search as dijkstra()
+//     Bidirectional  forward + backward Dijkstra meeting in the middle
+//     AStar          goal-directed with a straight-line / max-speed heuristic
+// - Reports settled-node counts for benchmarking, and each query's latency
+//   and search counters to metrics.h
+// - Owns its workspaces: use one Router per thread over a shared Graph
+// - A* keeps node positions across weight changes; noteChanges() lets it
+//   lower its bound per traffic batch instead of rescanning every road
+
+enum class SearchMode { Dijkstra, Bidirectional, AStar };
+static_assert((unsigned)SearchMode::AStar==kSearchAStar && (unsigned)SearchMode::Bidirectional==kSearchBidirectional, "metrics index search kinds by SearchMode");
+
+inline const char* searchModeName(SearchMode m){
+    switch(m){ case SearchMode::Dijkstra: return "dijkstra"; case SearchMode::Bidirectional: return "bidirectional"; default: return "astar"; }
+}
+
+class Router {
+public:
+    explicit Router(const Graph& g): graph(g) {}
+
+    PathResult route(NodeId src, NodeId dst, SearchMode mode = SearchMode::Dijkstra){
+        ScopedTimer timer(kTimeRoute);
+        SearchCounters before = fwd.counters() + bwd.counters();
+        settled = 0; PathResult res;
+        if(!graph.hasNode(src) || !graph.hasNode(dst)) return res;
+        switch(mode){
+            case SearchMode::Dijkstra:
+                res.distance = dijkstraSearch(graph, src, dst, fwd, [this](NodeId, int){ settled++; });
+                fwd.extractPath(src, dst, res.path); break;
+            case SearchMode::Bidirectional: res = bidirectional(src, dst); break;
+            case SearchMode::AStar: res = astar(src, dst); break;
+        }
+        if(res.path.empty()) res.distance = SearchWorkspace::INF;
+        if(kMetricsEnabled){ last = fwd.counters() + bwd.counters() - before; Metrics::global().search((unsigned)mode, last); }
+        return res;
+    }
+    PathResult route(const std::string& src, const std::string& dst, SearchMode mode = SearchMode::Dijkstra){
+        return route(graph.id(src), graph.id(dst), mode);
+    }
+
+    // The graph went from weight version `from` to `to` through `changes`
+    // (as filled by Graph::applyUpdates or LiveGraph::publish). Lowers the A*
+    // bound for the roads that got cheaper, so the next A* query skips the
+    // rescan. Optional: a batch that does not follow the last one seen is
+    // ignored, and A* rescans on any version it was not told about. Cheaper
+    // changes must name their road (TrafficChange::edge): newWeight reports
+    // only one of several parallel roads.
+    void noteChanges(const std::vector<TrafficChange>& changes, std::uint64_t from, std::uint64_t to){
+        if(from!=boundVersion || to<from) return;
+        double lowered = minutesPerKm;
+        for(const auto &c: changes){
+            if(c.delta>=0 || c.newWeight<0 || !useHeuristic) continue;
+            if(c.edge>=roadKm.size()) return;   // leaves the bound at `from`: the next A* query rescans
+            if(roadKm[c.edge]<=0) continue;
+            if(c.newWeight==0) return;
+            lowered = std::min(lowered, c.newWeight / roadKm[c.edge]);
+        }
+        minutesPerKm = lowered; boundVersion = to;
+    }
+
+    // Nodes popped from the heap(s) by the last query.
+    std::size_t lastSettled() const { return settled; }
+    // Heap and arc work of the last query (zero with TRAFFIC_METRICS=0).
+    const SearchCounters& lastCounters() const { return last; }
+
+private:
+    const Graph& graph;
+    SearchWorkspace fwd, bwd;
+    std::size_t settled = 0; SearchCounters last;
+
+    // A* bound: the fastest any road lets you travel, in km per minute of
+    // weight, measured as the straight 3D chord between node positions on the
+    // sphere. The chord is a metric like haversine but needs no trig per
+    // relaxation. Positions and road lengths are computed once per graph
+    // layout (Graph::layoutVersion).
+    // The bound holds for every weight version in [boundFrom, boundVersion]:
+    // noteChanges() lowers it for roads that got cheaper, any other version
+    // rescans the weights, and so does kRescanEvery versions of lowering
+    // (the bound only loosens between rescans).
+    enum : unsigned { kRescanEvery = 64 };
+    double minutesPerKm = 0; std::uint64_t boundFrom = ~0ull, boundVersion = ~0ull; bool useHeuristic = false, hasCoords = false;
+    std::uint64_t geometryLayout = 0; std::size_t geometryNodes = 0, geometryRoads = 0;
+    std::vector<double> xyz, roadKm;
+
+    double chordKm(NodeId a, NodeId b) const {
+        double dx=xyz[3*a]-xyz[3*b], dy=xyz[3*a+1]-xyz[3*b+1], dz=xyz[3*a+2]-xyz[3*b+2];
+        return std::sqrt(dx*dx+dy*dy+dz*dz);
+    }
+
+    void refreshGeometry(){
+        if(geometryLayout==graph.layoutVersion()) return;
+        geometryLayout = graph.layoutVersion(); geometryNodes = graph.nodeCount(); geometryRoads = graph.edgeCount(); boundFrom = boundVersion = ~0ull;
+        hasCoords = graph.allCoords(); xyz.clear(); roadKm.clear();
+        if(!hasCoords) return;
+        const double R=6371.0, rad=3.14159265358979323846/180.0;
+        xyz.resize(3*geometryNodes);
+        for(NodeId u=0; u<geometryNodes; ++u){
+            double la=graph.lat(u)*rad, lo=graph.lng(u)*rad;
+            xyz[3*u]=R*std::cos(la)*std::cos(lo); xyz[3*u+1]=R*std::cos(la)*std::sin(lo); xyz[3*u+2]=R*std::sin(la);
+        }
+        roadKm.resize(geometryRoads);
+        for(EdgeId e=0; e<geometryRoads; ++e) roadKm[e] = chordKm(graph.edgeSource(e), graph.edgeTarget(e));
+    }
+
+    void refreshBound(){
+        refreshGeometry();
+        std::uint64_t v = graph.weightVersion();
+        if(v>=boundFrom && v<=boundVersion && boundVersion-boundFrom<kRescanEvery) return;
+        boundFrom = boundVersion = v; minutesPerKm = 0; useHeuristic = hasCoords;
+        if(!useHeuristic) return;
+        double kmPerMinute = 0;
+        for(EdgeId e=0; e<geometryRoads; ++e){
+            if(roadKm[e]<=0) continue;
+            // A zero-weight road with length would make any bound inadmissible.
+            int w = graph.edgeWeight(e);
+            if(w<=0){ useHeuristic = false; return; }
+            kmPerMinute = std::max(kmPerMinute, roadKm[e] / w);
+        }
+        if(kmPerMinute<=0) useHeuristic = false; else minutesPerKm = 1.0/kmPerMinute;
+    }
+
+    // floor() of a consistent heuristic stays consistent with integer weights.
+    int heuristic(NodeId u, NodeId dst) const {
+        return useHeuristic ? (int)(chordKm(u, dst) * minutesPerKm * (1 - 1e-9)) : 0;
+    }
+
+    PathResult astar(NodeId src, NodeId dst){
+        refreshBound(); fwd.reset(graph.nodeCount());
+        PathResult res; fwd.label(src, 0, kInvalidNode); fwd.heap.push(src, heuristic(src, dst));
+        while(!fwd.heap.empty()){
+            NodeId u = fwd.heap.pop().node; settled++;
+            int d = fwd.dist[u];
+            if(u==dst){ res.distance = d; fwd.extractPath(src, dst, res.path); return res; }
+            fwd.countArcs(graph.neighbors(u).size());
+            for(const auto &e: graph.neighbors(u)){
+                int nd = d + e.w;
+                if(nd < fwd.distance(e.v)){ fwd.label(e.v, nd, u); fwd.heap.pushOrDecrease(e.v, nd + heuristic(e.v, dst)); }
+            }
+        }
+        return res;
+    }
+
+    // Alternates the side with the smaller queue head; stops once the two
+    // heads together cannot beat the best meeting point found so far.
+    PathResult bidirectional(NodeId src, NodeId dst){
+        std::size_t n = graph.nodeCount(); fwd.reset(n); bwd.reset(n);
+        PathResult res;
+        if(src==dst){ res.distance = 0; res.path.push_back(src); return res; }
+        long long best = SearchWorkspace::INF; NodeId meet = kInvalidNode;
+        fwd.label(src, 0, kInvalidNode); fwd.heap.push(src, 0);
+        bwd.label(dst, 0, kInvalidNode); bwd.heap.push(dst, 0);
+        while(!fwd.heap.empty() && !bwd.heap.empty()){
+            if((long long)fwd.heap.top().key + bwd.heap.top().key >= best) break;
+            bool forward = fwd.heap.top().key <= bwd.heap.top().key;
+            SearchWorkspace &self = forward ? fwd : bwd, &other = forward ? bwd : fwd;
+            auto top = self.heap.pop(); settled++;
+            NodeId u = top.node; int d = top.key;
+            self.countArcs(graph.neighbors(u).size());
+            for(const auto &e: graph.neighbors(u)){
+                int nd = d + e.w;
+                if(nd < self.distance(e.v)){ self.label(e.v, nd, u); self.heap.pushOrDecrease(e.v, nd); }
+                if(other.reached(e.v) && (long long)nd + other.dist[e.v] < best){ best = (long long)nd + other.dist[e.v]; meet = e.v; }
+            }
+        }
+        if(meet==kInvalidNode) return res;
+        // Both labels of `meet` sum to best: src -> meet forward, then meet -> dst
+        // along the backward tree.
+        res.distance = (int)best;
+        fwd.extractPath(src, meet, res.path);
+        std::vector<NodeId> tail; bwd.extractPath(dst, meet, tail);
+        for(std::size_t i = tail.size(); i-- > 1; ) res.path.push_back(tail[i-1]);
+        return res;
+    }
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include "graph.h"
+#include "metrics.h"
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+
+// Search workspace ~110 LOC
+// - Indexed 4-ary min-heap with decrease-key (one slot per node, no stale entries)
+// - Flat dist/parent arrays reset in O(1) through a generation counter
+// - One workspace per thread, reused across queries so the hot path never allocates
+// - Running heap and arc counters for metrics.h (compiled out with TRAFFIC_METRICS=0)
+
+// Min-heap over node IDs keyed by int distance. pos[u] is the slot of u in the
+// heap or npos; entries are cleaned up on pop/clear so the array never needs a
+// full reset between queries.
+class IndexedDaryHeap {
+public:
+    enum : std::uint32_t { D = 4, npos = 0xFFFFFFFFu };
+    struct Item { int key; NodeId node; };
+
+    void reserveNodes(std::size_t n){ if(pos.size()<n) pos.resize(n, npos); }
+    bool empty() const { return items.empty(); }
+    std::size_t size() const { return items.size(); }
+    bool contains(NodeId u) const { return u<pos.size() && pos[u]!=npos; }
+    const Item& top() const { return items.front(); }
+    int keyOf(NodeId u) const { return items[pos[u]].key; }
+
+    void push(NodeId u, int key){ if(kMetricsEnabled) pushes++; pos[u]=(std::uint32_t)items.size(); items.push_back({key,u}); siftUp(pos[u]); }
+    void decreaseKey(NodeId u, int key){ if(kMetricsEnabled) decreases++; std::uint32_t i=pos[u]; items[i].key=key; siftUp(i); }
+    // Insert u or lower its key; returns false if the existing key was already <= key.
+    bool pushOrDecrease(NodeId u, int key){
+        if(pos[u]==npos){ push(u,key); return true; }
+        if(items[pos[u]].key<=key) return false; decreaseKey(u,key); return true;
+    }
+
+    Item pop(){
+        if(kMetricsEnabled) pops++;
+        Item t=items.front(); pos[t.node]=npos;
+        Item last=items.back(); items.pop_back();
+        if(!items.empty()){ items[0]=last; pos[last.node]=0; siftDown(0); }
+        return t;
+    }
+
+    void clear(){ for(auto &it: items) pos[it.node]=npos; items.clear(); }
+
+    // Operations since construction; never reset, callers take differences.
+    std::uint64_t pushes = 0, decreases = 0, pops = 0;
+
+private:
+    std::vector<Item> items;
+    std::vector<std::uint32_t> pos;
+
+    void place(std::uint32_t i, const Item& it){ items[i]=it; pos[it.node]=i; }
+    void siftUp(std::uint32_t i){
+        Item it=items[i];
+        while(i>0){ std::uint32_t p=(i-1)/D; if(items[p].key<=it.key) break; place(i, items[p]); i=p; }
+        place(i, it);
+    }
+    void siftDown(std::uint32_t i){
+        Item it=items[i]; std::uint32_t n=(std::uint32_t)items.size();
+        while(true){
+            std::uint32_t c=i*D+1; if(c>=n) break;
+            std::uint32_t best=c, end=std::min(c+D, n);
+            for(std::uint32_t k=c+1;k<end;k++) if(items[k].key<items[best].key) best=k;
+            if(items[best].key>=it.key) break;
+            place(i, items[best]); i=best;
+        }
+        place(i, it);
+    }
+};
+
+// Per-query scratch state. dist/parent of node u are valid only while
+// stamp[u]==gen; bumping gen invalidates everything at once.
+struct SearchWorkspace {
+    enum : int { INF = std::numeric_limits<int>::max() };
+
+    std::vector<int> dist;
+    std::vector<NodeId> parent;
+    std::vector<std::uint32_t> stamp;
+    std::uint32_t gen = 0;
+    IndexedDaryHeap heap;
+    std::uint64_t relaxed = 0;   // arcs scanned by the searches that count them (see counters())
+
+    // Prepare for a query on a graph with n nodes. Only grows, never shrinks.
+    void reset(std::size_t n){
+        if(dist.size()<n){ dist.resize(n); parent.resize(n); stamp.resize(n, 0); }
+        heap.reserveNodes(n); heap.clear();
+        if(++gen==0){ std::fill(stamp.begin(), stamp.end(), 0u); gen=1; }
+    }
+
+    // Running totals; a query's work is the difference across it.
+    SearchCounters counters() const { return {heap.pops, relaxed, heap.pushes, heap.decreases}; }
+    void countArcs(std::size_t n){ if(kMetricsEnabled) relaxed += n; }
+
+    bool reached(NodeId u) const { return stamp[u]==gen; }
+    int distance(NodeId u) const { return reached(u)? dist[u] : INF; }
+    void label(NodeId u, int d, NodeId p){ stamp[u]=gen; dist[u]=d; parent[u]=p; }
+
+    // Walk parent pointers dst -> src into out (src first). Empty if unreachable.
+    void extractPath(NodeId src, NodeId dst, std::vector<NodeId>& out) const {
+        out.clear(); if(!reached(dst)) return;
+        for(NodeId cur=dst; ; cur=parent[cur]){ out.push_back(cur); if(cur==src) break; if(parent[cur]==kInvalidNode){ out.clear(); return; } }
+        std::reverse(out.begin(), out.end());
+    }
+};
+
+// Workspace owned by the calling thread; reused by every query on that thread.
+inline SearchWorkspace& threadWorkspace(){ static thread_local SearchWorkspace ws; return ws; }
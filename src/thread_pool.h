@@ -0,0 +1,82 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// Thread pool ~80 LOC
+// - Fixed set of workers kept alive across batches (no per-batch spawn cost)
+// - parallelFor(count, grain, fn): indices are handed out in chunks of
+//   `grain` from a shared atomic cursor, so fast workers keep pulling work
+//   while a slow chunk finishes elsewhere
+// - The calling thread joins in as worker 0; fn(i, worker) gets a stable
+//   worker index for per-thread scratch state
+
+class ThreadPool {
+public:
+    // threads == 0: one per hardware thread.
+    explicit ThreadPool(unsigned threads = 0){
+        if(threads==0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for(unsigned w=1; w<threads; ++w) workers.emplace_back([this, w]{ loop(w); });
+    }
+    ~ThreadPool(){
+        { std::lock_guard<std::mutex> lk(m); stopping = true; }
+        wake.notify_all();
+        for(auto &t: workers) t.join();
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return (unsigned)workers.size() + 1; }
+
+    // Runs fn(i, worker) for every i in [0, count); returns when all are done.
+    // Not reentrant: one batch at a time per pool.
+    template<class F>
+    void parallelFor(std::size_t count, std::size_t grain, F&& fn){
+        if(count==0) return;
+        grain = std::max<std::size_t>(1, grain);
+        std::atomic<std::size_t> cursor(0);
+        std::function<void(unsigned)> body = [&](unsigned w){
+            for(std::size_t b; (b = cursor.fetch_add(grain)) < count; )
+                for(std::size_t i=b, e=std::min(count, b+grain); i<e; ++i) fn(i, w);
+        };
+        {
+            std::lock_guard<std::mutex> lk(m);
+            job = &body; pending = (unsigned)workers.size(); batch++;
+        }
+        wake.notify_all();
+        body(0);
+        std::unique_lock<std::mutex> lk(m);
+        done.wait(lk, [this]{ return pending==0; });
+        job = nullptr;
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex m;
+    std::condition_variable wake, done;
+    std::function<void(unsigned)>* job = nullptr;
+    std::uint64_t batch = 0;
+    unsigned pending = 0;
+    bool stopping = false;
+
+    void loop(unsigned w){
+        std::uint64_t seen = 0;
+        while(true){
+            std::function<void(unsigned)>* j;
+            {
+                std::unique_lock<std::mutex> lk(m);
+                wake.wait(lk, [&]{ return stopping || batch!=seen; });
+                if(stopping) return;
+                seen = batch; j = job;
+            }
+            (*j)(w);
+            std::lock_guard<std::mutex> lk(m);
+            if(--pending==0) done.notify_one();
+        }
+    }
+};
@@ -0,0 +1,2 @@
+#include "time_dependent.h"
+// Header-only; this TU keeps the one-file-per-module build layout.
@@ -0,0 +1,183 @@
+#pragma once
+#include "graph.h"
+#include "dijkstra.h"
+#include "search_workspace.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <cmath>
+#include <ctime>
+#include <algorithm>
+
+// Time-dependent travel times ~200 LOC
+// - One piecewise-linear daily profile per road (EdgeId): 24 hourly samples
+//   taken at HH:30, interpolated linearly and wrapping past midnight
+// - Samples are uint16 minutes in one flat array, 48 bytes per profiled road;
+//   roads without a profile fall back to their current Graph weight
+// - Profiles are built from the timestamped simulator log
+//   ("YYYY-MM-DD HH:MM:SS U V delta newWeight"), averaging newWeight per hour
+//   and filling empty hours from their neighbours; a Builder keeps the sums
+//   so new simulator steps extend them without rereading the log
+// - Profiles are made FIFO (leaving later never arrives earlier), which is
+//   what keeps the time-dependent Dijkstra below exact
+
+static const int kMinutesPerDay = 24*60;
+
+class TravelTimeProfiles {
+public:
+    enum : int { kSlots = 24, kSlotMinutes = 60 };
+    enum : std::uint32_t { kNone = 0xFFFFFFFFu };
+
+    TravelTimeProfiles() = default;
+    explicit TravelTimeProfiles(std::size_t edges): slot(edges, kNone) {}
+
+    std::size_t edgeCount() const { return slot.size(); }
+    std::size_t profiledCount() const { return samples.size()/kSlots; }
+    bool hasProfile(EdgeId e) const { return e<slot.size() && slot[e]!=kNone; }
+
+    // Hourly travel times for road e (hour h sampled at h:30).
+    void setProfile(EdgeId e, const int (&hourly)[kSlots]){
+        if(e>=slot.size()) slot.resize(e+1, kNone);
+        if(slot[e]==kNone){ slot[e]=(std::uint32_t)samples.size(); samples.resize(samples.size()+kSlots); }
+        std::uint16_t* s = &samples[slot[e]];
+        for(int i=0;i<kSlots;i++) s[i]=(std::uint16_t)std::max(1, std::min(0xFFFF, hourly[i]));
+        makeFifo(s);
+    }
+
+    // Travel time on road e when entering it at minute-of-day t.
+    int travelTime(EdgeId e, int t, int fallback) const {
+        if(e>=slot.size() || slot[e]==kNone) return fallback;
+        const std::uint16_t* s = &samples[slot[e]];
+        int x = t - kSlotMinutes/2; x %= kMinutesPerDay; if(x<0) x += kMinutesPerDay;
+        int i = x / kSlotMinutes, f = x % kSlotMinutes, j = (i+1) % kSlots;
+        // Round half up with integer math: a + (b-a)*f/60.
+        int num = s[i]*kSlotMinutes + (s[j]-s[i])*f;
+        return (num + kSlotMinutes/2) / kSlotMinutes;
+    }
+    int travelTime(const Graph& g, EdgeId e, int t) const { return travelTime(e, t, g.edgeWeight(e)); }
+
+    // Accumulates logged travel times per road and hour; build() averages
+    // them into profiles. Keep one around to extend the profiles as the
+    // simulator logs more (Menu does after every step).
+    class Builder {
+    public:
+        explicit Builder(const Graph& graph): g(graph), accOf(graph.edgeCount(), kNone) {}
+
+        // Every road between a and b took w minutes at some point in hour
+        // `hour`. Returns false if no road matched.
+        bool add(NodeId a, NodeId b, int hour, int w){
+            if(!g.hasNode(a) || !g.hasNode(b) || hour<0 || hour>=kSlots || w<0) return false;
+            bool hit = false; std::uint32_t arc = g.arcBegin(a);
+            for(auto e: g.neighbors(a)){
+                EdgeId id = g.arcEdge(arc++); if(e.v!=b || id>=accOf.size()) continue;
+                if(accOf[id]==kNone){ accOf[id]=(std::uint32_t)acc.size(); acc.push_back(Acc()); }   // zeroed
+                Acc& x = acc[accOf[id]]; x.sum[hour] += w; x.n[hour]++; hit = true;
+            }
+            return hit;
+        }
+        // One simulator step's changes, applied at minute-of-day t.
+        std::size_t add(const std::vector<TrafficChange>& changes, int t){
+            int hour = ((t % kMinutesPerDay + kMinutesPerDay) % kMinutesPerDay) / kSlotMinutes; std::size_t used = 0;
+            for(auto &c: changes) if(c.newWeight>=0 && add(c.u, c.v, hour, c.newWeight)) used++;
+            return used;
+        }
+        // A simulator log. Lines without a timestamp (older logs) and unknown
+        // roads are skipped. Returns the number of lines used.
+        std::size_t addLog(const std::string& path){
+            std::ifstream in(path); if(!in.is_open()) return 0;
+            std::string line; std::size_t used = 0;
+            while(std::getline(in, line)){
+                if(line.empty() || line[0]=='#') continue;
+                std::stringstream ss(line); std::string date, clock, u, v; int d, w; char c1, c2; int hh, mm;
+                if(!(ss>>date>>clock>>u>>v>>d>>w) || date.size()!=10 || date[4]!='-') continue;
+                std::stringstream cs(clock); if(!(cs>>hh>>c1>>mm>>c2) || hh<0 || hh>23 || mm<0 || mm>59) continue;
+                // Hour bins are centred on HH:30, so HH:MM belongs to bin HH.
+                if(add(g.id(u), g.id(v), hh, w)) used++;
+            }
+            return used;
+        }
+
+        void clear(){ acc.clear(); accOf.assign(accOf.size(), kNone); }
+
+        TravelTimeProfiles build() const {
+            TravelTimeProfiles p(g.edgeCount());
+            for(EdgeId e=0; e<accOf.size(); ++e){
+                if(accOf[e]==kNone) continue;
+                const Acc& x = acc[accOf[e]]; int hourly[kSlots]; fillHours(x.sum, x.n, hourly);
+                p.setProfile(e, hourly);
+            }
+            return p;
+        }
+
+    private:
+        struct Acc { long long sum[kSlots]; int n[kSlots]; };
+        const Graph& g;
+        std::vector<Acc> acc; std::vector<std::uint32_t> accOf;
+    };
+
+    // Aggregate a simulator log into profiles for g (see Builder::addLog).
+    // Every road between the logged endpoints gets the profile.
+    static TravelTimeProfiles fromTrafficLog(const Graph& g, const std::string& path, std::size_t* used=nullptr){
+        Builder b(g); std::size_t n = b.addLog(path); if(used) *used = n;
+        return b.build();
+    }
+
+private:
+    std::vector<std::uint32_t> slot;      // EdgeId -> first sample, or kNone
+    std::vector<std::uint16_t> samples;   // kSlots per profiled road
+
+    // Averages per hour; empty hours interpolate between the nearest filled
+    // ones around the clock.
+    static void fillHours(const long long* sum, const int* n, int (&out)[kSlots]){
+        for(int i=0;i<kSlots;i++) if(n[i]) out[i]=(int)((sum[i] + n[i]/2) / n[i]);
+        for(int i=0;i<kSlots;i++){
+            if(n[i]) continue;
+            int prev=-1, next=-1;
+            for(int d=1; d<kSlots && prev<0; d++) if(n[(i-d+kSlots)%kSlots]) prev=d;
+            for(int d=1; d<kSlots && next<0; d++) if(n[(i+d)%kSlots]) next=d;
+            int a=out[(i-prev+kSlots)%kSlots], b=out[(i+next)%kSlots];
+            out[i] = (a*next + b*prev + (prev+next)/2) / (prev+next);
+        }
+    }
+
+    // FIFO needs slope >= -1 minute per minute, i.e. a drop of at most
+    // kSlotMinutes between neighbouring samples. Raise later samples until
+    // that holds all the way round the clock (values only grow, so it ends).
+    static void makeFifo(std::uint16_t* s){
+        for(bool changed=true; changed; ){
+            changed=false;
+            for(int i=0;i<kSlots;i++){
+                int j=(i+1)%kSlots;
+                if(s[i] > s[j] + kSlotMinutes){ s[j] = (std::uint16_t)(s[i] - kSlotMinutes); changed=true; }
+            }
+        }
+    }
+};
+
+// Current local minute of day, for "leave now" queries.
+inline int minuteOfDayNow(){
+    std::time_t t = std::time(nullptr); std::tm* p = std::localtime(&t);
+    return p ? p->tm_hour*60 + p->tm_min : 0;
+}
+
+// Earliest arrival from src leaving at minute-of-day `depart`. PathResult
+// distance is the trip length in minutes (arrival - depart).
+inline PathResult timeDependentDijkstra(const Graph& g, const TravelTimeProfiles& prof, NodeId src, NodeId dst, int depart,
+                                        SearchWorkspace& ws = threadWorkspace()){
+    PathResult res; ws.reset(g.nodeCount());
+    if(!g.hasNode(src) || !g.hasNode(dst)) return res;
+    ws.label(src, 0, kInvalidNode); ws.heap.push(src, 0);
+    while(!ws.heap.empty()){
+        auto top = ws.heap.pop();
+        NodeId u = top.node; int d = top.key;
+        if(u==dst){ res.distance = d; ws.extractPath(src, dst, res.path); return res; }
+        std::uint32_t arc = g.arcBegin(u);
+        for(const auto &e: g.neighbors(u)){
+            int nd = d + prof.travelTime(g.arcEdge(arc++), depart + d, e.w);
+            if(nd < ws.distance(e.v)){ ws.label(e.v, nd, u); ws.heap.pushOrDecrease(e.v, nd); }
+        }
+    }
+    return res;
+}
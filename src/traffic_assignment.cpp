@@ -0,0 +1,2 @@
+#include "traffic_assignment.h"
+// Header-only; this TU keeps the one-file-per-module build layout.
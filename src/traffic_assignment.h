@@ -0,0 +1,218 @@
+#pragma once
+#include "graph.h"
+#include "search_workspace.h"
+#include "thread_pool.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Traffic assignment ~210 LOC
+// - Static user equilibrium by Frank-Wolfe: every road's travel time follows
+//   the BPR curve t = t0 * (1 + alpha * (flow / capacity)^beta), t0 being the
+//   Graph weight in minutes; roads are two-way and both directions share one
+//   capacity
+// - Each iteration loads all demand all-or-nothing onto current shortest
+//   paths: one shortest-path tree per origin, origins spread over a
+//   ThreadPool, and each tree loaded in one reverse pass over its settle order
+// - Steps go towards a conjugate mix of that loading and the previous target
+//   (conjugate Frank-Wolfe), sized by an exact line search (bisection on the
+//   derivative of the Beckmann objective); stops at a relative gap target
+// - Times go to the searches as fixed-point ints (kCostScale per minute) so
+//   the shared heap and workspaces are reused; gaps and totals stay in doubles
+
+struct OdDemand { NodeId from, to; double trips; };
+
+// "FROM TO TRIPS" per line, # comments; unknown places and non-positive
+// demand are skipped.
+inline std::vector<OdDemand> loadDemand(const Graph& g, const std::string& path){
+    std::vector<OdDemand> out; std::ifstream in(path); std::string line;
+    while(std::getline(in, line)){
+        if(line.empty() || line[0]=='#') continue;
+        std::stringstream ss(line); std::string a, b; double q;
+        if(!(ss >> a >> b >> q) || q<=0) continue;
+        NodeId u = g.id(a), v = g.id(b);
+        if(u!=kInvalidNode && v!=kInvalidNode) out.push_back({u, v, q});
+    }
+    return out;
+}
+
+struct AssignmentOptions {
+    double alpha = 0.15, beta = 4.0;   // BPR curve
+    double capacity = 1800;            // trips per road when no per-road capacity is set
+    int maxIterations = 100;
+    double targetGap = 1e-4;           // relative gap: 1 - shortest-path cost / current cost
+};
+
+struct AssignmentResult {
+    std::vector<double> flow, time;    // per EdgeId: trips and congested minutes
+    std::vector<double> capacity;      // per EdgeId, as used by the solve
+    std::vector<double> gaps;          // relative gap after each iteration
+    int iterations = 0;
+    double relativeGap = 1.0;
+    double totalTime = 0;              // sum of flow * time (trip-minutes)
+    double unassigned = 0;             // trips with no path
+    bool converged = false;            // targetGap reached within maxIterations
+};
+
+class TrafficAssignment {
+public:
+    enum : int { kCostScale = 1000, kMaxArcCost = 10000000 };   // 1/1000 min; caps a hopelessly jammed road
+
+    // threads == 0: one per hardware thread. The Graph is read, never written.
+    explicit TrafficAssignment(const Graph& g, unsigned threads = 0): graph(g), pool(threads), workers(pool.size()) {}
+
+    unsigned threads() const { return pool.size(); }
+
+    // Per-road capacity (trips per road); roads not covered use options.capacity.
+    void setCapacities(std::vector<double> c){ capacity = std::move(c); }
+
+    AssignmentResult solve(const std::vector<OdDemand>& demand, const AssignmentOptions& opt = AssignmentOptions()){
+        ScopedTimer timer(kTimeAssign);
+        graph.freeze();
+        std::size_t m = graph.edgeCount();
+        prepare(demand, opt);
+        AssignmentResult r; r.flow.assign(m, 0.0); r.time.resize(m);
+        std::vector<double> aon(m), target(m);
+        for(EdgeId e=0; e<m; ++e) r.time[e] = freeTime[e];
+        r.unassigned = allOrNothing(r.time, aon);
+        r.flow = aon;
+        for(int it=1; it<=opt.maxIterations; ++it){
+            times(r.flow, opt, r.time);
+            allOrNothing(r.time, aon);
+            double current = 0, shortest = 0;
+            for(EdgeId e=0; e<m; ++e){ current += r.flow[e]*r.time[e]; shortest += aon[e]*r.time[e]; }
+            r.relativeGap = current>0 ? std::max(0.0, 1.0 - shortest/current) : 0.0;
+            r.gaps.push_back(r.relativeGap); r.iterations = it;
+            if(r.relativeGap<=opt.targetGap){ r.converged = true; break; }
+            // Conjugate direction: mix the previous target into the new one so
+            // successive steps do not zig-zag (plain Frank-Wolfe tails off as 1/k).
+            double a = it>1 ? conjugateWeight(r.flow, target, aon, opt) : 0.0;
+            for(EdgeId e=0; e<m; ++e) target[e] = a*target[e] + (1-a)*aon[e];
+            double lambda = lineSearch(r.flow, target, opt);
+            for(EdgeId e=0; e<m; ++e) r.flow[e] += lambda*(target[e]-r.flow[e]);
+        }
+        times(r.flow, opt, r.time); r.capacity = cap;
+        r.totalTime = 0; for(EdgeId e=0; e<m; ++e) r.totalTime += r.flow[e]*r.time[e];
+        return r;
+    }
+
+private:
+    // Per-worker scratch: flows from the origins this worker loaded.
+    struct Worker { std::vector<double> flow, load; std::vector<std::uint32_t> viaArc; std::vector<NodeId> order; };
+    struct Origin { NodeId node; std::size_t begin, end; };   // range in dests
+
+    const Graph& graph;
+    ThreadPool pool;
+    std::vector<Worker> workers;
+    std::vector<double> capacity, freeTime, cap;
+    std::vector<Origin> origins; std::vector<std::pair<NodeId,double>> dests;
+    std::vector<int> arcCost;
+
+    void prepare(const std::vector<OdDemand>& demand, const AssignmentOptions& opt){
+        std::size_t m = graph.edgeCount();
+        freeTime.resize(m); cap.resize(m);
+        for(EdgeId e=0; e<m; ++e){ freeTime[e] = std::max(1, graph.edgeWeight(e)); cap[e] = roadCapacity(e, opt); }
+        std::vector<OdDemand> d;
+        for(auto &x: demand) if(graph.hasNode(x.from) && graph.hasNode(x.to) && x.trips>0) d.push_back(x);
+        std::sort(d.begin(), d.end(), [](const OdDemand& a, const OdDemand& b){ return a.from<b.from; });
+        origins.clear(); dests.clear();
+        for(std::size_t i=0; i<d.size(); ++i){
+            if(i==0 || d[i].from!=d[i-1].from) origins.push_back({d[i].from, dests.size(), dests.size()});
+            dests.emplace_back(d[i].to, d[i].trips); origins.back().end = dests.size();
+        }
+    }
+
+    double roadCapacity(EdgeId e, const AssignmentOptions& opt) const { return e<capacity.size() && capacity[e]>0 ? capacity[e] : opt.capacity; }
+
+    static double power(double x, double beta){
+        if(beta==std::floor(beta) && beta>=0 && beta<=8){ double p = 1; for(int i=0; i<(int)beta; ++i) p *= x; return p; }
+        return std::pow(x, beta);
+    }
+    double bpr(EdgeId e, double flow, const AssignmentOptions& opt) const {
+        return freeTime[e] * (1.0 + opt.alpha*power(flow/cap[e], opt.beta));
+    }
+    void times(const std::vector<double>& flow, const AssignmentOptions& opt, std::vector<double>& out) const {
+        for(EdgeId e=0; e<flow.size(); ++e) out[e] = bpr(e, flow[e], opt);
+    }
+
+    // Loads every origin's demand on shortest paths under `time`; returns the
+    // trips that had no path.
+    double allOrNothing(const std::vector<double>& time, std::vector<double>& out){
+        std::size_t n = graph.nodeCount(), m = graph.edgeCount();
+        arcCost.resize(graph.arcCount());
+        for(NodeId u=0; u<n; ++u){
+            std::uint32_t a = graph.arcBegin(u);
+            for(std::size_t k=graph.neighbors(u).size(); k--; ++a){
+                double c = std::round(time[graph.arcEdge(a)]*kCostScale);
+                arcCost[a] = c<1 ? 1 : c>kMaxArcCost ? (int)kMaxArcCost : (int)c;
+            }
+        }
+        for(auto &w: workers){ w.flow.assign(m, 0.0); w.load.resize(n, 0.0); w.viaArc.resize(n); }
+        std::vector<double> lost(workers.size(), 0.0);
+        pool.parallelFor(origins.size(), 1, [&](std::size_t i, unsigned w){ lost[w] += loadOrigin(origins[i], workers[w]); });
+        std::fill(out.begin(), out.end(), 0.0);
+        for(auto &w: workers) for(EdgeId e=0; e<m; ++e) out[e] += w.flow[e];
+        double total = 0; for(double x: lost) total += x; return total;
+    }
+
+    // Shortest-path tree from o (stopping once every destination settles),
+    // then demand flows back towards the root in reverse settle order.
+    double loadOrigin(const Origin& o, Worker& w){
+        SearchWorkspace& ws = threadWorkspace(); ws.reset(graph.nodeCount());
+        std::size_t remaining = 0;
+        for(std::size_t i=o.begin; i<o.end; ++i){ NodeId d = dests[i].first; if(w.load[d]==0) remaining++; w.load[d] += dests[i].second; }
+        w.order.clear();
+        ws.label(o.node, 0, kInvalidNode); ws.heap.push(o.node, 0);
+        while(!ws.heap.empty() && remaining){
+            auto top = ws.heap.pop(); NodeId u = top.node; int d = top.key;
+            w.order.push_back(u); if(w.load[u]>0) remaining--;
+            std::uint32_t a = graph.arcBegin(u);
+            for(const auto &e: graph.neighbors(u)){
+                int nd = d + arcCost[a];
+                if(nd < ws.distance(e.v)){ ws.label(e.v, nd, u); w.viaArc[e.v] = a; ws.heap.pushOrDecrease(e.v, nd); }
+                ++a;
+            }
+        }
+        double lost = 0;
+        for(std::size_t i=o.begin; i<o.end; ++i){   // unreached destinations keep their load
+            NodeId d = dests[i].first;
+            if(w.load[d]>0 && (!ws.reached(d) || ws.heap.contains(d))){ lost += w.load[d]; w.load[d] = 0; }
+        }
+        for(std::size_t i=w.order.size(); i-- > 1; ){
+            NodeId v = w.order[i]; double q = w.load[v]; if(q==0) continue;
+            w.load[v] = 0; w.flow[graph.arcEdge(w.viaArc[v])] += q; w.load[ws.parent[v]] += q;
+        }
+        w.load[o.node] = 0;
+        return lost;
+    }
+
+    // Weight of the previous target that makes the new direction conjugate to
+    // the last one under the (diagonal) Hessian of the objective, kept in
+    // [0, 0.99] so the new loading always counts.
+    double conjugateWeight(const std::vector<double>& flow, const std::vector<double>& prev, const std::vector<double>& aon, const AssignmentOptions& opt) const {
+        double num = 0, den = 0;
+        for(EdgeId e=0; e<flow.size(); ++e){
+            double slope = opt.beta>0 && flow[e]>0 ? freeTime[e]*opt.alpha*opt.beta*power(flow[e]/cap[e], opt.beta-1)/cap[e] : 0.0;
+            double dPrev = prev[e]-flow[e];
+            num += dPrev*slope*(aon[e]-flow[e]); den += dPrev*slope*(aon[e]-prev[e]);
+        }
+        if(den==0) return 0.0;
+        return std::min(0.99, std::max(0.0, num/den));
+    }
+
+    // Step in [0, 1] minimising the Beckmann objective along flow -> target.
+    double lineSearch(const std::vector<double>& flow, const std::vector<double>& target, const AssignmentOptions& opt) const {
+        auto slope = [&](double l){
+            double s = 0; for(EdgeId e=0; e<flow.size(); ++e){ double dx = target[e]-flow[e]; if(dx!=0) s += dx*bpr(e, flow[e]+l*dx, opt); }
+            return s;
+        };
+        if(slope(1.0)<=0) return 1.0;
+        double lo = 0, hi = 1;
+        for(int i=0; i<30; ++i){ double mid = 0.5*(lo+hi); if(slope(mid)>0) hi = mid; else lo = mid; }
+        return 0.5*(lo+hi);
+    }
+};
@@ -1,6 +1,9 @@
 #pragma once
 #include "graph.h"
 #include "json_exporter.h"
+#include "file_manager.h"
+#include "live_graph.h"
+#include "congestion_kernel.h"
 #include <random>
 #include <vector>
 #include <string>
@@ -8,27 +11,32 @@
 #include <fstream>
 #include <iostream>
 
-// Traffic simulator ~80 LOC
-// - Randomly changes weights (bounded deltas)
-// - Logs changes to data/traffic_logs.txt
+// Traffic simulator ~110 LOC
+// - Randomly changes weights (bounded deltas), picking roads by EdgeId,
+//   either in place or as a LiveGraph generation
+// - Whole-network steps through CongestionKernel (reproducible per seed)
+// - Logs timestamped changes to data/traffic_logs.txt (the input for
+//   TravelTimeProfiles::fromTrafficLog), one write per batch
 // - Provides summary trend (avg delta)
 
-struct TrafficChange { char u; char v; int delta; int newWeight; };
+// "ts u v delta newWeight\n", the traffic_logs.txt line format.
+inline void appendTrafficLine(std::string& out, const std::string& ts, const std::string& u, const std::string& v, int delta, int newWeight){
+    out += ts; out += ' '; out += u; out += ' '; out += v; out += ' ';
+    out += std::to_string(delta); out += ' '; out += std::to_string(newWeight); out += '\n';
+}
 
 inline void simulateTraffic(Graph& g) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dist(-3, 5);
+    ScopedTimer timer(kTimeSimulate);
+    std::vector<int> before = g.edgeWeights(), after = before;
+    CongestionKernel(std::random_device{}()).apply(after.data(), after.size(), 0);
+    g.setEdgeWeights(after.data());
     
-    std::cout << "\n🚦 Simulating traffic...\n";
-    for (auto& e : g.edgesUniqueUndirected()) {
-        char u = std::get<0>(e); char v = std::get<1>(e);
-        int w = g.getWeight(u, v);
-        int change = dist(gen);
-        int newWeight = std::max(1, w + change);
-        g.setWeight(u, v, newWeight);
-        std::cout << "  Edge " << u << "-" << v << ": " << w << " -> " << newWeight << " min\n";
+    std::string out = "\n🚦 Simulating traffic...\n";
+    for (EdgeId e = 0; e < after.size(); ++e) {
+        out += "  Edge "; out += g.name(g.edgeSource(e)); out += '-'; out += g.name(g.edgeTarget(e));
+        out += ": "; out += std::to_string(before[e]); out += " -> "; out += std::to_string(after[e]); out += " min\n";
     }
+    std::cout << out;
     
     // Re-export JSON with updated weights
     writeGraphJson(g, "web/graph.json");
@@ -39,25 +47,73 @@ inline void simulateTraffic(Graph& g) {
 class TrafficSimulator {
     std::mt19937 rng;
     std::string logPath;
+    std::uint64_t bulkSeed, bulkStep = 0;
 public:
     explicit TrafficSimulator(std::string logFile = "data/traffic_logs.txt")
-        : rng(std::random_device{}()), logPath(std::move(logFile)) {}
+        : rng(std::random_device{}()), logPath(std::move(logFile)), bulkSeed(((std::uint64_t)rng() << 32) | rng()) {}
 
-    std::vector<TrafficChange> apply(Graph& g, int changes=4, int minDelta=-3, int maxDelta=6){
-        std::vector<TrafficChange> out; auto edges=g.edgesUniqueUndirected(); if(edges.empty()) return out;
-        std::uniform_int_distribution<int> idx(0,(int)edges.size()-1); std::uniform_int_distribution<int> del(minDelta,maxDelta);
-        for(int i=0;i<changes;i++){
-            auto tup = edges[idx(rng)]; char a=std::get<0>(tup); char b=std::get<1>(tup);
-            int d = del(rng); if(d==0) d=1; g.addWeightDelta(a,b,d);
-            TrafficChange tc{a,b,d,g.getWeight(a,b)}; out.push_back(tc);
+    // Makes every later step reproducible.
+    void seed(std::uint64_t s){ rng.seed((std::mt19937::result_type)s); bulkSeed = s; bulkStep = 0; }
+
+    // Random roads by EdgeId, applied as one Graph::applyUpdates batch.
+    std::vector<TrafficChange> apply(Graph& g, int changes=4, int minDelta=-3, int maxDelta=6, bool log=true){
+        ScopedTimer timer(kTimeSimulate);
+        std::vector<TrafficChange> out = draw(g, changes, minDelta, maxDelta);
+        g.applyUpdates(out);
+        if(log) appendLog(g, out);
+        return out;
+    }
+
+    // Same, published as one new generation while readers keep routing.
+    std::vector<TrafficChange> apply(LiveGraph& live, int changes=4, int minDelta=-3, int maxDelta=6, bool log=true){
+        ScopedTimer timer(kTimeSimulate);
+        std::vector<TrafficChange> out = draw(live.base(), changes, minDelta, maxDelta);
+        live.publish(out);
+        if(log) appendLog(live.base(), out);
+        return out;
+    }
+
+    // One whole-network step: every road moves by a CongestionKernel delta in
+    // [minDelta, maxDelta], then the graph is updated in one bulk write. For
+    // many what-if steps, run the kernel on g.edgeWeights() and write back once.
+    // Returns how many roads changed weight; with log, those are logged.
+    std::size_t applyAll(Graph& g, int minDelta=-3, int maxDelta=5, bool log=true){
+        ScopedTimer timer(kTimeSimulate);
+        std::vector<int> before = g.edgeWeights(), after = before;
+        CongestionKernel(bulkSeed, minDelta, maxDelta).apply(after.data(), after.size(), bulkStep++);
+        g.setEdgeWeights(after.data());
+        std::size_t changed = 0; std::string text; std::string ts = log ? nowTimestamp() : std::string();
+        for(EdgeId e=0; e<after.size(); ++e){
+            if(after[e]==before[e]) continue;
+            changed++;
+            if(log) appendTrafficLine(text, ts, g.name(g.edgeSource(e)), g.name(g.edgeTarget(e)), after[e]-before[e], after[e]);
         }
-        appendLog(out); return out;
+        if(log) writeLog(text);
+        return changed;
     }
 
-    void appendLog(const std::vector<TrafficChange>& changes){
-        std::ofstream out(logPath, std::ios::app); if(!out.is_open()) return;
-        for(auto &c: changes){ out << c.u << ' ' << c.v << ' ' << c.delta << ' ' << c.newWeight << "\n"; }
+    void appendLog(const Graph& g, const std::vector<TrafficChange>& changes){
+        std::string text, ts = nowTimestamp();
+        for(auto &c: changes) appendTrafficLine(text, ts, g.name(c.u), g.name(c.v), c.delta, c.newWeight);
+        writeLog(text);
     }
 
     static double averageDelta(const std::vector<TrafficChange>& v){ if(v.empty()) return 0.0; long long s=0; for(auto &c:v) s+=c.delta; return (double)s/v.size(); }
+
+private:
+    void writeLog(const std::string& text){
+        if(text.empty()) return;
+        std::ofstream out(logPath, std::ios::app); if(out.is_open()) out.write(text.data(), (std::streamsize)text.size());
+    }
+
+    std::vector<TrafficChange> draw(const Graph& g, int changes, int minDelta, int maxDelta){
+        std::vector<TrafficChange> out; if(g.edgeCount()==0) return out;
+        std::uniform_int_distribution<EdgeId> idx(0,(EdgeId)g.edgeCount()-1); std::uniform_int_distribution<int> del(minDelta,maxDelta);
+        out.reserve(changes);
+        for(int i=0;i<changes;i++){
+            EdgeId e = idx(rng); int d = del(rng); if(d==0) d=1;
+            out.push_back({g.edgeSource(e), g.edgeTarget(e), d, 0, e});
+        }
+        return out;
+    }
 };
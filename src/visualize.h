@@ -31,12 +31,12 @@ inline void sleepms(int ms){ Sleep(ms); }
 inline void sleepms(int ms){ std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
 #endif
 
-struct Layout{ int H=17,W=40; std::map<char,std::pair<int,int>> pos; };
+struct Layout{ int H=17,W=40; std::map<std::string,std::pair<int,int>> pos; };
 
 inline Layout defaultLayout(){ Layout L; 
-    L.pos['A']={2,4}; L.pos['B']={2,18}; L.pos['C']={6,4}; L.pos['D']={6,18};
-    L.pos['E']={6,30}; L.pos['F']={2,30}; L.pos['G']={11,12}; L.pos['H']={11,30};
-    L.pos['I']={14,6}; L.pos['J']={14,20};
+    L.pos["A"]={2,4}; L.pos["B"]={2,18}; L.pos["C"]={6,4}; L.pos["D"]={6,18};
+    L.pos["E"]={6,30}; L.pos["F"]={2,30}; L.pos["G"]={11,12}; L.pos["H"]={11,30};
+    L.pos["I"]={14,6}; L.pos["J"]={14,20};
     return L; }
 
 inline void drawLine(std::vector<std::string>& grid, int y1,int x1,int y2,int x2){
@@ -45,12 +45,12 @@ inline void drawLine(std::vector<std::string>& grid, int y1,int x1,int y2,int x2
     else { int dy=(y2>y1)?1:-1, dx=(x2>x1)?1:-1; int y=y1+dy,x=x1+dx; while(y!=y2 && x!=x2){ grid[y][x]=(dx==dy?'/':'\\'); y+=dy; x+=dx; } }
 }
 
-inline void drawCity(const Graph& g, const std::vector<char>& highlightPath={}){
+inline void drawCity(const Graph& g, const std::vector<NodeId>& highlightPath={}){
     using namespace std; auto L=defaultLayout(); vector<string> grid(L.H, string(L.W,' '));
-    auto edges=g.edgesUniqueUndirected(); for(auto &t: edges){ char u,v; int w; std::tie(u,v,w)=t; auto pu=L.pos.count(u)?L.pos.at(u):make_pair(0,0); auto pv=L.pos.count(v)?L.pos.at(v):make_pair(0,0); drawLine(grid, pu.first,pu.second,pv.first,pv.second);} 
-    for(auto &kv: L.pos) grid[kv.second.first][kv.second.second]=kv.first;
+    auto edges=g.edgesUniqueUndirected(); for(auto &t: edges){ NodeId a,b; int w; std::tie(a,b,w)=t; const string &u=g.name(a), &v=g.name(b); auto pu=L.pos.count(u)?L.pos.at(u):make_pair(0,0); auto pv=L.pos.count(v)?L.pos.at(v):make_pair(0,0); drawLine(grid, pu.first,pu.second,pv.first,pv.second);} 
+    for(auto &kv: L.pos) grid[kv.second.first][kv.second.second]=kv.first[0];
     cout << UI::BLUE << "\n    CITY MAP" << UI::RESET << "\n"; for(auto &row: grid) cout<<row<<"\n";
-    if(!highlightPath.empty()){ cout<< UI::CYAN << "\nPath: "; for(size_t i=0;i<highlightPath.size();++i){ cout<<highlightPath[i]; if(i+1<highlightPath.size()) cout<<" -> "; } cout<< UI::RESET << "\n"; }
+    if(!highlightPath.empty()){ cout<< UI::CYAN << "\nPath: "; for(size_t i=0;i<highlightPath.size();++i){ cout<<g.name(highlightPath[i]); if(i+1<highlightPath.size()) cout<<" -> "; } cout<< UI::RESET << "\n"; }
 }
 
 inline void loading(const std::string& label, int ms=600){ using namespace std; cout<<UI::YELLOW<<label<<UI::RESET<<"\n"; const int N=22; for(int i=0;i<=N;i++){ int pct=(i*100)/N; cout << "["; for(int j=0;j<i;j++) cout<<"#"; for(int j=i;j<N;j++) cout<<" "; cout << "] "<<pct<<"%\r"; cout.flush(); sleepms(ms/N);} cout<<"\n"; }
@@ -0,0 +1,28 @@
+#include "../src/graph.h"
+#include "../src/dijkstra.h"
+#include "../src/batch_router.h"
+#include <iostream>
+#include <random>
+// Batch routes and the distance matrix must match serial dijkstra() for every
+// thread count, including pairs with unknown or unreachable nodes.
+int main(){
+    Graph g; std::mt19937 rng(3); int n=400;
+    for(int i=0;i<n;i++) g.addNode(std::to_string(i));
+    std::uniform_int_distribution<int> pick(0,n-1), w(1,20);
+    for(int i=0;i<n*2;i++) g.addEdge((NodeId)pick(rng),(NodeId)pick(rng),w(rng));
+    std::vector<std::pair<NodeId,NodeId>> pairs; for(int i=0;i<500;i++) pairs.push_back({(NodeId)pick(rng),(NodeId)pick(rng)});
+    pairs.push_back({0, kInvalidNode});
+    std::vector<NodeId> src, dst; for(int i=0;i<30;i++) src.push_back(pick(rng)); for(int i=0;i<40;i++) dst.push_back(pick(rng)); dst.push_back(dst[0]);
+    for(unsigned threads: {1u, 3u, 8u}){
+        BatchRouter br(g, threads);
+        auto res=br.route(pairs);
+        for(size_t i=0;i<pairs.size();i++){
+            auto ref=dijkstra(g,pairs[i].first,pairs[i].second);
+            if(res[i].distance!=ref.distance || (ref.distance!=SearchWorkspace::INF && (res[i].path.front()!=pairs[i].first || res[i].path.back()!=pairs[i].second))){ std::cout<<"route failed ("<<threads<<" threads)\n"; return 1; }
+        }
+        auto m=br.matrix(src,dst);
+        for(size_t i=0;i<src.size();i++) for(size_t j=0;j<dst.size();j++)
+            if(m.at(i,j)!=dijkstra(g,src[i],dst[j]).distance){ std::cout<<"matrix failed ("<<threads<<" threads)\n"; return 1; }
+    }
+    std::cout<<"OK\n"; return 0;
+}
@@ -0,0 +1,45 @@
+#include "../src/graph.h"
+#include "../src/dijkstra.h"
+#include "../src/contraction_hierarchy.h"
+#include <iostream>
+#include <random>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+// Randomized cross-check: CH distances and unpacked paths must match dijkstra();
+// damaged hierarchy files are rejected on load.
+static std::string slurp(const char* path){ std::ifstream in(path, std::ios::binary); std::stringstream ss; ss<<in.rdbuf(); return ss.str(); }
+static int minWeight(const Graph& g, NodeId a, NodeId b){ int w=-1; for(auto e: g.neighbors(a)) if(e.v==b && (w<0 || e.w<w)) w=e.w; return w; }
+int main(){
+    for(unsigned seed=1; seed<=6; seed++){
+        std::mt19937 rng(seed); int n=50+40*seed; Graph g;
+        for(int i=0;i<n;i++) g.addNode(std::to_string(i));
+        std::uniform_int_distribution<int> pick(0,n-1), w(1,20);
+        for(int i=0;i<n*2;i++) g.addEdge((NodeId)pick(rng),(NodeId)pick(rng),w(rng));   // includes parallel roads and gaps
+        ContractionHierarchy ch = ContractionHierarchy::build(g);
+        if(seed==1){
+            if(!ch.save("test_ch.bin")){ std::cout<<"save failed\n"; return 1; }
+            ContractionHierarchy l; if(!l.load("test_ch.bin") || !l.matches(g) || l.arcCount()!=ch.arcCount()){ std::cout<<"load failed\n"; return 1; }
+            // Truncated, oversized or corrupted files fail and leave the loaded hierarchy alone.
+            std::string good=slurp("test_ch.bin"), bad;
+            auto rejects=[&](const std::string& bytes){ { std::ofstream out("test_ch.bin", std::ios::binary); out<<bytes; } return !l.load("test_ch.bin") && l.matches(g) && l.arcCount()==ch.arcCount(); };
+            bool ok=rejects(good.substr(0, good.size()-5)) && rejects(good.substr(0, 20));
+            bad=good; std::uint32_t huge=0xFFFFFFFFu; std::memcpy(&bad[8], &huge, 4); ok=ok && rejects(bad);          // node count
+            bad=good; std::uint32_t far=(std::uint32_t)n+5; std::memcpy(&bad[bad.size()-12], &far, 4); ok=ok && rejects(bad);   // last arc's head
+            bad=good; std::memcpy(&bad[28+4*n+4*n], &far, 4); ok=ok && rejects(bad);   // offset[n] != arc count
+            bad=good; std::uint32_t zero=0; std::memcpy(&bad[28+4*n+4], &zero, 4); std::memcpy(&bad[28+4*n+8], &huge, 4); ok=ok && rejects(bad);   // offsets not monotone
+            if(!ok){ std::cout<<"corrupt file accepted\n"; return 1; }
+            std::remove("test_ch.bin"); ch=l;
+        }
+        ChQuery q(ch);
+        for(int i=0;i<300;i++){
+            NodeId s=pick(rng), t=pick(rng); auto ref=dijkstra(g,s,t); auto got=q.route(s,t);
+            if(ref.distance!=got.distance){ std::cout<<"distance failed seed "<<seed<<" "<<s<<"->"<<t<<": "<<got.distance<<" vs "<<ref.distance<<"\n"; return 1; }
+            if(ref.distance==SearchWorkspace::INF) continue;
+            int len=0; for(size_t k=0;k+1<got.path.size();k++){ int e=minWeight(g,got.path[k],got.path[k+1]); if(e<0){ std::cout<<"path not a road\n"; return 1; } len+=e; }
+            if(got.path.front()!=s || got.path.back()!=t || len!=ref.distance){ std::cout<<"unpack failed\n"; return 1; }
+        }
+    }
+    std::cout<<"OK\n"; return 0;
+}
@@ -0,0 +1,55 @@
+#include "../src/graph.h"
+#include "../src/city_generator.h"
+#include <iostream>
+#include <vector>
+#include <set>
+#include <tuple>
+#include <cstdio>
+// Synthetic cities: every kind is connected, simple and reproducible from its
+// seed, roads have sane minutes, the scale-free kind grows hubs, and the
+// written map and places load back into the same Graph as buildCity.
+static bool connected(const Graph& g){
+    std::vector<char> seen(g.nodeCount(), 0); std::vector<NodeId> stack{0}; seen[0]=1; std::size_t n=1;
+    while(!stack.empty()){ NodeId u=stack.back(); stack.pop_back(); for(auto e: g.neighbors(u)) if(!seen[e.v]){ seen[e.v]=1; n++; stack.push_back(e.v); } }
+    return n==g.nodeCount();
+}
+static std::vector<std::tuple<NodeId,NodeId,int>> roadsOf(const CitySpec& s){
+    std::vector<std::tuple<NodeId,NodeId,int>> r; CityGenerator(s).roads([&](NodeId u, NodeId v, int w){ r.emplace_back(u,v,w); }); return r;
+}
+int main(){
+    for(CityKind kind: {CityKind::Grid, CityKind::Geometric, CityKind::ScaleFree}){
+        for(std::size_t n: {3u, 10u, 997u, 20000u}){
+            CitySpec s; s.kind=kind; s.nodes=n; s.seed=42;
+            auto roads=roadsOf(s);
+            if(roads!=roadsOf(s)){ std::cout<<cityKindName(kind)<<" not reproducible\n"; return 1; }
+            std::set<std::pair<NodeId,NodeId>> seen;
+            for(auto &r: roads){
+                NodeId u=std::get<0>(r), v=std::get<1>(r);
+                if(u==v || u>=n || v>=n || std::get<2>(r)<1 || !seen.insert({std::min(u,v), std::max(u,v)}).second){ std::cout<<cityKindName(kind)<<" bad road "<<u<<"-"<<v<<"\n"; return 1; }
+            }
+            Graph g; buildCity(g, s);
+            if(g.nodeCount()!=n || g.edgeCount()!=roads.size() || !connected(g) || !g.allCoords()){ std::cout<<cityKindName(kind)<<" "<<n<<" not a connected city\n"; return 1; }
+            s.seed=43; if(n>100 && roadsOf(s)==roads && kind!=CityKind::Grid){ std::cout<<cityKindName(kind)<<" ignores its seed\n"; return 1; }
+        }
+    }
+    CitySpec grid; grid.nodes=10000; Graph g; buildCity(g, grid);
+    if(g.edgeCount()!=2*100*99 || g.degree(0)!=2 || g.degree(101)!=4){ std::cout<<"grid shape failed\n"; return 1; }
+    CitySpec geo; geo.kind=CityKind::Geometric; geo.nodes=10000; buildCity(g, geo);
+    double avg=2.0*g.edgeCount()/g.nodeCount(); if(avg<3 || avg>6){ std::cout<<"geometric degree "<<avg<<"\n"; return 1; }
+    CitySpec sf; sf.kind=CityKind::ScaleFree; sf.nodes=10000; buildCity(g, sf);
+    std::size_t hub=0; for(NodeId u=0;u<g.nodeCount();u++) hub=std::max(hub, g.degree(u));
+    if(g.edgeCount()!=3+2*(10000-3) || hub<50){ std::cout<<"scale-free shape failed ("<<hub<<")\n"; return 1; }
+
+    geo.nodes=5000; Graph built, loaded; buildCity(built, geo);
+    if(!writeCityMap(geo, "test_city_map.txt", "test_city_places.txt") || !loaded.loadFromFile("test_city_map.txt") || !loaded.loadPlaces("test_city_places.txt")){ std::cout<<"write failed\n"; return 1; }
+    if(loaded.nodeCount()!=built.nodeCount() || loaded.edgeCount()!=built.edgeCount()){ std::cout<<"reload counts failed\n"; return 1; }
+    for(NodeId u=0;u<built.nodeCount();u++){
+        NodeId l=loaded.id(built.name(u));
+        if(l==kInvalidNode || loaded.degree(l)!=built.degree(u) || std::abs(loaded.lat(l)-built.lat(u))>1e-6){ std::cout<<"reload failed at "<<u<<"\n"; return 1; }
+    }
+    for(EdgeId e=0;e<built.edgeCount();e++)
+        if(loaded.getWeight(loaded.id(built.name(built.edgeSource(e))), loaded.id(built.name(built.edgeTarget(e))))!=built.edgeWeight(e)){ std::cout<<"reload weight failed\n"; return 1; }
+    std::remove("test_city_map.txt"); std::remove("test_city_places.txt");
+    CityKind k; if(!parseCityKind("geo", k) || k!=CityKind::Geometric || parseCityKind("mesh", k)){ std::cout<<"kind parsing failed\n"; return 1; }
+    std::cout<<"OK\n"; return 0;
+}
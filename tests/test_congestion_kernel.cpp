@@ -0,0 +1,44 @@
+#include "../src/graph.h"
+#include "../src/congestion_kernel.h"
+#include "../src/traffic_simulator.h"
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <cstdio>
+// Bulk congestion: the blocked kernel matches the scalar definition however
+// it is split or threaded, deltas cover their range, and whole-network steps
+// round-trip through Graph and the batched traffic log.
+int main(){
+    std::mt19937 rng(5); std::uniform_int_distribution<int> w0(1,30);
+    std::vector<int> base(300007); for(int &x: base) x=w0(rng);
+    CongestionKernel k(0x1234567890abcdefULL, -4, 6);
+    for(std::uint64_t step: {0ULL, 1ULL, 77ULL, 1ULL<<40}){
+        std::vector<int> ref=base, whole=base, split=base, par=base;
+        for(std::size_t i=0;i<ref.size();i++) ref[i]=std::max(1, ref[i]+k.delta(step, i));
+        k.apply(whole.data(), whole.size(), step);
+        for(std::size_t b=0;b<split.size(); b+=1+b%37) k.apply(split.data()+b, std::min<std::size_t>(1+b%37, split.size()-b), step, b);
+        ThreadPool pool(3); k.apply(par, step, pool);
+        if(whole!=ref || split!=ref || par!=ref){ std::cout<<"kernel mismatch at step "<<step<<"\n"; return 1; }
+    }
+    std::vector<int> hist(11,0); long long sum=0; int n=200000;
+    for(int i=0;i<n;i++){ int d=k.delta(3, i); if(d<-4 || d>6){ std::cout<<"range failed\n"; return 1; } hist[d+4]++; sum+=d; }
+    for(int c: hist) if(c<n/11*9/10 || c>n/11*11/10){ std::cout<<"distribution failed\n"; return 1; }
+    int same=0; for(int i=0;i<1000;i++) same+=k.delta(3,i)==k.delta(4,i);
+    if(same>200 || CongestionKernel(1).delta(0,5)!=CongestionKernel(1).delta(0,5) || CongestionKernel(9,2,2).delta(5,5)!=2){ std::cout<<"steps failed\n"; return 1; }
+
+    Graph g; g.addEdge("A","B",4); g.addEdge("B","C",6); g.addEdge("A","B",9); g.addEdge("C","D",2);
+    std::vector<int> w=g.edgeWeights();
+    if(w!=std::vector<int>({4,6,9,2})){ std::cout<<"edgeWeights failed\n"; return 1; }
+    std::uint64_t v=g.weightVersion(); w={7,1,3,5}; g.setEdgeWeights(w.data());
+    if(g.weightVersion()!=v+1 || g.edgeWeight(2)!=3 || g.getWeight(g.id("C"),g.id("B"))!=1 || g.getWeight(g.id("D"),g.id("C"))!=5){ std::cout<<"setEdgeWeights failed\n"; return 1; }
+
+    Graph a=g, b=g; std::remove("test_ck.log");
+    TrafficSimulator s1("test_ck.log"), s2(""); s1.seed(42); s2.seed(42);
+    std::size_t changed=0; for(int i=0;i<5;i++){ changed+=s1.applyAll(a); s2.applyAll(b, -3, 5, false); }
+    if(a.edgeWeights()!=b.edgeWeights() || a.edgeWeights()==g.edgeWeights()){ std::cout<<"simulator steps failed\n"; return 1; }
+    for(NodeId u=0;u<a.nodeCount();u++) for(auto e: a.neighbors(u)) if(e.w<1 || a.getWeight(e.v,u)<1){ std::cout<<"clamp failed\n"; return 1; }
+    std::ifstream in("test_ck.log"); std::string line; std::size_t lines=0; while(std::getline(in,line)) lines++;
+    in.close(); std::remove("test_ck.log");
+    if(lines!=changed || changed==0){ std::cout<<"log failed "<<lines<<" vs "<<changed<<"\n"; return 1; }
+    std::cout<<"OK\n"; return 0;
+}
@@ -0,0 +1,37 @@
+#include "../src/graph.h"
+#include "../src/dijkstra.h"
+#include "../src/dynamic_sssp.h"
+#include <iostream>
+#include <random>
+// Repaired trees must match a from-scratch rebuild after every batch of
+// traffic changes, including big slowdowns that cut whole subtrees, and
+// fall back to a rebuild when the graph changed beyond the reported batch.
+static int minWeight(const Graph& g, NodeId a, NodeId b){ int w=-1; for(auto e: g.neighbors(a)) if(e.v==b && (w<0 || e.w<w)) w=e.w; return w; }
+int main(){
+    for(unsigned seed=1; seed<=4; seed++){
+        std::mt19937 rng(seed); int n=100*seed; Graph g;
+        for(int i=0;i<n;i++) g.addNode(std::to_string(i));
+        std::uniform_int_distribution<int> pick(0,n-1), w(1,20), del(-15,40), batch(1,8);
+        for(int i=0;i<n*2;i++) g.addEdge((NodeId)pick(rng),(NodeId)pick(rng),w(rng));
+        auto edges=g.edgesUniqueUndirected(); std::uniform_int_distribution<int> idx(0,(int)edges.size()-1);
+        ShortestPathTree tree(g), ref(g); tree.build((NodeId)pick(rng));
+        RouteTracker tracker(g); NodeId s=pick(rng), t=pick(rng); tracker.track(s,t);
+        for(int round=0; round<200; round++){
+            std::vector<TrafficChange> changes;
+            for(int k=batch(rng); k>0; k--){ auto e=edges[idx(rng)]; changes.push_back({std::get<0>(e), std::get<1>(e), del(rng), 0}); }
+            g.applyUpdates(changes);
+            // Every tenth round also edits a road behind the tree's back: repair must notice and rebuild.
+            if(round%10==9){ auto e=edges[idx(rng)]; g.addWeightDelta(std::get<0>(e), std::get<1>(e), -10); }
+            tree.repair(changes); ref.build(tree.source());
+            if(!tree.isCurrent() || tree.distances()!=ref.distances()){ std::cout<<"repair failed seed "<<seed<<" round "<<round<<"\n"; return 1; }
+            std::vector<NodeId> p;
+            for(NodeId v=0; v<(NodeId)n; v+=7){
+                tree.path(v,p); if(p.empty()) continue; int len=0;
+                for(size_t k=0;k+1<p.size();k++){ int e=minWeight(g,p[k],p[k+1]); if(e<0){ std::cout<<"tree arc not a road\n"; return 1; } len+=e; }
+                if(p.front()!=tree.source() || len!=tree.distance(v)){ std::cout<<"tree path failed\n"; return 1; }
+            }
+            auto &r=tracker.update(changes); if(r[0].distance!=dijkstra(g,s,t).distance){ std::cout<<"tracker failed\n"; return 1; }
+        }
+    }
+    std::cout<<"OK\n"; return 0;
+}
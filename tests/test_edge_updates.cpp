@@ -0,0 +1,35 @@
+#include "../src/graph.h"
+#include "../src/traffic_simulator.h"
+#include <iostream>
+#include <cstdio>
+// EdgeIds stay put across rebuilds and snapshots, both arcs of a road always
+// agree, and applyUpdates matches one-at-a-time updates.
+static bool consistent(const Graph& g){
+    for(EdgeId e=0; e<g.edgeCount(); ++e){
+        NodeId u=g.edgeSource(e), v=g.edgeTarget(e); bool fwd=false, back=false;
+        for(auto x: g.neighbors(u)) if(x.v==v && x.w==g.edgeWeight(e)) fwd=true;
+        for(auto x: g.neighbors(v)) if(x.v==u && x.w==g.edgeWeight(e)) back=true;
+        if(!fwd || !back || g.arcEdge(g.edgeArc(e))!=e) return false;
+    }
+    return true;
+}
+int main(){
+    Graph g; g.addEdge("A","B",4); g.addEdge("B","C",6); g.addEdge("B","A",9); g.addEdge("C","C",1); g.addEdge("C","D",2);
+    NodeId a=g.id("A"), b=g.id("B"), c=g.id("C"), d=g.id("D");
+    if(g.edgeCount()!=4 || g.edgeSource(2)!=b || g.edgeTarget(2)!=a || g.edgeWeight(2)!=9 || g.findEdge(d,c)!=3 || g.findEdge(a,d)!=kInvalidEdge || !consistent(g)){ std::cout<<"ids failed\n"; return 1; }
+    g.setWeight(2, 5); if(g.edgeWeight(2)!=5 || g.edgeWeight(0)!=4 || !consistent(g)){ std::cout<<"setWeight(edge) failed\n"; return 1; }
+    g.addWeightDelta(a,b,-10); if(g.edgeWeight(0)!=1 || g.edgeWeight(2)!=1 || !consistent(g)){ std::cout<<"pair update failed\n"; return 1; }
+    g.addEdge("D","E",7); g.addEdge("A","E",3);   // rebuild keeps old ids
+    if(g.edgeCount()!=6 || g.edgeSource(3)!=c || g.edgeWeight(1)!=6 || g.findEdge(g.id("E"),a)!=5 || !consistent(g)){ std::cout<<"rebuild failed\n"; return 1; }
+    std::uint64_t v0=g.weightVersion();
+    std::vector<TrafficChange> batch={{0,0,4,0,1}, {c,d,-1,0}, {0,0,3,0,77}, {a,d,2,0}, {0,0,-20,0,5}};
+    if(g.applyUpdates(batch)!=3 || g.weightVersion()!=v0+1 || batch[0].newWeight!=10 || batch[1].newWeight!=1 || batch[2].newWeight!=-1 || batch[3].newWeight!=-1 || g.edgeWeight(5)!=1 || !consistent(g)){ std::cout<<"applyUpdates failed\n"; return 1; }
+    if(!g.saveSnapshot("test_edges.bin")){ std::cout<<"save failed\n"; return 1; }
+    Graph s; if(!s.loadFromFile("test_edges.bin") || s.edgeCount()!=6 || s.edgeSource(4)!=g.edgeSource(4) || s.edgeWeight(1)!=10 || s.findEdge(a,g.id("E"))!=5 || !consistent(s)){ std::cout<<"snapshot failed\n"; return 1; }
+    s.setWeight(4, 42); if(s.edgeWeight(4)!=42 || !consistent(s)){ std::cout<<"snapshot update failed\n"; return 1; }
+    std::remove("test_edges.bin");
+    TrafficSimulator sim("test_edges.log"); auto ch=sim.apply(g, 50, -3, 6, false);
+    std::vector<int> last(g.edgeCount(), -1); for(auto &x: ch){ if(x.edge>=g.edgeCount() || x.newWeight<1 || x.u!=g.edgeSource(x.edge)){ std::cout<<"simulator failed\n"; return 1; } last[x.edge]=x.newWeight; }
+    for(EdgeId e=0; e<g.edgeCount(); ++e) if(last[e]!=-1 && last[e]!=g.edgeWeight(e)){ std::cout<<"simulator weights failed\n"; return 1; }
+    std::cout<<"OK\n"; return 0;
+}
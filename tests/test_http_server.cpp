@@ -0,0 +1,131 @@
+#include "../src/graph.h"
+#include "../src/dijkstra.h"
+#include "../src/http_server.h"
+#include "../src/route_service.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <ctime>
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+#include <string>
+#include <fstream>
+#include <cstdio>
+// End to end over loopback: routes match dijkstra(), POST /traffic publishes
+// a generation that later routes see, pipelined requests answer in order,
+// and malformed or unknown requests fail cleanly without killing the server.
+static bool has(const std::string& s, const std::string& sub){ if(s.find(sub)!=std::string::npos) return true; std::cout<<"missing: "<<sub<<" in "<<s<<"\n"; return false; }
+int main(){
+    Graph g; std::mt19937 rng(12); int n=300;
+    for(int i=0;i<n;i++) g.addNode("n"+std::to_string(i));
+    std::uniform_int_distribution<int> pick(0,n-1), w(1,20);
+    for(int i=0;i<n*3;i++) g.addEdge((NodeId)pick(rng),(NodeId)pick(rng),w(rng));
+    g.freeze();
+    { std::ofstream od("test_http_od.txt"); od<<"n1 n2 500\nn7 n40 300\n"; }
+    RouteService service(g, 3, "web", "", "test_http_od.txt");
+    HttpServer server([&service](const HttpRequest& req, HttpResponse& res, unsigned wk){ service.handle(req, res, wk); }, 3);
+    if(!server.listen(0)){ std::cout<<"listen failed\n"; return 1; }
+    std::thread loop([&]{ server.run(); });
+    int status; std::string body, pending;
+    net::SocketFd s = net::connectTo("127.0.0.1", server.port());
+    if(s==net::kBadSocket){ std::cout<<"connect failed\n"; return 1; }
+    auto get=[&](const std::string& raw){ return net::sendAll(s, raw) && net::readResponse(s, pending, status, body); };
+
+    std::vector<std::pair<NodeId,NodeId>> asked;
+    for(int q=0;q<50;q++){
+        NodeId a=pick(rng), b=pick(rng); asked.push_back({a, b}); const char* mode = q%3==0 ? "astar" : q%3==1 ? "bidirectional" : "dijkstra";
+        if(!get("GET /route?from=n"+std::to_string(a)+"&to=n"+std::to_string(b)+"&mode="+mode+" HTTP/1.1\r\nHost: x\r\n\r\n")){ std::cout<<"route io failed\n"; return 1; }
+        auto ref=dijkstra(g,a,b);
+        if(ref.distance==SearchWorkspace::INF ? !has(body, "No path found") : (status!=200 || !has(body, "\"distance\": "+std::to_string(ref.distance)))) return 1;
+    }
+    {   // Repeats come from the route cache.
+        std::uint64_t hits=service.routeCache().stats().hits;
+        for(auto &p: asked) if(!get("GET /route?from=n"+std::to_string(p.first)+"&to=n"+std::to_string(p.second)+" HTTP/1.1\r\n\r\n")) return 1;
+        if(service.routeCache().stats().hits<hits+asked.size()/2){ std::cout<<"route cache failed\n"; return 1; }
+    }
+    if(!get("GET /route?from=n1&to=nowhere HTTP/1.1\r\n\r\n") || status!=404) { std::cout<<"unknown place failed\n"; return 1; }
+    if(!get("GET /route?from=n1&to=n2&mode=teleport HTTP/1.1\r\n\r\n") || status!=400) { std::cout<<"bad mode failed\n"; return 1; }
+    {   // k alternatives come from KShortestPaths on the pinned weights
+        KShortestPaths ksp(g); auto alts=ksp.route(1, 2, 4);
+        if(!get("GET /route?from=n1&to=n2&alternatives=4 HTTP/1.1\r\n\r\n") || status!=200 || !has(body, "\"alternatives\": [")) return 1;
+        for(auto &r: alts) if(!has(body, "\"distance\": "+std::to_string(r.distance)+"}")) return 1;
+        if(!get("GET /route?from=n1&to=n2&alternatives=0 HTTP/1.1\r\n\r\n") || status!=400) { std::cout<<"bad alternatives failed\n"; return 1; }
+    }
+    if(!get("DELETE /graph HTTP/1.1\r\n\r\n") || status!=405) { std::cout<<"method failed\n"; return 1; }
+    if(!get("GET /graph HTTP/1.1\r\n\r\n") || !has(body, "\"version\": "+std::to_string(g.weightVersion()))) return 1;
+
+    // A traffic step moves the version and later routes see its weights.
+    Graph mirror=g; std::uint64_t v0=g.weightVersion();
+    if(!get("POST /traffic?changes=200 HTTP/1.1\r\nContent-Length: 0\r\n\r\n") || status!=200 || !has(body, "\"base\": "+std::to_string(v0)) || !has(body, "\"version\": "+std::to_string(v0+1))) return 1;
+    {
+        LiveGraph::Reader r(service.live()); LiveGraph::Pin p(r);
+        for(EdgeId e=0;e<g.edgeCount();e++) mirror.setWeight(e, p->edgeWeight(e));
+    }
+    if(!get("GET /traffic HTTP/1.1\r\n\r\n") || !has(body, "\"version\": "+std::to_string(v0+1))) return 1;
+    // Assignment runs on the newest generation and is cached per version.
+    if(!get("GET /assignment HTTP/1.1\r\n\r\n") || status!=200 || !has(body, "\"version\": "+std::to_string(v0+1)) || !has(body, "\"ratio\": ")) return 1;
+    std::string first=body;
+    if(!get("GET /assignment.json HTTP/1.1\r\n\r\n") || body!=first){ std::cout<<"assignment cache failed\n"; return 1; }
+    std::remove("test_http_od.txt");
+    // Metrics saw the routes above, in both formats.
+    if(!get("GET /metrics HTTP/1.1\r\n\r\n") || status!=200 || !has(body, "# TYPE traffic_latency_seconds histogram") || !has(body, "traffic_search_queries_total{search=\"astar\"} ")) return 1;
+    if(!get("GET /metrics.json HTTP/1.1\r\n\r\n") || status!=200 || !has(body, "\"alternatives\": {\"queries\": ") || !has(body, "\"assign\": {\"count\": 1")) return 1;
+    if(service.routeCache().stats().dropped==0){ std::cout<<"traffic kept every cached route\n"; return 1; }
+    for(int q=0;q<20+(int)asked.size();q++){   // then the cached pairs again, on the new weights
+        NodeId a=pick(rng), b=pick(rng); if(q>=20){ a=asked[q-20].first; b=asked[q-20].second; }
+        auto ref=dijkstra(mirror,a,b);
+        if(!get("GET /route?from=n"+std::to_string(a)+"&to=n"+std::to_string(b)+" HTTP/1.1\r\n\r\n")) return 1;
+        if(ref.distance!=SearchWorkspace::INF && !has(body, "\"distance\": "+std::to_string(ref.distance))) return 1;
+    }
+
+    // Pipelining: three requests in one write, answered in order.
+    std::string three = "GET /route?from=n1&to=n1 HTTP/1.1\r\n\r\nGET /nope.txt HTTP/1.1\r\n\r\nGET /route?from=n2&to=n2 HTTP/1.1\r\n\r\n";
+    if(!net::sendAll(s, three)) return 1;
+    int st[3]; std::string b3[3]; for(int i=0;i<3;i++) if(!net::readResponse(s, pending, st[i], b3[i])){ std::cout<<"pipeline io failed\n"; return 1; }
+    if(st[0]!=200 || !has(b3[0], "[\"n1\"]") || st[1]!=404 || !has(b3[2], "[\"n2\"]")) return 1;
+
+    // Garbage closes that connection only; traversal never leaves the web root.
+    net::SocketFd bad = net::connectTo("127.0.0.1", server.port()); std::string pend2;
+    if(!net::sendAll(bad, "HELLO\r\n\r\n") || !net::readResponse(bad, pend2, status, body) || status!=400){ std::cout<<"bad request failed\n"; return 1; }
+    net::closeSocket(bad);
+    if(!get("GET /../src/graph.h HTTP/1.1\r\n\r\n") || status!=404) { std::cout<<"traversal failed\n"; return 1; }
+    if(!get("GET /route?from=n3&to=n4 HTTP/1.1\r\nConnection: close\r\n\r\n") || status!=200) return 1;
+    char c; if(recv(s, &c, 1, 0)!=0){ std::cout<<"connection close failed\n"; return 1; }
+    net::closeSocket(s);
+
+    server.stop(); loop.join();
+
+    {   // Input streamed past one request's worth while a slow one runs: 413, then closed
+        HttpServer slow([](const HttpRequest&, HttpResponse& res, unsigned){ std::this_thread::sleep_for(std::chrono::milliseconds(300)); res.body = "{}\n"; }, 1);
+        if(!slow.listen(0)){ std::cout<<"listen failed\n"; return 1; }
+        std::thread loop2([&]{ slow.run(); });
+        net::SocketFd f = net::connectTo("127.0.0.1", slow.port()); std::string pend3;
+        net::sendAll(f, "GET /slow HTTP/1.1\r\n\r\n" + std::string(HttpServer::kMaxBuffered + 65536, 'x'));
+        int s1 = 0, s2 = 0; std::string b1, b2;
+        if(!net::readResponse(f, pend3, s1, b1) || !net::readResponse(f, pend3, s2, b2) || s1!=200 || s2!=413){ std::cout<<"overflow failed: "<<s1<<" "<<s2<<"\n"; return 1; }
+        if(recv(f, &c, 1, 0)!=0){ std::cout<<"overflow close failed\n"; return 1; }
+        net::closeSocket(f); slow.stop(); loop2.join();
+    }
+#if !defined(_WIN32)
+    {   // Out of descriptors: the listener pauses instead of spinning, and resumes once a connection closes
+        HttpServer few([](const HttpRequest&, HttpResponse& res, unsigned){ res.body = "{}\n"; }, 1);
+        if(!few.listen(0)){ std::cout<<"listen failed\n"; return 1; }
+        std::thread loop3([&]{ few.run(); });
+        rlimit old; getrlimit(RLIMIT_NOFILE, &old);
+        int lowest = dup(0); close(lowest);
+        rlimit low = old; low.rlim_cur = lowest + 5; setrlimit(RLIMIT_NOFILE, &low);   // 3 clients + 2 accepted
+        net::SocketFd cl[3]; for(auto &x: cl) x = net::connectTo("127.0.0.1", few.port());
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        std::clock_t cpu = std::clock(); std::this_thread::sleep_for(std::chrono::milliseconds(300)); cpu = std::clock() - cpu;
+        std::string pend4; int st4 = 0; std::string b4;
+        bool ok = cl[2]!=net::kBadSocket && net::sendAll(cl[0], "GET / HTTP/1.1\r\n\r\n") && net::readResponse(cl[0], pend4, st4, b4) && st4==200;
+        net::closeSocket(cl[0]); pend4.clear();
+        ok = ok && net::sendAll(cl[2], "GET / HTTP/1.1\r\n\r\n") && net::readResponse(cl[2], pend4, st4, b4) && st4==200;
+        setrlimit(RLIMIT_NOFILE, &old);
+        if(!ok || cpu > CLOCKS_PER_SEC/10){ std::cout<<"descriptor exhaustion failed ("<<ok<<", cpu "<<cpu<<")\n"; return 1; }
+        net::closeSocket(cl[1]); net::closeSocket(cl[2]); few.stop(); loop3.join();
+    }
+#endif
+    std::cout<<"OK\n"; return 0;
+}
@@ -0,0 +1,44 @@
+#include "../src/graph.h"
+#include "../src/json_exporter.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cmath>
+// Number formatting, escaping, atomic replace, and delta contents.
+static std::string slurp(const char* path){ std::ifstream in(path); std::stringstream ss; ss<<in.rdbuf(); return ss.str(); }
+static bool has(const std::string& s, const std::string& sub){ if(s.find(sub)!=std::string::npos) return true; std::cout<<"missing: "<<sub<<"\n"; return false; }
+int main(){
+    { JsonWriter w("test_json.txt"); w.number(28.6139).raw(' ').number(-0.5).raw(' ').number(77.0).raw(' ').number(1e-7).raw(' ').number(-1e-7).raw(' ').number(0.1234567)
+        .raw(' ').integer(-2147483648LL).raw(' ').integer(0).raw(' ').str("a\"b\\c\n\x01")
+        .raw(' ').number(1e20).raw(' ').number(-2.5e19, 0).raw(' ').number(std::nan("")).raw(' ').number(-HUGE_VAL); if(!w.commit()){ std::cout<<"commit failed\n"; return 1; } }
+    if(slurp("test_json.txt")!="28.6139 -0.5 77 0 0 0.123457 -2147483648 0 \"a\\\"b\\\\c\\n\\u0001\" 1e+20 -2.5e+19 null null"){ std::cout<<"format failed: "<<slurp("test_json.txt")<<"\n"; return 1; }
+    { JsonWriter w("test_json.txt"); w.raw("partial"); }   // dropped without commit
+    if(slurp("test_json.txt").compare(0,7,"28.6139")!=0 || std::ifstream("test_json.txt.tmp").good()){ std::cout<<"atomic replace failed\n"; return 1; }
+    { JsonWriter w("test_json.txt"); for(int i=0;i<100000;i++) w.integer(i%10); w.commit(); }   // spans several buffer flushes
+    if(slurp("test_json.txt").size()!=100000){ std::cout<<"flush failed\n"; return 1; }
+
+    Graph g; g.addEdge("A","B",4); g.addEdge("B","C",6); g.addEdge("A","B",9); g.addEdge("C","D",2);
+    g.setPlace(g.id("A"), "Place \"A\"", 28.6139, 77.209);
+    if(!writeGraphJson(g, "test_json.txt")) return 1;
+    std::string full=slurp("test_json.txt");
+    { std::string mem; JsonWriter w(&mem); graphJson(g, w); w.commit(); if(mem!=full){ std::cout<<"string sink failed\n"; return 1; } }
+    if(!has(full, "\"version\": "+std::to_string(g.weightVersion())) || !has(full, "\"A\": {\"name\": \"Place \\\"A\\\"\", \"coords\": [28.6139, 77.209]}")
+       || !has(full, "{\"from\": \"A\", \"to\": \"B\", \"weight\": 9}") || !has(full, "\"D\": {\"name\": \"\", \"coords\": [0, 0]}")) return 1;
+    std::uint64_t base=g.weightVersion();
+    std::vector<TrafficChange> changes;
+    NodeId a=g.id("A"), b=g.id("B"), c=g.id("C");
+    g.addWeightDelta(b,a,3); changes.push_back({b,a,3,g.getWeight(b,a)});
+    g.addWeightDelta(a,b,-1); changes.push_back({a,b,-1,g.getWeight(a,b)});
+    g.addWeightDelta(c,b,5); changes.push_back({c,b,5,g.getWeight(c,b)});
+    if(!writeGraphDeltaJson(g, changes, base, "test_json.txt")) return 1;
+    std::string delta=slurp("test_json.txt");
+    if(!has(delta, "\"base\": "+std::to_string(base)) || !has(delta, "\"version\": "+std::to_string(g.weightVersion()))
+       || !has(delta, "{\"from\": \"A\", \"to\": \"B\", \"weights\": [6, 11]}") || !has(delta, "{\"from\": \"B\", \"to\": \"C\", \"weights\": [11]}") || delta.find("\"D\"")!=std::string::npos) return 1;
+    std::vector<PathResult> alts(2); alts[0].distance=17; alts[0].path={a,b,c}; alts[1].distance=22; alts[1].path={a,c};
+    if(!writeRouteJson(g, alts, "test_json.txt")) return 1;
+    std::string route=slurp("test_json.txt");
+    if(!has(route, "\"path\": [\"A\", \"B\", \"C\"],\n  \"distance\": 17") || !has(route, "{\"path\": [\"A\", \"C\"], \"distance\": 22}")) return 1;
+    std::remove("test_json.txt");
+    std::cout<<"OK\n"; return 0;
+}
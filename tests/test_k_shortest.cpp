@@ -0,0 +1,53 @@
+#include "../src/graph.h"
+#include "../src/dijkstra.h"
+#include "../src/k_shortest.h"
+#include <iostream>
+#include <random>
+#include <algorithm>
+// Yen's k shortest loopless paths against every simple path enumerated by DFS
+// on small random graphs with parallel roads.
+static int cheapest(const Graph& g, NodeId u, NodeId v){
+    int best=SearchWorkspace::INF; for(auto e: g.neighbors(u)) if(e.v==v) best=std::min(best, e.w); return best;
+}
+static void allPaths(const Graph& g, NodeId u, NodeId dst, int cost, std::vector<char>& on, std::vector<int>& out){
+    if(u==dst){ out.push_back(cost); return; }
+    on[u]=1;
+    std::vector<NodeId> next; for(auto e: g.neighbors(u)) if(!on[e.v]) next.push_back(e.v);
+    std::sort(next.begin(), next.end()); next.erase(std::unique(next.begin(), next.end()), next.end());
+    for(NodeId v: next) allPaths(g, v, dst, cost+cheapest(g,u,v), on, out);
+    on[u]=0;
+}
+int main(){
+    Graph g; g.addEdge("A","B",4); g.addEdge("B","D",4); g.addEdge("A","C",5); g.addEdge("C","D",5); g.addEdge("A","D",20); g.addNode("E");
+    KShortestPaths ksp(g);
+    auto r=ksp.route(g.id("A"), g.id("D"), 5);
+    if(r.size()!=3 || r[0].distance!=8 || r[1].distance!=10 || r[2].distance!=20 || r[2].path.size()!=2){ std::cout<<"small graph failed\n"; return 1; }
+    if(dijkstra(g, g.id("A"), g.id("D")).distance!=r[0].distance){ std::cout<<"first path failed\n"; return 1; }
+    auto self=ksp.route(g.id("A"), g.id("A"), 3);
+    if(self.size()!=1 || self[0].distance!=0 || self[0].path.size()!=1){ std::cout<<"src==dst failed\n"; return 1; }
+    if(!ksp.route(g.id("A"), g.id("E"), 3).empty() || !ksp.route(g.id("A"), g.id("D"), 0).empty()){ std::cout<<"unreachable failed\n"; return 1; }
+
+    std::mt19937 rng(13);
+    for(int round=0; round<60; round++){
+        int n=7+round%5; Graph r; for(int i=0;i<n;i++) r.addNode(std::to_string(i));
+        std::uniform_int_distribution<int> pick(0,n-1), w(1,round%3==0 ? 3 : 25);
+        for(int i=0;i<n*2;i++){ NodeId a=pick(rng), b=pick(rng); if(a!=b) r.addEdge(a,b,w(rng)); }
+        KShortestPaths k(r);
+        for(int q=0;q<6;q++){
+            NodeId s=pick(rng), t=pick(rng); if(s==t) continue;
+            std::vector<char> on(n,0); std::vector<int> all; allPaths(r, s, t, 0, on, all); std::sort(all.begin(), all.end());
+            int want=1+q%6; auto got=k.route(s, t, want);
+            if(got.size()!=std::min<std::size_t>(want, all.size())){ std::cout<<"count failed "<<got.size()<<" vs "<<all.size()<<"\n"; return 1; }
+            for(std::size_t i=0;i<got.size();i++){
+                const auto& p=got[i].path;
+                if(got[i].distance!=all[i] || p.front()!=s || p.back()!=t){ std::cout<<"cost failed "<<got[i].distance<<" vs "<<all[i]<<"\n"; return 1; }
+                std::vector<NodeId> sorted(p); std::sort(sorted.begin(), sorted.end());
+                if(std::adjacent_find(sorted.begin(), sorted.end())!=sorted.end()){ std::cout<<"loop failed\n"; return 1; }
+                int cost=0; for(std::size_t j=0;j+1<p.size();j++){ int c=cheapest(r,p[j],p[j+1]); if(c==SearchWorkspace::INF){ cost=-1; break; } cost+=c; }
+                if(cost!=got[i].distance){ std::cout<<"path failed\n"; return 1; }
+                for(std::size_t j=0;j<i;j++) if(got[j].path==p){ std::cout<<"duplicate failed\n"; return 1; }
+            }
+        }
+    }
+    std::cout<<"OK\n"; return 0;
+}
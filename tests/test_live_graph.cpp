@@ -0,0 +1,61 @@
+#include "../src/graph.h"
+#include "../src/dijkstra.h"
+#include "../src/live_graph.h"
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <random>
+#include <cstdlib>
+// Publish semantics match Graph::applyUpdates, and under a streaming writer
+// no reader ever sees a torn weight set: every generation raises every road
+// by the same step, so one pinned view must be uniform and match its version.
+int main(){
+    Graph a; std::mt19937 rng(5); int n=150;
+    for(int i=0;i<n;i++) a.addNode(std::to_string(i));
+    std::uniform_int_distribution<int> pick(0,n-1), w(1,20), del(-4,6);
+    for(int i=0;i<n*3;i++) a.addEdge((NodeId)pick(rng),(NodeId)pick(rng),w(rng));
+    Graph b=a; b.freeze();
+    {
+        LiveGraph live(a, 4); LiveGraph::Reader r(live);
+        for(int round=0; round<50; round++){
+            std::vector<TrafficChange> c;
+            for(int k=0;k<6;k++){ EdgeId e=(EdgeId)(pick(rng)%b.edgeCount()); if(k==5) c.push_back({b.edgeSource(e), b.edgeTarget(e), del(rng), 0}); else c.push_back({0,0,del(rng),0,e}); }
+            c.push_back({0,(NodeId)n+5,1,0});
+            auto ref=c; std::size_t hit=b.applyUpdates(ref);
+            if(live.publish(c)!=hit){ std::cout<<"publish count failed\n"; return 1; }
+            for(size_t k=0;k<c.size();k++) if(c[k].newWeight!=ref[k].newWeight){ std::cout<<"newWeight failed\n"; return 1; }
+            LiveGraph::Pin p(r);
+            for(EdgeId e=0;e<b.edgeCount();e++) if(p->edgeWeight(e)!=b.edgeWeight(e) || p->getWeight(b.edgeTarget(e), b.edgeSource(e))!=b.getWeight(b.edgeTarget(e), b.edgeSource(e))){ std::cout<<"weights failed\n"; return 1; }
+            NodeId s=pick(rng), t=pick(rng);
+            if(dijkstra(*p,s,t).distance!=dijkstra(b,s,t).distance || p->weightVersion()!=live.version()){ std::cout<<"route failed\n"; return 1; }
+        }
+        if(live.generationCount()>4){ std::cout<<"generations not reused: "<<live.generationCount()<<"\n"; return 1; }
+    }
+
+    // Stress: uniform weights on a ring, every generation adds 1 to all roads.
+    Graph ring; int len=200; for(int i=0;i<len;i++) ring.addEdge(std::to_string(i), std::to_string((i+1)%len), 1);
+    LiveGraph live(ring, 8); const std::uint64_t v0=live.version();
+    std::atomic<bool> stop(false); std::atomic<int> bad(0); std::atomic<long long> queries(0);
+    std::vector<std::thread> readers;
+    for(int t=0;t<4;t++) readers.emplace_back([&, t]{
+        LiveGraph::Reader r(live); std::mt19937 qr(t); std::uniform_int_distribution<int> node(0,len-1); std::uint64_t last=0;
+        while(!stop.load()){
+            std::uint64_t seen=live.version();   // racing the writer: never ahead of a later pin
+            LiveGraph::Pin p(r); const Graph& g=*p;
+            int step=(int)(g.weightVersion()-v0)+1;
+            if(g.weightVersion()<last || g.weightVersion()<seen) bad++; last=g.weightVersion();
+            for(EdgeId e=0;e<g.edgeCount();e+=7) if(g.edgeWeight(e)!=step) bad++;
+            NodeId s=node(qr), d=node(qr); int hops=std::abs((int)s-(int)d); hops=std::min(hops, len-hops);
+            if(dijkstra(g,s,d).distance!=hops*step) bad++;
+            for(EdgeId e=0;e<g.edgeCount();e++) if(g.edgeWeight(e)!=step){ bad++; break; }
+            queries++;
+        }
+    });
+    std::vector<TrafficChange> all; for(EdgeId e=0;e<ring.edgeCount();e++) all.push_back({0,0,1,0,e});
+    int published=0; while(queries.load()<5000 || published<5000){ auto c=all; live.publish(c); published++; if(published>200000) break; }
+    stop=true; for(auto &t: readers) t.join();
+    if(bad.load()){ std::cout<<"torn reads: "<<bad.load()<<"\n"; return 1; }
+    if(live.generationCount()>8+2){ std::cout<<"generations leaked: "<<live.generationCount()<<"\n"; return 1; }
+    std::cout<<"OK\n"; return 0;
+}
@@ -0,0 +1,44 @@
+#include "../src/graph.h"
+#include "../src/dijkstra.h"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+// Text parser edge cases, and a binary snapshot round trip that must behave
+// exactly like the graph it was saved from, including later edits.
+static bool sameGraph(const Graph& a, const Graph& b){
+    if(a.nodeCount()!=b.nodeCount() || a.arcCount()!=b.arcCount()) return false;
+    for(NodeId u=0; u<a.nodeCount(); ++u){
+        if(a.name(u)!=b.name(u) || a.label(u)!=b.label(u) || a.hasCoords(u)!=b.hasCoords(u) || (a.hasCoords(u) && (a.lat(u)!=b.lat(u) || a.lng(u)!=b.lng(u)))) return false;
+        auto x=a.neighbors(u), y=b.neighbors(u); if(x.size()!=y.size()) return false;
+        for(auto i=x.begin(), j=y.begin(); i!=x.end(); ++i, ++j) if((*i).v!=(*j).v || (*i).w!=(*j).w) return false;
+    }
+    return true;
+}
+int main(){
+    { std::ofstream out("test_loader.txt", std::ios::binary); out<<"# header\nA B 3\r\n\n  B\tC  +2 trailing\nC D\nbad line x\n#A D 1\nD A -4\nC E 99999999999\nE F 7"; }
+    Graph g; if(!g.loadFromFile("test_loader.txt")){ std::cout<<"load failed\n"; return 1; }
+    if(g.nodeCount()!=6 || g.edgeCount()!=4 || g.getWeight(g.id("B"),g.id("C"))!=2 || g.getWeight(g.id("A"),g.id("D"))!=-4 || g.getWeight(g.id("E"),g.id("F"))!=7 || g.hasNode("x")){ std::cout<<"parse failed\n"; return 1; }
+    // Snapshot of a larger graph with places.
+    Graph big; for(int i=0;i<500;i++){ NodeId u=big.addNode("n"+std::to_string(i)); if(i%3) big.setPlace(u, "Place "+std::to_string(i), 28.5+i*1e-4, 77.1-i*1e-4); }
+    for(int i=0;i<1500;i++) big.addEdge((NodeId)(i*7%500), (NodeId)(i*13%500), 1+i%17);
+    if(!big.saveSnapshot("test_loader.bin")){ std::cout<<"save failed\n"; return 1; }
+    Graph s; if(!s.loadFromFile("test_loader.bin") || !sameGraph(big, s) || s.id("n42")!=big.id("n42")){ std::cout<<"snapshot failed\n"; return 1; }
+    if(s.memoryBytes()*10>big.memoryBytes()){ std::cout<<"snapshot copied arcs\n"; return 1; }
+    if(dijkstra(s,1,250).distance!=dijkstra(big,1,250).distance){ std::cout<<"snapshot route failed\n"; return 1; }
+    big.addWeightDelta(7,13,5); s.addWeightDelta(7,13,5); big.addEdge("n1","new",4); s.addEdge("n1","new",4);
+    if(!sameGraph(big, s)){ std::cout<<"snapshot edit failed\n"; return 1; }
+    {   // New nodes on a mapped snapshot or a view: their arcs are copied out after names grew
+        Graph m; if(!m.loadSnapshot("test_loader.bin")){ std::cout<<"snapshot load failed\n"; return 1; }
+        Graph v=big.view();
+        for(Graph* g: {&m, &v}){
+            g->addNode("x0"); g->addNode("x1"); g->addEdge("x0","x1",3); g->addEdge("x1","n5",2); g->freeze();
+            if(g->degree(g->id("x0"))!=1 || g->getWeight(g->id("x1"), g->id("n5"))!=2 || dijkstra(*g, g->id("x0"), g->id("n5")).distance!=5){ std::cout<<"growing a snapshot failed\n"; return 1; }
+        }
+        if(v.getWeight(7,13)!=big.getWeight(7,13) || dijkstra(v,1,250).distance!=dijkstra(big,1,250).distance){ std::cout<<"grown view lost arcs\n"; return 1; }
+    }
+    Graph t; if(!t.loadSnapshot("test_loader.bin") || t.loadSnapshot("test_loader.txt") || t.getWeight(7,13)==s.getWeight(7,13)){ std::cout<<"snapshot reload failed\n"; return 1; }
+    { std::ofstream out("test_loader.bin", std::ios::binary|std::ios::app); out<<"x"; }
+    if(t.loadSnapshot("test_loader.bin")){ std::cout<<"truncation check failed\n"; return 1; }
+    std::remove("test_loader.txt"); std::remove("test_loader.bin");
+    std::cout<<"OK\n"; return 0;
+}
@@ -0,0 +1,58 @@
+#include "../src/graph.h"
+#include "../src/router.h"
+#include "../src/k_shortest.h"
+#include "../src/metrics.h"
+#include "../src/json_exporter.h"
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+// Metrics: a query's counters match the work it did (pops = settled nodes,
+// arcs = degrees of the expanded nodes), the registry sums queries from many
+// threads, histograms bucket by powers of two, and both exports carry it all.
+int main(){
+    Graph g; std::mt19937 rng(8); int n=2000;
+    for(int i=0;i<n;i++) g.addNode("n"+std::to_string(i));
+    std::uniform_int_distribution<int> pick(0,n-1), w(1,20);
+    for(int i=0;i<n*3;i++) g.addEdge((NodeId)pick(rng),(NodeId)pick(rng),w(rng));
+    g.freeze();
+    Metrics& m=Metrics::global(); m.reset();
+
+    Router r(g); std::size_t queries=0; SearchCounters sum;
+    for(SearchMode mode: {SearchMode::Dijkstra, SearchMode::Bidirectional, SearchMode::AStar}){
+        for(int q=0;q<30;q++){
+            NodeId a=pick(rng), b=pick(rng); r.route(a, b, mode); queries++;
+            const SearchCounters& c=r.lastCounters(); sum+=c;
+            if(c.settled!=r.lastSettled() || c.pushes<c.settled || c.relaxed<c.settled-1 || c.decreases>c.relaxed){ std::cout<<"counters failed ("<<searchModeName(mode)<<")\n"; return 1; }
+        }
+    }
+    {   // Dijkstra: every settled node but the target scans all its arcs.
+        SearchWorkspace& ws=threadWorkspace(); SearchCounters before=ws.counters();
+        std::size_t degrees=0; NodeId dst=7; bool hit=false;
+        int d=dijkstraSearch(g, 3, dst, ws, [&](NodeId u, int){ if(u==dst) hit=true; else degrees+=g.degree(u); });
+        SearchCounters c=ws.counters()-before;
+        if(d==SearchWorkspace::INF || !hit || c.relaxed!=degrees){ std::cout<<"arc count failed\n"; return 1; }
+    }
+    std::vector<std::thread> ts;
+    for(int t=0;t<4;t++) ts.emplace_back([&g, t]{ Router rr(g); KShortestPaths ksp(g); for(int q=0;q<25;q++){ rr.route((NodeId)(t*100+q), (NodeId)(q*7)); ksp.route((NodeId)q, (NodeId)(t+q*3), 3); } });
+    for(auto &t: ts) t.join();
+    MetricsSnapshot s=m.snapshot();
+    if(s.queries[kSearchDijkstra]!=30+100 || s.queries[kSearchBidirectional]!=30 || s.queries[kSearchAStar]!=30 || s.queries[kSearchAlternatives]!=100){ std::cout<<"query totals failed\n"; return 1; }
+    SearchCounters single=s.search[kSearchDijkstra]+s.search[kSearchBidirectional]+s.search[kSearchAStar];
+    if(single.settled<sum.settled || s.latencyUs[kTimeRoute].count!=queries+200 || s.settled.count!=queries+200){ std::cout<<"registry failed\n"; return 1; }
+
+    m.reset(); m.time(kTimeLoad, 0.5); m.time(kTimeLoad, 1); m.time(kTimeLoad, 3); m.time(kTimeLoad, 1000); m.time(kTimeLoad, 1e12);
+    s=m.snapshot(); const HistogramSnapshot& h=s.latencyUs[kTimeLoad];
+    if(h.count!=5 || h.bucket[0]!=2 || h.bucket[1]!=0 || h.bucket[2]!=1 || h.bucket[10]!=1 || h.bucket[HistogramSnapshot::kBuckets-1]!=1){ std::cout<<"buckets failed\n"; return 1; }
+    if(h.quantile(0.5)!=4 || h.quantile(0.2)!=1 || h.quantile(0.8)!=1024 || std::abs(h.sum-(1004.5+1e12))>1){ std::cout<<"quantiles failed\n"; return 1; }
+
+    { ScopedTimer t(kTimeExport); std::this_thread::sleep_for(std::chrono::milliseconds(2)); }
+    s=m.snapshot();
+    if(s.latencyUs[kTimeExport].count!=1 || s.latencyUs[kTimeExport].sum<2000){ std::cout<<"scoped timer failed\n"; return 1; }
+    std::string prom=prometheusText(s), json; JsonWriter out(&json); metricsJson(s, out); out.commit();
+    for(const char* line: {"traffic_latency_seconds_bucket{op=\"load\",le=\"1e-06\"} 2\n", "traffic_latency_seconds_bucket{op=\"load\",le=\"+Inf\"} 5\n",
+                           "traffic_latency_seconds_count{op=\"load\"} 5\n", "# TYPE traffic_search_heap_pushes_total counter\n", "traffic_search_queries_total{search=\"alternatives\"} 0\n"})
+        if(prom.find(line)==std::string::npos){ std::cout<<"prometheus missing "<<line; return 1; }
+    if(json.find("\"load\": {\"count\": 5, \"meanUs\": ")==std::string::npos || json.find("\"enabled\": true")==std::string::npos){ std::cout<<"json failed\n"<<json; return 1; }
+    std::cout<<"OK\n"; return 0;
+}
@@ -0,0 +1,111 @@
+#include "../src/graph.h"
+#include "../src/dijkstra.h"
+#include "../src/node_order.h"
+#include "../src/batch_router.h"
+#include "../src/city_generator.h"
+#include "../src/route_cache.h"
+#include "../src/contraction_hierarchy.h"
+#include "../src/dynamic_sssp.h"
+#include "../src/router.h"
+#include <iostream>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+// Node orders: every ordering is a permutation that renumber() applies without
+// changing the network (same roads by name, EdgeIds, places and routes),
+// partitions tile the IDs, the locality orders beat file order on road span
+// and cut size, snapshots and the name index survive, BatchRouter gives
+// the same answers with cell grouping, and caches built before a renumber
+// notice it.
+static double meanSpan(const Graph& g){
+    double s=0; for(EdgeId e=0;e<g.edgeCount();e++) s+=std::abs((double)g.edgeSource(e)-(double)g.edgeTarget(e));
+    return s/g.edgeCount();
+}
+static bool sameNetwork(const Graph& a, const Graph& b){
+    if(a.nodeCount()!=b.nodeCount() || a.edgeCount()!=b.edgeCount()) return false;
+    for(EdgeId e=0;e<a.edgeCount();e++)
+        if(a.name(a.edgeSource(e))!=b.name(b.edgeSource(e)) || a.name(a.edgeTarget(e))!=b.name(b.edgeTarget(e)) || a.edgeWeight(e)!=b.edgeWeight(e)) return false;
+    for(NodeId u=0;u<a.nodeCount();u++){
+        NodeId v=b.id(a.name(u));
+        if(v==kInvalidNode || b.degree(v)!=a.degree(u) || b.label(v)!=a.label(u) || (a.hasCoords(u) && b.lat(v)!=a.lat(u))) return false;
+    }
+    return true;
+}
+int main(){
+    CitySpec geo; geo.kind=CityKind::Geometric; geo.nodes=20000; geo.seed=5;
+    Graph plain; {   // no coordinates: a 60x60 and a 20x20 grid, IDs shuffled
+        std::mt19937 rng(3); std::vector<int> id(4000); for(int i=0;i<4000;i++) id[i]=i; std::shuffle(id.begin(), id.end(), rng);
+        for(int i=0;i<4000;i++) plain.addNode("p"+std::to_string(i));
+        for(int base: {0, 3600}){ int side = base ? 20 : 60;
+            for(int y=0;y<side;y++) for(int x=0;x<side;x++){ int u=base+y*side+x;
+                if(x+1<side) plain.addEdge(id[u], id[u+1], 1+rng()%9); if(y+1<side) plain.addEdge(id[u], id[u+side], 1+rng()%9); } }
+        plain.freeze(); }
+    for(int which=0; which<2; which++){
+        Graph base; if(which==0) buildCity(base, geo); else base=plain;
+        if(which==0) base.setPlace(17, "Depot", base.lat(17), base.lng(17));
+        Partition input=Partition(base, NodeOrderer(base).order(NodeOrdering::Input, 64).cellStarts);
+        for(NodeOrdering how: {NodeOrdering::Input, NodeOrdering::Bfs, NodeOrdering::Hilbert, NodeOrdering::Bisection}){
+            Graph g=base; Partition p=reorderNodes(g, how, 64);
+            if(!sameNetwork(base, g)){ std::cout<<nodeOrderingName(how)<<" changed the network\n"; return 1; }
+            if(p.cells()!=64 || p.nodeCount()!=g.nodeCount() || p.begin(0)!=0 || p.end(63)!=g.nodeCount()){ std::cout<<nodeOrderingName(how)<<" cells failed\n"; return 1; }
+            for(std::uint32_t k=0;k<p.cells();k++){
+                if(p.end(k)<=p.begin(k)){ std::cout<<"empty cell\n"; return 1; }
+                for(NodeId u=p.begin(k);u<p.end(k);u++) if(p.cellOf(u)!=k){ std::cout<<"cellOf failed\n"; return 1; }
+            }
+            std::mt19937 rng(9);
+            for(int q=0;q<30;q++){
+                NodeId a=rng()%base.nodeCount(), b=rng()%base.nodeCount();
+                if(dijkstra(base, a, b).distance!=dijkstra(g, g.id(base.name(a)), g.id(base.name(b))).distance){ std::cout<<nodeOrderingName(how)<<" routes differ\n"; return 1; }
+            }
+            // BFS slices are thin bands: short roads, but not a small cut.
+            bool regions = how==NodeOrdering::Bisection || (how==NodeOrdering::Hilbert && which==0);
+            if(how!=NodeOrdering::Input && (meanSpan(g)>meanSpan(base)/4 || (regions && p.cutRoads()>input.cutRoads()/4))){
+                std::cout<<nodeOrderingName(how)<<" no locality gain: span "<<meanSpan(g)<<" vs "<<meanSpan(base)<<", cut "<<p.cutRoads()<<" vs "<<input.cutRoads()<<"\n"; return 1;
+            }
+        }
+    }
+
+    {   // renumber checks its input, works from a snapshot and keeps the name index
+        Graph g; buildCity(g, geo);
+        std::vector<NodeId> bad(g.nodeCount(), 0);
+        if(g.renumber(bad) || g.renumber(std::vector<NodeId>(3, 0))){ std::cout<<"accepted a non-permutation\n"; return 1; }
+        Graph ref=g; std::uint64_t v=g.weightVersion();
+        if(!g.saveSnapshot("test_node_order.bin") || !g.loadFromFile("test_node_order.bin")){ std::cout<<"snapshot failed\n"; return 1; }
+        Partition p=reorderNodes(g, NodeOrdering::Hilbert, 16);
+        if(!sameNetwork(ref, g) || g.weightVersion()==v || p.cells()!=16){ std::cout<<"snapshot reorder failed\n"; return 1; }
+        if(!g.saveSnapshot("test_node_order.bin")){ std::cout<<"resave failed\n"; return 1; }
+        Graph back; if(!back.loadFromFile("test_node_order.bin") || !sameNetwork(g, back) || back.id(g.name(0))!=0){ std::cout<<"ordered snapshot failed\n"; return 1; }
+        std::remove("test_node_order.bin");
+        if(!g.setWeight(g.edgeCount()-1, 77) || ref.edgeWeight(ref.edgeCount()-1)==77 || g.getWeight(g.edgeSource(g.edgeCount()-1), g.edgeTarget(g.edgeCount()-1))!=77){ std::cout<<"weights after reorder failed\n"; return 1; }
+
+        // Cell grouping reorders the work, not the answers.
+        BatchRouter br(g, 3); std::mt19937 rng(4); std::vector<std::pair<NodeId,NodeId>> pairs(300);
+        for(auto &q: pairs) q={(NodeId)(rng()%g.nodeCount()), (NodeId)(rng()%g.nodeCount())};
+        pairs[5].first=kInvalidNode;
+        auto plainRes=br.route(pairs); br.usePartition(&p); auto grouped=br.route(pairs);
+        for(std::size_t i=0;i<pairs.size();i++) if(plainRes[i].distance!=grouped[i].distance || plainRes[i].path!=grouped[i].path){ std::cout<<"grouped batch differs at "<<i<<"\n"; return 1; }
+    }
+    {   // Caches holding node IDs from before the renumber see the layout move
+        CitySpec small=geo; small.nodes=3000; Graph g; buildCity(g, small);
+        std::uint64_t layout=g.layoutVersion();
+        RouteCache cache(g); ContractionHierarchy ch=ContractionHierarchy::build(g); RouteTracker tracker(g); Router router(g);
+        cache.insert(1, 2, g.weightVersion(), dijkstra(g, 1, 2)); tracker.track(1, 2); router.route(1, 2, SearchMode::AStar);
+        std::uint64_t from=g.weightVersion(); reorderNodes(g, NodeOrdering::Hilbert);
+        std::mt19937 rng(6);
+        for(int q=0;q<300;q++){
+            NodeId a=rng()%g.nodeCount(), b=rng()%g.nodeCount();
+            if(router.route(a, b, SearchMode::AStar).distance!=dijkstra(g, a, b).distance){ std::cout<<"router kept old positions\n"; return 1; }
+        }
+        if(g.layoutVersion()==layout || ch.matches(g)){ std::cout<<"layout change missed\n"; return 1; }
+        if(cache.invalidate(g, {}, from)!=1 || cache.stats().size!=0){ std::cout<<"route cache kept old IDs\n"; return 1; }
+        if(!tracker.update({}).empty()){ std::cout<<"tracker kept old IDs\n"; return 1; }
+        if(!ContractionHierarchy::build(g).matches(g)){ std::cout<<"rebuilt hierarchy failed\n"; return 1; }
+        layout=g.layoutVersion(); g.setPlace(0, "", g.lat(0)+0.01, g.lng(0));
+        if(g.layoutVersion()==layout){ std::cout<<"setPlace kept the layout\n"; return 1; }
+    }
+    Graph empty; if(!NodeOrderer(empty).order(NodeOrdering::Bisection).newId.empty()){ std::cout<<"empty graph failed\n"; return 1; }
+    Graph one; one.addNode("a"); Partition p1=reorderNodes(one, NodeOrdering::Bisection, 8);
+    if(p1.cells()!=1 || one.name(0)!="a"){ std::cout<<"single node failed\n"; return 1; }
+    NodeOrdering o; if(!parseNodeOrdering("hilbert", o) || o!=NodeOrdering::Hilbert || parseNodeOrdering("random", o)){ std::cout<<"parsing failed\n"; return 1; }
+    std::cout<<"OK\n"; return 0;
+}
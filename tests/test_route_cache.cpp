@@ -0,0 +1,77 @@
+#include "../src/graph.h"
+#include "../src/dijkstra.h"
+#include "../src/route_cache.h"
+#include "../src/traffic_simulator.h"
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+// Route cache: after any traffic batch, every route carried to the new
+// version is still a shortest route (with and without coordinates), many are
+// carried rather than dropped, capacity holds, versions never go backwards,
+// and the counters reach metrics.h.
+static Graph city(bool coords, unsigned seed){
+    Graph g; std::mt19937 rng(seed); int side=20; std::uniform_int_distribution<int> w(3,15);
+    for(int i=0;i<side*side;i++) g.addNode(std::to_string(i));
+    for(int y=0;y<side;y++) for(int x=0;x<side;x++){ int u=y*side+x; if(x+1<side) g.addEdge(u,u+1,w(rng)); if(y+1<side) g.addEdge(u,u+side,w(rng)); }
+    if(coords) for(int i=0;i<side*side;i++) g.setPlace(i, "", 28.5+(i/side)*0.009, 77.1+(i%side)*0.01);   // ~1 km blocks
+    g.freeze(); return g;
+}
+int main(){
+    for(bool coords: {true, false}){
+        Graph g=city(coords, 3); RouteCache cache(g, 100000); TrafficSimulator sim(""); sim.seed(9);
+        std::mt19937 rng(1); std::uniform_int_distribution<int> pick(0, (int)g.nodeCount()-1);
+        std::vector<std::pair<NodeId,NodeId>> pairs(600); for(auto &p: pairs) p={(NodeId)pick(rng),(NodeId)pick(rng)};
+        std::size_t carried=0, checked=0;
+        for(int step=0; step<40; step++){
+            for(auto &p: pairs){
+                PathResult r;
+                if(cache.lookup(p.first, p.second, g.weightVersion(), r)){
+                    checked++;
+                    if(r.distance!=dijkstra(g, p.first, p.second).distance){ std::cout<<"stale route carried (coords="<<coords<<", step "<<step<<")\n"; return 1; }
+                    int cost=0; for(std::size_t i=0;i+1<r.path.size();i++) cost+=g.getWeight(r.path[i], r.path[i+1]);
+                    if(cost!=r.distance || r.path.front()!=p.first || r.path.back()!=p.second){ std::cout<<"route does not match its cost\n"; return 1; }
+                } else cache.insert(p.first, p.second, g.weightVersion(), dijkstra(g, p.first, p.second));
+            }
+            std::uint64_t base=g.weightVersion(); auto changes=sim.apply(g, 3, -3, 4, false);
+            std::size_t before=cache.stats().size, dropped=cache.invalidate(g, changes, base);
+            carried+=before-dropped;
+        }
+        RouteCache::Stats s=cache.stats();
+        if(checked==0 || carried<pairs.size()*5 || s.hits!=checked || s.carried!=carried){ std::cout<<"too little carried (coords="<<coords<<"): "<<carried<<" / hits "<<s.hits<<"\n"; return 1; }
+        std::cout<<(coords?"coords":"no coords")<<": hit rate "<<s.hitRate()<<", carried "<<s.carried<<", dropped "<<s.dropped<<"\n";
+    }
+
+    Graph g=city(true, 4); Metrics::global().reset();
+    {   // bounded, CLOCK-evicted, version-checked
+        RouteCache small(g, 32);
+        for(NodeId u=0; u<300; u++) small.insert(u, 0, g.weightVersion(), dijkstra(g, u, 0));
+        RouteCache::Stats s=small.stats();
+        if(s.size>32 || s.evictions!=300-s.size){ std::cout<<"capacity failed: "<<s.size<<"\n"; return 1; }
+        PathResult r, stale; stale.distance=1; stale.path={5, 0};
+        small.insert(5, 0, g.weightVersion(), dijkstra(g, 5, 0)); small.insert(5, 0, g.weightVersion()-1, stale);
+        if(!small.lookup(5, 0, g.weightVersion(), r) || r.distance==1 || small.lookup(5, 0, g.weightVersion()+1, r)){ std::cout<<"versions failed\n"; return 1; }
+        PathResult none; small.insert(7, 8, g.weightVersion(), none);
+        if(small.lookup(7, 8, g.weightVersion(), r)){ std::cout<<"cached a missing route\n"; return 1; }
+        small.clear(); if(small.stats().size!=0 || small.lookup(5, 0, g.weightVersion(), r)){ std::cout<<"clear failed\n"; return 1; }
+        // Changes that skipped invalidate() drop everything on the next call.
+        small.insert(1, 2, g.weightVersion(), dijkstra(g, 1, 2)); std::uint64_t v=g.weightVersion();
+        g.addWeightDelta(0, 1); g.addWeightDelta(3, 1); std::vector<TrafficChange> none2;
+        if(small.invalidate(g, none2, v+1)!=1 || small.lookup(1, 2, g.weightVersion(), r)){ std::cout<<"unknown versions kept\n"; return 1; }
+    }
+    MetricsSnapshot m=Metrics::global().snapshot();
+    if(kMetricsEnabled && (m.cache[kCacheEvict]==0 || m.cache[kCacheHit]!=1 || m.cache[kCacheMiss]<3 || m.cache[kCacheDrop]!=1)){ std::cout<<"metrics failed\n"; return 1; }
+
+    {   // Many threads at once; the whole cache shares one version here.
+        RouteCache shared(g, 256); std::vector<std::thread> ts; std::uint64_t v=g.weightVersion(); bool bad=false;
+        for(int t=0;t<4;t++) ts.emplace_back([&, t]{
+            std::mt19937 r2(t); std::uniform_int_distribution<int> p2(0, 60);
+            for(int i=0;i<3000;i++){ NodeId a=p2(r2), b=p2(r2); PathResult res;
+                if(shared.lookup(a, b, v, res)){ if(res.path.front()!=a || res.path.back()!=b) bad=true; }
+                else shared.insert(a, b, v, dijkstra(g, a, b)); }
+        });
+        for(auto &t: ts) t.join();
+        if(bad || shared.stats().hits+shared.stats().misses!=12000){ std::cout<<"threads failed\n"; return 1; }
+    }
+    std::cout<<"OK\n"; return 0;
+}
@@ -0,0 +1,64 @@
+#include "../src/route_history.h"
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <cstdio>
+// Binary history round trip: interning survives reopen, torn tails are
+// skipped and overwritten, refresh() picks up appends, window and
+// origin/destination queries match a brute-force scan (in and out of time
+// order), and the old text history imports.
+struct Trip { std::int64_t t; std::string route; int minutes; };
+static TripStats brute(const std::vector<Trip>& all, const std::string& o, const std::string& d, std::int64_t from, std::int64_t to){
+    TripStats s; std::string a, b;
+    for(auto &x: all){ routeEnds(x.route, a, b); if(a==o && b==d && x.t>=from && x.t<to){ s.trips++; s.minutes+=x.minutes; } }
+    return s;
+}
+static void cleanup(){ std::remove("test_hist.bin"); std::remove("test_hist.bin.routes"); std::remove("test_hist.txt"); }
+int main(){
+    cleanup();
+    const char* routes[] = {"A->B", "A->C->B", "B->E->I", "A->D->B", "C", "J->H->G->C->A"};
+    std::mt19937 rng(4); std::uniform_int_distribution<int> pick(0,5), mins(1,60), jitter(0,90);
+    std::vector<Trip> all; std::int64_t clock=1700000000;
+    {
+        RouteHistoryWriter w("test_hist.bin", 64);
+        if(!w.ok()){ std::cout<<"open failed\n"; return 1; }
+        for(int i=0;i<1000;i++){ clock+=jitter(rng); Trip t{clock, routes[pick(rng)], mins(rng)}; all.push_back(t); w.append(t.route, t.minutes, t.t); }
+    }
+    {   // Reopen: ids persist, a torn record and a torn name are tolerated.
+        { std::FILE* f=std::fopen("test_hist.bin","ab"); std::fwrite("torn", 1, 4, f); std::fclose(f); }
+        { std::FILE* f=std::fopen("test_hist.bin.routes","ab"); std::fwrite("X->", 1, 3, f); std::fclose(f); }
+        RouteHistory torn; if(!torn.open("test_hist.bin") || torn.size()!=1000 || torn.routeCount()!=6){ std::cout<<"torn read failed\n"; return 1; }
+        RouteHistoryWriter w("test_hist.bin");
+        if(w.recordCount()!=1000 || w.routeCount()!=7){ std::cout<<"reopen failed "<<w.recordCount()<<" "<<w.routeCount()<<"\n"; return 1; }
+        for(int i=0;i<500;i++){ clock+=jitter(rng); Trip t{clock, routes[pick(rng)], mins(rng)}; all.push_back(t); w.append(t.route, t.minutes, t.t); }
+    }
+    RouteHistory h;
+    if(!h.open("test_hist.bin") || h.size()!=1500 || h.routeCount()!=7 || !h.timeOrdered()){ std::cout<<"read failed "<<h.size()<<"\n"; return 1; }
+    for(std::size_t i=0;i<h.size();i++){ auto r=h.record(i); if(r.time!=all[i].t || r.minutes!=all[i].minutes || h.route(r.route)!=all[i].route){ std::cout<<"record failed\n"; return 1; } }
+
+    // Out-of-order trips (clock skew, imports) switch the affected routes to scans.
+    RouteHistoryWriter w("test_hist.bin", 8);
+    for(int i=0;i<200;i++){ Trip t{1700000000+jitter(rng)*1000, routes[pick(rng)], mins(rng)}; all.push_back(t); w.append(t.route, t.minutes, t.t); }
+    w.append("Q->R", 5, clock); all.push_back({clock, "Q->R", 5});
+    if(!w.flush() || !h.refresh() || h.size()!=1701 || h.routeCount()!=8 || h.timeOrdered()){ std::cout<<"refresh failed\n"; return 1; }
+    std::uniform_int_distribution<std::int64_t> when(1700000000-1000, clock+1000);
+    const char* od[][2] = {{"A","B"}, {"B","I"}, {"C","C"}, {"J","A"}, {"Q","R"}, {"A","Z"}};
+    for(int q=0;q<300;q++){
+        std::int64_t a=when(rng), b=when(rng); if(a>b) std::swap(a,b);
+        if(q==0){ a=RouteHistory::kBegin; b=RouteHistory::kEnd; }
+        auto& p=od[q%6]; TripStats got=h.odStats(p[0], p[1], a, b), want=brute(all, p[0], p[1], a, b);
+        if(got.trips!=want.trips || got.minutes!=want.minutes){ std::cout<<"window failed "<<got.trips<<" vs "<<want.trips<<"\n"; return 1; }
+        auto top=h.topRoutes(3, a, b);
+        for(std::size_t i=0;i<top.size();i++){
+            std::size_t n=0; for(auto &x: all) if(x.route==h.route(top[i].route) && x.t>=a && x.t<b) n++;
+            if(n!=top[i].stats.trips || (i && top[i].stats.trips>top[i-1].stats.trips)){ std::cout<<"top failed\n"; return 1; }
+        }
+    }
+
+    { std::ofstream out("test_hist.txt"); out<<"# Route history will be appended here at runtime.\n2025-11-13 21:50:48 | A->C->G | 15 min\nbad line\n2025-11-13 22:10:34 | B->E->I | 8 min\n"; }
+    RouteHistoryWriter imp("test_hist.bin");
+    std::int64_t t0; if(!parseTimestamp("2025-11-13 21:50:48", t0) || formatTimestamp(t0)!="2025-11-13 21:50:48"){ std::cout<<"timestamp failed\n"; return 1; }
+    if(imp.importText("test_hist.txt")!=2 || !h.refresh() || h.odStats("A","G",t0,t0+1).minutes!=15 || h.odStats("B","I",t0,t0+3600).trips!=1){ std::cout<<"import failed\n"; return 1; }
+    cleanup();
+    std::cout<<"OK\n"; return 0;
+}
@@ -0,0 +1,37 @@
+#include "../src/graph.h"
+#include "../src/dijkstra.h"
+#include "../src/router.h"
+#include <iostream>
+#include <random>
+int main(){
+    // Random geometric graph: weights never beat straight-line travel at 1 km/min.
+    Graph g; std::mt19937 rng(5); std::uniform_real_distribution<double> c(0, 0.05); int n=300;
+    for(int i=0;i<n;i++){ NodeId u=g.addNode(std::to_string(i)); g.setPlace(u, "", 28.5+c(rng), 77.1+c(rng)); }
+    std::uniform_int_distribution<int> pick(0,n-1), slack(0,5);
+    for(int i=0;i<n*3;i++){ NodeId a=pick(rng), b=pick(rng); if(a!=b) g.addEdge(a,b,(int)g.distanceKm(a,b)+1+slack(rng)); }
+    Router r(g);
+    for(int q=0;q<200;q++){
+        NodeId s=pick(rng), t=pick(rng); int ref=dijkstra(g,s,t).distance;
+        for(SearchMode m: {SearchMode::Dijkstra, SearchMode::Bidirectional, SearchMode::AStar}){
+            auto res=r.route(s,t,m);
+            if(res.distance!=ref){ std::cout<<searchModeName(m)<<" distance failed\n"; return 1; }
+            if(ref==SearchWorkspace::INF) continue;
+            int len=0; for(size_t i=0;i+1<res.path.size();i++){ int w=1<<30; for(auto e: g.neighbors(res.path[i])) if(e.v==res.path[i+1]) w=std::min(w,e.w); len+=w; }
+            if(res.path.front()!=s || res.path.back()!=t || len!=ref){ std::cout<<searchModeName(m)<<" path failed\n"; return 1; }
+        }
+    }
+    // Traffic: A* keeps its bound across reported batches (roads far faster
+    // than before must lower it) and rescans after unreported ones.
+    std::uniform_int_distribution<EdgeId> road(0, (EdgeId)g.edgeCount()-1);
+    for(int step=0;step<40;step++){
+        std::vector<TrafficChange> batch;
+        for(int i=0;i<5;i++){ EdgeId e=road(rng); batch.push_back({g.edgeSource(e), g.edgeTarget(e), step%2 ? -g.edgeWeight(e) : 3, 0, e}); }
+        std::uint64_t base=g.weightVersion(); g.applyUpdates(batch);
+        if(step%5!=4) r.noteChanges(batch, base, g.weightVersion());
+        for(int q=0;q<50;q++){
+            NodeId s=pick(rng), t=pick(rng);
+            if(r.route(s,t,SearchMode::AStar).distance!=dijkstra(g,s,t).distance){ std::cout<<"astar after traffic failed (step "<<step<<")\n"; return 1; }
+        }
+    }
+    std::cout<<"OK\n"; return 0;
+}
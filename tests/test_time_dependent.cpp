@@ -0,0 +1,49 @@
+#include "../src/graph.h"
+#include "../src/time_dependent.h"
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <cstdio>
+// Log aggregation and interpolation, extending profiles step by step, FIFO repair, and time-dependent Dijkstra
+// against a brute-force earliest-arrival fixpoint.
+int main(){
+    Graph g; g.addEdge("A","B",10); g.addEdge("B","C",5); g.addEdge("A","B",12);
+    { std::ofstream out("test_td.log"); out<<"# comment\nA B 2 7\n2025-11-13 08:10:00 A B 3 20\n2025-11-14 08:50:00 B A 1 30\n2025-11-13 20:05:00 A B -5 10\n2025-11-13 09:00:00 A Z 1 9\nbad\n"; }
+    std::size_t used=0; auto p=TravelTimeProfiles::fromTrafficLog(g, "test_td.log", &used); std::remove("test_td.log");
+    if(used!=3 || p.profiledCount()!=2 || !p.hasProfile(0) || !p.hasProfile(2) || p.hasProfile(1)){ std::cout<<"aggregate failed\n"; return 1; }
+    // Hour 8 averages 25, hour 20 is 10; hours in between interpolate.
+    if(p.travelTime(0, 8*60+30, 0)!=25 || p.travelTime(0, 20*60+30, 0)!=10 || p.travelTime(0, 14*60+30, 0)!=18 || p.travelTime(0, 8*60+60, 0)!=25 || p.travelTime(1, 0, 5)!=5 || p.travelTime(g, 1, 123)!=5){ std::cout<<"interpolate failed "<<p.travelTime(0, 14*60+30, 0)<<"\n"; return 1; }
+    if(p.travelTime(0, 8*60+30+kMinutesPerDay*3, 0)!=25 || p.travelTime(0, 8*60+30-kMinutesPerDay, 0)!=25){ std::cout<<"wrap failed\n"; return 1; }
+    {   // A Builder extends the sums with simulator steps as they happen.
+        TravelTimeProfiles::Builder b(g); std::vector<TrafficChange> step{{g.id("B"), g.id("C"), 4, 9, 1}, {g.id("A"), g.id("Z"), 1, 3}};
+        if(b.add(step, 8*60+40)!=1 || b.build().profiledCount()!=1){ std::cout<<"builder failed\n"; return 1; }
+        step[0].newWeight = 13; b.add(step, 8*60+5-kMinutesPerDay);
+        auto q=b.build(); if(!q.hasProfile(1) || q.travelTime(1, 8*60+30, 0)!=11 || q.travelTime(1, 20*60, 0)!=11){ std::cout<<"builder extend failed\n"; return 1; }
+    }
+
+    std::mt19937 rng(9); std::uniform_int_distribution<int> big(1,400);
+    TravelTimeProfiles fifo(1); int h[TravelTimeProfiles::kSlots]; for(int &x: h) x=big(rng); fifo.setProfile(0, h);
+    for(int t=0;t<2*kMinutesPerDay;t++) if(t+1+fifo.travelTime(0,t+1,0) < t+fifo.travelTime(0,t,0)){ std::cout<<"fifo failed at "<<t<<"\n"; return 1; }
+
+    int n=120; Graph r; for(int i=0;i<n;i++) r.addNode(std::to_string(i));
+    std::uniform_int_distribution<int> pick(0,n-1), w(1,30), slow(1,90), day(0,kMinutesPerDay-1);
+    for(int i=0;i<n*3;i++) r.addEdge((NodeId)pick(rng),(NodeId)pick(rng),w(rng));
+    TravelTimeProfiles prof(r.edgeCount());
+    for(EdgeId e=0;e<r.edgeCount();e+=2){ for(int &x: h) x=slow(rng); prof.setProfile(e, h); }
+    for(int q=0;q<40;q++){
+        NodeId s=pick(rng); int dep=day(rng);
+        std::vector<int> best(n, SearchWorkspace::INF); best[s]=0;
+        for(bool changed=true; changed; ){ changed=false;
+            for(EdgeId e=0;e<r.edgeCount();e++){ NodeId a=r.edgeSource(e), b=r.edgeTarget(e);
+                for(int k=0;k<2;k++, std::swap(a,b)) if(best[a]!=SearchWorkspace::INF){ int nd=best[a]+prof.travelTime(r,e,dep+best[a]); if(nd<best[b]){ best[b]=nd; changed=true; } } } }
+        for(NodeId t=0;t<(NodeId)n;t++){
+            auto res=timeDependentDijkstra(r, prof, s, t, dep);
+            if(res.distance!=best[t]){ std::cout<<"td distance failed "<<res.distance<<" vs "<<best[t]<<"\n"; return 1; }
+            if(res.path.empty()) continue;
+            int clock=0; for(size_t k=0;k+1<res.path.size();k++){ int step=1<<30; std::uint32_t arc=r.arcBegin(res.path[k]);
+                for(auto e: r.neighbors(res.path[k])){ EdgeId id=r.arcEdge(arc++); if(e.v==res.path[k+1]) step=std::min(step, prof.travelTime(r,id,dep+clock)); } clock+=step; }
+            if(clock!=res.distance){ std::cout<<"td path failed\n"; return 1; }
+        }
+    }
+    std::cout<<"OK\n"; return 0;
+}
@@ -0,0 +1,43 @@
+#include "../src/graph.h"
+#include "../src/dijkstra.h"
+#include "../src/traffic_assignment.h"
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <cmath>
+#include <cstdio>
+// Frank-Wolfe against the closed-form split on two parallel roads, Wardrop
+// conditions on a random grid (every loaded OD pays the shortest time), thread
+// count independence, unreachable demand, and the demand file parser.
+static bool near(double a, double b, double tol){ return std::fabs(a-b) <= tol*std::max(1.0, std::fabs(b)); }
+int main(){
+    {   // t1(x) = 10(1+.15(x/1000)^4), t2 = 15(1+.15((3000-x)/1000)^4); equal at equilibrium.
+        Graph g; g.addEdge("A","B",10); g.addEdge("A","B",15); g.addNode("Z");
+        TrafficAssignment ta(g, 1); AssignmentOptions opt; opt.capacity=1000; opt.targetGap=1e-7; opt.maxIterations=500;
+        auto r=ta.solve({{g.id("A"), g.id("B"), 3000}, {g.id("A"), g.id("Z"), 5}}, opt);
+        double lo=0, hi=3000;
+        for(int i=0;i<100;i++){ double x=(lo+hi)/2; double t1=10*(1+.15*std::pow(x/1000,4)), t2=15*(1+.15*std::pow((3000-x)/1000,4)); if(t1<t2) lo=x; else hi=x; }
+        if(!r.converged || !near(r.flow[0], lo, 2e-3) || !near(r.flow[0]+r.flow[1], 3000, 1e-9) || !near(r.time[0], r.time[1], 2e-3)){ std::cout<<"two roads failed "<<r.flow[0]<<" vs "<<lo<<" gap "<<r.relativeGap<<"\n"; return 1; }
+        if(r.unassigned!=5){ std::cout<<"unassigned failed\n"; return 1; }
+    }
+    std::mt19937 rng(21); int side=12, n=side*side; Graph g;
+    for(int i=0;i<n;i++) g.addNode(std::to_string(i));
+    std::uniform_int_distribution<int> w(2,9), pick(0,n-1); std::uniform_real_distribution<double> trips(50, 400);
+    for(int y=0;y<side;y++) for(int x=0;x<side;x++){ int u=y*side+x; if(x+1<side) g.addEdge(u,u+1,w(rng)); if(y+1<side) g.addEdge(u,u+side,w(rng)); }
+    std::vector<OdDemand> demand; for(int i=0;i<120;i++){ NodeId a=pick(rng), b=pick(rng); if(a!=b) demand.push_back({a,b,trips(rng)}); }
+    AssignmentOptions opt; opt.capacity=1500; opt.targetGap=1e-4; opt.maxIterations=500;
+    TrafficAssignment one(g, 1), three(g, 3);
+    auto r=one.solve(demand, opt), r3=three.solve(demand, opt);
+    if(!r.converged || r.gaps.size()<3 || r.gaps.back()>r.gaps.front()){ std::cout<<"convergence failed "<<r.relativeGap<<"\n"; return 1; }
+    for(EdgeId e=0;e<g.edgeCount();e++) if(!near(r.flow[e], r3.flow[e], 1e-6)){ std::cout<<"threads changed flows\n"; return 1; }
+    // Wardrop: shortest-path cost under the final times is within the gap of the total.
+    Graph congested=g; double spCost=0;
+    for(EdgeId e=0;e<g.edgeCount();e++){ congested.setWeight(e, (int)std::lround(r.time[e]*1000)); if(r.time[e] < g.edgeWeight(e)-1e-9){ std::cout<<"bpr failed\n"; return 1; } }
+    for(auto &d: demand) spCost += d.trips*dijkstra(congested, d.from, d.to).distance/1000.0;
+    if(spCost > r.totalTime*(1+1e-6) || spCost < r.totalTime*(1-2e-3)){ std::cout<<"wardrop failed "<<spCost<<" vs "<<r.totalTime<<"\n"; return 1; }
+
+    { std::ofstream out("test_od.txt"); out<<"# demand\n0 5 120.5\n3 x 10\n7 7 0\nbad\n143 0 3\n"; }
+    auto parsed=loadDemand(g, "test_od.txt"); std::remove("test_od.txt");
+    if(parsed.size()!=2 || parsed[0].to!=5 || parsed[0].trips!=120.5 || parsed[1].from!=143){ std::cout<<"demand parse failed\n"; return 1; }
+    std::cout<<"OK\n"; return 0;
+}
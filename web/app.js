@@ -3,6 +3,8 @@ let map, graphData = {}, routeLayer, nodeMarkers = {};
 let currentRoute = null, animationMarker = null, animationPath = null;
 let trafficInterval = null, history = [], alternativeRoutes = [], heatmapLayer = null;
 let routingControl = null; // For real road routing
+let deltaInterval = null; // Polls graph_delta.json from the C++ backend
+let serviceMode = false;  // Page served by `traffic.exe --serve`: route and simulate through its API
 
 function initMap() {
     map = L.map('map').setView([28.60, 77.20], 10);
@@ -18,10 +20,12 @@ async function loadData() {
         const graphResp = await fetch('graph.json');
         if (!graphResp.ok) throw new Error('Graph response not ok');
         const graph = await graphResp.json();
-        console.log('Graph loaded:', graph);
+        serviceMode = graphResp.headers.get('X-Routing-Service') !== null;
+        console.log('Graph loaded:', graph, serviceMode ? '(live service)' : '(exported file)');
         graphData = graph;
         buildSelects();
         drawGraph();
+        if (!deltaInterval) deltaInterval = setInterval(pollGraphDelta, 3000);
         
         console.log('Loading route history...');
         const histResp = await fetch('route.json');
@@ -35,6 +39,39 @@ async function loadData() {
     }
 }
 
+async function reloadGraph() {
+    const resp = await fetch('graph.json', { cache: 'no-store' });
+    if (!resp.ok) return;
+    graphData = await resp.json();
+    drawGraph();
+}
+
+// Apply the backend's latest weight patch if it starts from our version;
+// otherwise we missed one and fall back to a full reload.
+async function pollGraphDelta() {
+    try {
+        const resp = await fetch('graph_delta.json', { cache: 'no-store' });
+        if (!resp.ok) return;
+        const delta = await resp.json();
+        if (graphData.version === undefined || delta.version === graphData.version) return;
+        if (delta.base !== graphData.version) { await reloadGraph(); return; }
+        const byRoad = {};
+        graphData.edges.forEach(e => {
+            const key = e.from < e.to ? `${e.from}|${e.to}` : `${e.to}|${e.from}`;
+            (byRoad[key] = byRoad[key] || []).push(e);
+        });
+        delta.edges.forEach(d => {
+            const key = d.from < d.to ? `${d.from}|${d.to}` : `${d.to}|${d.from}`;
+            (byRoad[key] || []).forEach((e, i) => { if (i < d.weights.length) e.weight = d.weights[i]; });
+        });
+        graphData.version = delta.version;
+        console.log('Applied graph delta:', delta.edges.length, 'roads, version', delta.version);
+        drawGraph();
+    } catch (e) {
+        console.warn('Delta poll failed:', e);
+    }
+}
+
 function buildSelects() {
     const src = document.getElementById('source');
     const dest = document.getElementById('dest');
@@ -235,13 +272,28 @@ function updateStats() {
     updateTrafficAlerts();
 }
 
-function findAlternativeRoutes() {
+async function findAlternativeRoutes() {
     const src = document.getElementById('source').value;
     const dst = document.getElementById('dest').value;
     if (!src || !dst) { alert('Select source and destination'); return; }
     
     console.log('Finding alternative routes from', src, 'to', dst);
     
+    if (serviceMode) {
+        // The service returns the k shortest loopless routes, best first
+        const resp = await fetch(`route?from=${encodeURIComponent(src)}&to=${encodeURIComponent(dst)}&alternatives=3`, { cache: 'no-store' });
+        const r = resp.ok ? await resp.json() : {};
+        alternativeRoutes = (r.alternatives || []).map((alt, i) => ({
+            path: alt.path,
+            total: alt.distance,
+            name: `Route ${i + 1} (${alt.distance} min)`,
+            coords: alt.path.map(node => graphData.nodes[node].coords),
+            placeNames: alt.path.map(node => graphData.nodes[node].name)
+        }));
+        displayRouteComparison();
+        return;
+    }
+    
     // Find 3 different routes by temporarily removing edges
     alternativeRoutes = [];
     const originalEdges = [...graphData.edges];
@@ -307,7 +359,19 @@ function selectAlternativeRoute(index) {
     map.fitBounds(L.latLngBounds(route.coords));
 }
 
-function toggleTrafficHeatmap() {
+// Equilibrium flows from the assignment engine (assignment.json), if present.
+async function loadAssignment() {
+    try {
+        const resp = await fetch('assignment.json', { cache: 'no-store' });
+        if (!resp.ok) return null;
+        const a = await resp.json();
+        return a.edges ? a : null;
+    } catch (e) {
+        return null;
+    }
+}
+
+async function toggleTrafficHeatmap() {
     if (heatmapLayer) {
         map.removeLayer(heatmapLayer);
         heatmapLayer = null;
@@ -319,13 +383,18 @@ function toggleTrafficHeatmap() {
     console.log('Creating traffic heatmap...');
     document.getElementById('heatmapBtn').textContent = 'Hide Heatmap';
     
-    // Create heatmap based on edge weights
+    // Volume/capacity from the equilibrium assignment when available,
+    // otherwise plain edge weights
+    const assignment = await loadAssignment();
+    const edges = assignment ? assignment.edges : graphData.edges;
+    console.log(assignment ? `Heatmap from assignment (${assignment.iterations} iterations)` : 'Heatmap from edge weights');
     heatmapLayer = L.layerGroup();
     
-    graphData.edges.forEach(edge => {
+    edges.forEach(edge => {
+        if (!graphData.nodes[edge.from] || !graphData.nodes[edge.to]) return;
         const [lat1, lng1] = graphData.nodes[edge.from].coords;
         const [lat2, lng2] = graphData.nodes[edge.to].coords;
-        const intensity = edge.weight / 20; // Normalize to 0-1
+        const intensity = assignment ? Math.min(edge.ratio, 1.5) / 1.2 : edge.weight / 20; // Normalize to ~0-1
         
         // Add multiple points along the edge for better heatmap
         for (let i = 0; i <= 5; i++) {
@@ -461,6 +530,20 @@ function simulateTraffic() {
     console.log('Starting traffic simulation...');
     document.getElementById('simBtn').textContent = 'Stop Simulation';
     document.getElementById('simBtn').style.background = '#e74c3c';
+
+    if (serviceMode) {
+        // The backend simulates and publishes; we patch from the delta it returns.
+        trafficInterval = setInterval(async () => {
+            try {
+                const resp = await fetch('traffic?changes=4', { method: 'POST' });
+                if (resp.ok) await pollGraphDelta();
+                if (currentRoute) findRoute();
+            } catch (e) {
+                console.warn('Traffic step failed:', e);
+            }
+        }, 2000);
+        return;
+    }
     
     trafficInterval = setInterval(() => {
         console.log('Updating traffic...');
@@ -524,12 +607,19 @@ function dijkstraClient(src, dst) {
     return { path, total: dist[dst] };
 }
 
-function findRoute() {
+async function routeFromService(src, dst) {
+    const resp = await fetch(`route?from=${encodeURIComponent(src)}&to=${encodeURIComponent(dst)}`, { cache: 'no-store' });
+    if (!resp.ok) return null;
+    const r = await resp.json();
+    return r.path ? { path: r.path, total: r.distance } : null;
+}
+
+async function findRoute() {
     const src = document.getElementById('source').value;
     const dst = document.getElementById('dest').value;
     if (!src || !dst) { alert('Select source and destination'); return; }
     console.log('Finding route from', src, 'to', dst);
-    const result = dijkstraClient(src, dst);
+    const result = serviceMode ? await routeFromService(src, dst) : dijkstraClient(src, dst);
     console.log('Dijkstra result:', result);
     if (!result || result.total === Infinity) {
         document.getElementById('routeInfo').textContent = 'No path found.';